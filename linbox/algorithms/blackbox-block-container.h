@@ -36,6 +36,7 @@
 #include "linbox/algorithms/blackbox-block-container-base.h"
 #include "linbox/matrix/dense-matrix.h"
 #include "linbox/matrix/matrix-domain.h"
+#include "linbox/util/serialization.h"
 
 #define _BBC_TIMING
 
@@ -121,6 +122,33 @@ namespace LinBox
 		}
 #endif
 
+		/** Appends the projections and the current Krylov blocks to bytes,
+		 * so that the sequence can be resumed from its current term.
+		 */
+		uint64_t serialize(std::vector<uint8_t>& bytes) const
+		{
+			uint64_t n = LinBox::serialize(bytes, static_cast<int64_t>(this->casenumber));
+			n += LinBox::serialize(bytes, this->_blockU);
+			n += LinBox::serialize(bytes, this->_blockV);
+			n += LinBox::serialize(bytes, _blockW);
+			n += LinBox::serialize(bytes, this->_value);
+			return n;
+		}
+
+		/** Restores a state written by serialize(), over the same blackbox.
+		 */
+		uint64_t unserialize(const std::vector<uint8_t>& bytes, uint64_t offset = 0u)
+		{
+			int64_t c;
+			uint64_t n = LinBox::unserialize(c, bytes, offset);
+			this->casenumber = (long)c;
+			n += LinBox::unserialize(this->_blockU, bytes, offset + n);
+			n += LinBox::unserialize(this->_blockV, bytes, offset + n);
+			n += LinBox::unserialize(_blockW, bytes, offset + n);
+			n += LinBox::unserialize(this->_value, bytes, offset + n);
+			return n;
+		}
+
 	protected:
 		Block                        _blockW;
 		_MatrixDomain    _BMD;
@@ -33,7 +33,9 @@
 #include "linbox/randiter/archetype.h"
 #include "linbox/algorithms/blackbox-container-base.h"
 #include "linbox/util/timer.h"
+#include "linbox/util/counters.h"
 #include "linbox/solutions/constants.h"
+#include "linbox/util/serialization.h"
 
 namespace LinBox
 {
@@ -115,6 +117,33 @@ namespace LinBox
 		double dotTime   () const { return _dotTime; }
 #endif // INCLUDE_TIMING
 
+		/** Appends the projection and the current Krylov vectors to bytes,
+		 * so that the sequence can be resumed from its current term.
+		 */
+		uint64_t serialize(std::vector<uint8_t>& bytes) const
+		{
+			uint64_t n = LinBox::serialize(bytes, static_cast<int64_t>(this->casenumber));
+			n += LinBox::serialize(bytes, this->u);
+			n += LinBox::serialize(bytes, this->v);
+			n += LinBox::serialize(bytes, w);
+			n += LinBox::serialize(bytes, this->_value);
+			return n;
+		}
+
+		/** Restores a state written by serialize(), over the same blackbox.
+		 */
+		uint64_t unserialize(const std::vector<uint8_t>& bytes, uint64_t offset = 0u)
+		{
+			int64_t c;
+			uint64_t n = LinBox::unserialize(c, bytes, offset);
+			this->casenumber = (long)c;
+			n += LinBox::unserialize(this->u, bytes, offset + n);
+			n += LinBox::unserialize(this->v, bytes, offset + n);
+			n += LinBox::unserialize(w, bytes, offset + n);
+			n += LinBox::unserialize(this->_value, bytes, offset + n);
+			return n;
+		}
+
 	protected:
 		// std::vector<typename Field::Element> w;
 		BlasVector<Field> w ;
@@ -125,6 +154,7 @@ namespace LinBox
 #endif // INCLUDE_TIMING
 
 		void _launch () {
+			LINBOX_COUNT(KrylovSteps, 1);
 			if (this->casenumber) {
 #ifdef INCLUDE_TIMING
 				_timer.start ();
@@ -0,0 +1,391 @@
+/* linbox/algorithms/block-wiedemann-distributed.h
+ * Copyright (C) LinBox
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file algorithms/block-wiedemann-distributed.h
+ * @ingroup algorithms
+ * @brief Block Wiedemann solver with the sequence split over MPI ranks.
+ */
+
+#ifndef __LINBOX_block_wiedemann_distributed_H
+#define __LINBOX_block_wiedemann_distributed_H
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#include "linbox/matrix/dense-matrix.h"
+#include "linbox/algorithms/blackbox-block-container-base.h"
+#include "linbox/algorithms/block-massey-domain.h"
+#include "linbox/algorithms/block-wiedemann.h"
+#include "linbox/vector/vector-domain.h"
+#include "linbox/blackbox/transpose.h"
+#include "linbox/util/mpicpp.h"
+#include "linbox/util/commentator.h"
+#include "linbox/util/error.h"
+
+namespace LinBox
+{
+
+	/** \brief Block sequence U A^i V already computed, for BlockMasseyDomain.
+	 *
+	 * Offers the part of the BlackboxBlockContainer interface the
+	 * generator computations use, over a stored vector of blocks.
+	 */
+	template<class _Field, class _Blackbox>
+	class StoredBlockContainer {
+	public:
+		typedef _Field                 Field;
+		typedef _Blackbox              Blackbox;
+		typedef BlasMatrix<Field>      Block;
+		typedef BlasMatrix<Field>      Value;
+
+		StoredBlockContainer (const Blackbox *BB, const Field &F, std::vector<Block> &S) :
+			_field(&F), _BB(BB), _seq(S)
+		{
+			linbox_check(S.size() > 0);
+		}
+
+		class const_iterator {
+			typename std::vector<Block>::const_iterator _it;
+		public:
+			const_iterator () {}
+			const_iterator (typename std::vector<Block>::const_iterator it) : _it(it) {}
+			const_iterator &operator ++ () { ++_it; return *this; }
+			const Value &operator * () { return *_it; }
+		};
+
+		const_iterator begin () const  { return const_iterator(_seq.begin()); }
+		const_iterator end () const    { return const_iterator(_seq.end()); }
+		size_t size () const           { return _seq.size(); }
+		size_t rowdim () const         { return _seq[0].rowdim(); }
+		size_t coldim () const         { return _seq[0].coldim(); }
+		const Field &field () const    { return *_field; }
+		const Blackbox* getBB () const { return _BB; }
+
+	protected:
+		const Field          *_field;
+		const Blackbox       *_BB;
+		std::vector<Block>   &_seq;
+	};
+
+	/** \brief Block Wiedemann solver distributed over the ranks of a Communicator.
+	 *
+	 * Same algorithm as BlockWiedemannSolver, in three phases:
+	 * - every rank holds a copy of the matrix, receives the projection U
+	 *   and its own slice of the columns of V, and computes U A^i V for
+	 *   these columns only (the columns of V give independent sequences);
+	 * - the root gathers the sequence blocks and computes the matrix
+	 *   generator with BlockMasseyDomain;
+	 * - the rows of the generator combination are spread over the ranks
+	 *   again for the evaluation of the solution, then summed at the root.
+	 *
+	 * Every rank calls solveNonSingular with the same matrix; the
+	 * right-hand side and the random projections are taken from the
+	 * root, and every rank returns the solution.  With a null
+	 * communicator or a single process, everything runs locally.
+	 */
+	template <class Context_>
+	class DistributedBlockWiedemannSolver {
+	public:
+		typedef typename Context_::Field        Field;
+		typedef typename Field::Element         Element;
+		typedef typename Field::RandIter        RandIter;
+		typedef BlasVector<Field>               Vector;
+		typedef BlasMatrix<Field>               Block;
+
+	protected:
+		Context_                    _BMD;
+		VectorDomain<Field>         _VDF;
+		RandIter                    _rand;
+		Communicator               *_comm;
+		size_t                      _left_blockdim;
+		size_t                      _right_blockdim;
+
+		enum : uint64_t { Proceed = 0, Singular = 1, Solved = 2 };
+
+	public:
+		const Field & field() const { return _BMD.field(); }
+
+		DistributedBlockWiedemannSolver (const Context_ &C, Communicator *comm,
+						 size_t lblock=BW_BLOCK_DEFAULT, size_t rblock=BW_BLOCK_DEFAULT+1) :
+			_BMD(C.field()), _VDF(C.field()), _rand(const_cast<Field&>(C.field())),
+			_comm(comm), _left_blockdim(lblock), _right_blockdim(rblock)
+		{
+			if (_left_blockdim ==0) _left_blockdim=BW_BLOCK_DEFAULT;
+			if (_right_blockdim ==0) _right_blockdim=BW_BLOCK_DEFAULT;
+		}
+
+		template <class Blackbox>
+		Vector &solve (Vector &x, const Blackbox &B, const Vector &y) const
+		{
+			try {
+				solveNonSingular(x,B,y);
+			}
+			catch (LinboxError& e) {
+				std::cerr<<e<<std::endl;
+			}
+			return x;
+		}
+
+		template <class Blackbox>
+		Vector &solveNonSingular (Vector &x, const Blackbox &B, const Vector &y) const
+		{
+			Transpose<Blackbox> A(B);
+			const size_t m = A.rowdim();
+			const size_t n = A.coldim();
+			const size_t lb = _left_blockdim;
+			const size_t rb = _right_blockdim;
+			const size_t length = std::max(m/lb,size_t(1)) + std::max(n/rb,size_t(1)) + __BW_EXTRA_STEPS;
+
+			Vector rhs(y);
+			bcast(rhs);
+			Vector z(field(),rhs.size());
+			size_t bw_try=0;
+
+			uint64_t status = Proceed;
+			do {
+				// Projections, drawn at the root
+				Block U(field(),lb,m), UA(field(),lb-1,m), V(field(),n,rb);
+				if (isRoot()) {
+					for (size_t i=0;i<n;++i)
+						for (size_t j=0;j<rb;++j)
+							_rand.random(V.refEntry(i,j));
+					for (size_t i=0;i<lb-1;++i)
+						for (size_t j=0;j<m;++j)
+							_rand.random(UA.refEntry(i,j));
+					typename Block::RowIterator        iter_U  = U.rowBegin();
+					typename Block::ConstRowIterator   iter_UA = UA.rowBegin();
+					++iter_U;
+					for (; iter_UA != UA.rowEnd(); ++iter_UA, ++iter_U)
+						A.applyTranspose( *iter_U , *iter_UA );
+					for (size_t i=0;i<m;++i)
+						U.setEntry(0,i,rhs[i]);
+				}
+				bcast(U);
+				bcast(UA);
+
+				// Phase 1: sequence of the local columns of V
+				size_t c0, c1;
+				columnRange(c0, c1, rank());
+				Block Vloc(field(), n, c1-c0);
+				scatterColumns(Vloc, V);
+				Block Sloc(field(), length*lb, c1-c0);
+				if (c1 > c0)
+					localSequence(Sloc, A, U, Vloc, length);
+
+				// Phase 2: generator at the root
+				Block Comb(field(), lb, 1);
+				if (isRoot()) {
+					std::vector<Block> S(length, Block(field(),lb,rb));
+					gatherSequence(S, Sloc);
+					StoredBlockContainer<Field,Transpose<Blackbox> > Sequence(&A, field(), S);
+					BlockMasseyDomain<Field,StoredBlockContainer<Field,Transpose<Blackbox> > > MBD(&Sequence);
+					std::vector<Block> minpoly;
+					std::vector<size_t> degree;
+					MBD.left_minpoly_rec(minpoly,degree);
+
+					size_t idx=0;
+					while (idx<lb && field().isZero(minpoly[0].getEntry(idx,0)))
+						++idx;
+					if (idx == lb)
+						status = Singular;
+					else {
+						// row idx of the generator, coefficient k of entry i in Comb(i,k)
+						const size_t deg = degree[idx];
+						Comb = Block(field(), lb, deg+1);
+						for (size_t i=0;i<lb;++i)
+							for (size_t k=0;k<deg+1;++k)
+								Comb.setEntry(i,k,minpoly[k].getEntry(idx,i));
+					}
+				}
+				else
+					sendSequence(Sloc);
+				bcast(status);
+				if (status == Singular) {
+					std::cerr<<"BW: matrix is singular \n";
+					throw LinboxError(" block minpoly: matrix seems to be singular - abort");
+				}
+				bcast(Comb);
+
+				// Phase 3: rows of the combination spread over the ranks
+				const size_t deg = Comb.coldim()-1;
+				Vector accu(field(),n);
+				for (size_t k=rank(); k<lb; k+=nranks()) {
+					Vector row(field(),m), lhs(field(),n);
+					if (k==0)
+						row = rhs;
+					else
+						for (size_t j=0;j<m;++j)
+							row[j]=UA.getEntry(k-1,j);
+					std::vector<Element> combi(deg+1);
+					for (size_t i=0;i<=deg;++i)
+						combi[i] = Comb.getEntry(k,i);
+					combine(lhs, A, row, combi, deg, (k==0) ? 1 : 0);
+					_VDF.addin(accu,lhs);
+				}
+				sumToRoot(accu);
+
+				if (isRoot()) {
+					Element scaling;
+					field().init(scaling);
+					field().neg(scaling,Comb.getEntry(0,0));
+					field().invin(scaling);
+					_VDF.mul(x,accu,scaling);
+
+					B.apply(z,x); // checking result
+					status = _VDF.areEqual(z,rhs) ? Solved : Proceed;
+				}
+				bcast(status);
+				if ( (status != Solved) && (bw_try > BW_MAX_TRY) )
+					throw LinboxError("BlockWiedemann solve: LasVegas maximum tries reached");
+				bw_try++;
+			} while (status != Solved);
+
+			bcast(x);
+			commentator().report()<<"DistributedBlockWiedemannSolver: nbr of tries: "<<bw_try<<std::endl;
+			return x;
+		}
+
+	protected:
+		int rank () const { return _comm ? _comm->rank() : 0; }
+		size_t nranks () const { return _comm ? (size_t)_comm->size() : 1; }
+		bool isRoot () const { return rank() == 0; }
+
+		template<class T>
+		void bcast (T& value) const
+		{
+			if (nranks() > 1) _comm->bcast(value, 0);
+		}
+
+		/// Columns [c0,c1) of V owned by rank r
+		void columnRange (size_t& c0, size_t& c1, size_t r) const
+		{
+			c0 = (_right_blockdim*r)/nranks();
+			c1 = (_right_blockdim*(r+1))/nranks();
+		}
+
+		void scatterColumns (Block& Vloc, const Block& V) const
+		{
+			size_t c0, c1;
+			if (! isRoot()) {
+				columnRange(c0, c1, rank());
+				if (c1 > c0) _comm->recv(Vloc, 0);
+				return;
+			}
+			for (size_t r=nranks(); r-- > 0; ) {
+				columnRange(c0, c1, r);
+				if (c1 == c0) continue;
+				Block Vr(field(), V.rowdim(), c1-c0);
+				for (size_t i=0;i<V.rowdim();++i)
+					for (size_t j=c0;j<c1;++j)
+						Vr.setEntry(i,j-c0,V.getEntry(i,j));
+				if (r == 0)
+					Vloc = Vr;
+				else
+					_comm->send(Vr, (int)r);
+			}
+		}
+
+		/// Blocks U A^i Vloc, i < length, stacked in S
+		template<class BB>
+		void localSequence (Block& S, const BB& A, const Block& U, const Block& Vloc, size_t length) const
+		{
+			const size_t lb = U.rowdim();
+			Block W(Vloc), AW(field(), Vloc.rowdim(), Vloc.coldim()), T(field(), lb, Vloc.coldim());
+			Block *cur = &W, *next = &AW;
+			for (size_t i=0;i<length;++i) {
+				_BMD.mul(T, U, *cur);
+				for (size_t a=0;a<lb;++a)
+					for (size_t b=0;b<T.coldim();++b)
+						S.setEntry(i*lb+a,b,T.getEntry(a,b));
+				if (i+1 < length) {
+					MulHelper<Field,Block>::mul(*next, A, *cur);
+					std::swap(cur, next);
+				}
+			}
+		}
+
+		void sendSequence (const Block& Sloc) const
+		{
+			if (Sloc.coldim() > 0) _comm->send(Sloc, 0);
+		}
+
+		void gatherSequence (std::vector<Block>& S, const Block& Sloc) const
+		{
+			const size_t lb = _left_blockdim;
+			for (size_t r=0; r<nranks(); ++r) {
+				size_t c0, c1;
+				columnRange(c0, c1, r);
+				if (c1 == c0) continue;
+				Block Sr(field(), S.size()*lb, c1-c0);
+				if (r == 0)
+					Sr = Sloc;
+				else
+					_comm->recv(Sr, (int)r);
+				for (size_t i=0;i<S.size();++i)
+					for (size_t a=0;a<lb;++a)
+						for (size_t j=c0;j<c1;++j)
+							S[i].setEntry(a,j,Sr.getEntry(i*lb+a,j-c0));
+			}
+		}
+
+		void sumToRoot (Vector& accu) const
+		{
+			const size_t active = std::min(nranks(), _left_blockdim);
+			if (! isRoot()) {
+				if ((size_t)rank() < active) _comm->send(accu, 0);
+				return;
+			}
+			for (size_t r=1; r<active; ++r) {
+				Vector part(field(), accu.size());
+				_comm->recv(part, (int)r);
+				_VDF.addin(accu, part);
+			}
+		}
+
+		/// Horner evaluation of one row of the generator, as in BlockWiedemannSolver
+		template<class BB>
+		void combine (Vector& lhs, const BB& A, const Vector& row,
+			      const std::vector<Element>& combi, size_t deg, int last) const
+		{
+			A.applyTranspose(lhs,row);
+			_VDF.mulin(lhs,combi[deg]);
+			Vector lhsbis(lhs);
+			for (int i = (int)deg-1 ; i >= last;--i) {
+				_VDF.axpy (lhs, combi[(size_t)i], row, lhsbis);
+				A.applyTranspose (lhsbis, lhs);
+			}
+		}
+
+	}; // end of class DistributedBlockWiedemannSolver
+
+} // end of namespace LinBox
+
+#endif //__LINBOX_block_wiedemann_distributed_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
@@ -28,13 +28,13 @@
 #include <numeric>
 #include <algorithm>
 #include <iostream>
-#include <givaro/givpoly1crt.h>
 
 
 #include "linbox/integer.h"
 #include "linbox/util/commentator.h"
 #include "linbox/algorithms/blackbox-block-container.h"
 #include "linbox/algorithms/block-coppersmith-domain.h"
+#include "linbox/algorithms/poly-eval-interp.h"
 #include "linbox/solutions/det.h"
 
 #include "linbox/util/error.h"
@@ -216,29 +216,6 @@ namespace LinBox
 		Random		iter;
 		size_t		blocking;
 
-		//Compute the determinant of a polynomial matrix at the given set of evaluation points
-		//Store the results in the vector dets.
-		void EvalPolyMat(std::vector<Element> &dets, std::vector<Element> &values, std::vector<Block> & mat) const {
-
-			size_t deg = mat.size() -1;
-			size_t numv = values.size();
-			//Compute the determinant of the evaluation at values[i] for each i
-			for(size_t i = 0; i<numv; i++){
-				//copy the highest matrix coefficient
-				Block evalmat(field(), mat[0].rowdim(), mat[0].coldim());
-				domain().copy(evalmat,mat[deg]);
-				//Evaluate using a horner style evaluation
-				typename std::vector<Block>::reverse_iterator addit =  mat.rbegin();
-				addit++;
-				for(addit; addit != mat.rend(); addit++){
-					domain().mulin(evalmat,values[i]);
-					domain().addin(evalmat,*addit);
-				}//end loop computing horner evaluation
-				//Compute the determinant of the evaluation and store it in dets[i]
-				dets[i] = det(dets[i],evalmat);
-			}//end loop over evaluation points
-		}//end evaluation of polynominal matrix determinant
-
 	public:
 		CoppersmithRank(const Domain &MD, size_t blocking_ = 0) :
 			 _MD(&MD), blocking(blocking_), iter(MD.field())
@@ -292,30 +269,15 @@ namespace LinBox
 			size_t detdeg= 0;
 			for(size_t i = 0; i < gen[0].coldim(); i++)
 				detdeg+=deg[i];
-			//Set up interpolation with one more evaluation point than degree
-			size_t numpoints = d+1;
-			std::vector<Element> evalpoints(numpoints), evaldets(numpoints);
-			for(typename std::vector<Element>::iterator evalit = evalpoints.begin(); evalit != evalpoints.end(); evalit++){
-				do{
-					//do iter.random(*evalit); while(field().isZero(*evalit));
-					iter.random(*evalit);
-				}while ((std::find(evalpoints.begin(), evalit, *evalit) != evalit));
-			}//end evaluation point construction loop
-
-			//Evaluate the generator determinant at the points
-			EvalPolyMat(evaldets, evalpoints, gen);
-			for(size_t k = 0; k <numpoints; k++)
-				report << evalpoints[k] << "  " << evaldets[k] << std::endl;
-			//Construct the polynomial using Givare interpolation
-			//Stolen from Pascal Giorgi, linbox/examples/omp-block-rank.C
-			typedef Givaro::Poly1CRT< Field >  PolyCRT;
-			PolyCRT Interpolator(field(), evalpoints, "x");
-			typename PolyCRT::Element Determinant;
-			Interpolator.RnsToRing(Determinant,evaldets);
+			//Evaluate the generator at d+1 points (FFT ones if the field has them),
+			//take the determinants in parallel and interpolate
+			PolyMatrixEvalInterp<Field> Interpolator(field());
+			typename PolyMatrixEvalInterp<Field>::Polynomial Determinant;
+			Interpolator.det(Determinant, gen, d);
 			Givaro::Degree intdetdeg;
-			Interpolator.getpolydom().degree(intdetdeg,Determinant);
+			Interpolator.polynomialDomain().degree(intdetdeg,Determinant);
 			Givaro::Degree intdetval;
-			Interpolator.getpolydom().val(intdetval,Determinant);
+			Interpolator.polynomialDomain().val(intdetval,Determinant);
 			if(detdeg != (size_t) intdetdeg.value()){
 				report << "sum of column degrees " << detdeg << std::endl;
 				report << "interpolation degree " << intdetdeg.value() << std::endl;
@@ -325,7 +287,7 @@ namespace LinBox
 			report << "valence (trailing degree) " << intdetval.value() << std::endl;
 			for(size_t k = 0; k<gen.size(); k++)
 				domain().write(report, gen[k]) << "x^" << k << std::endl;
-			Interpolator.write(report << "Interpolated determinant: ", Determinant) << std::endl;
+			Interpolator.polynomialDomain().write(report << "Interpolated determinant: ", Determinant) << std::endl;
 			size_t myrank = size_t(intdetdeg.value() - intdetval.value());
 			commentator().stop ("done", NULL, "Coppersmith rank");
 			return myrank;
@@ -355,28 +317,6 @@ namespace LinBox
 		Random		iter;
 		size_t		blocking;
 
-		//Compute the determinant of a polynomial matrix at the given set of evaluation points
-		//Store the results in the vector dets.
-		void EvalPolyMat(std::vector<Element> &dets, std::vector<Element> &values, std::vector<Block> & mat) const {
-
-			size_t deg = mat.size() -1;
-			size_t numv = values.size();
-			//Compute the determinant of the evaluation at values[i] for each i
-			for(size_t i = 0; i<numv; i++){
-				//copy the highest matrix coefficient
-				Block evalmat(mat[deg]);
-				//Evaluate using a horner style evaluation
-				typename std::vector<Block>::reverse_iterator addit =  mat.rbegin();
-				addit++;
-				for(addit; addit != mat.rend(); addit++){
-					domain().mulin(evalmat,values[i]);
-					domain().addin(evalmat,*addit);
-				}//end loop computing horner evaluation
-				//Compute the determinant of the evaluation and store it in dets[i]
-				dets[i] = det(dets[i],evalmat);
-			}//end loop over evaluation points
-		}//end evaluation of polynominal matrix determinant
-
 	public:
 		CoppersmithDeterminant(const Domain &MD, size_t blocking_ = 0) :
 			 _MD(&MD), blocking(blocking_), iter(MD.field())
@@ -431,34 +371,22 @@ namespace LinBox
 			size_t detdeg= 0;
 			for(size_t i = 0; i < gen[0].coldim(); i++)
 				detdeg+=deg[i];
-			//Set up interpolation with one more evaluation point than degree
-			size_t numpoints = 2*d;
-			std::vector<Element> evalpoints(numpoints), evaldets(numpoints);
-			for(typename std::vector<Element>::iterator evalit = evalpoints.begin(); evalit != evalpoints.end(); evalit++){
-				do{
-					do iter.random(*evalit); while(field().isZero(*evalit));
-				}while ((std::find(evalpoints.begin(), evalit, *evalit) != evalit));
-			}//end evaluation point construction loop
-
-			//Evaluate the generator determinant at the points
-			EvalPolyMat(evaldets, evalpoints, gen);
-			//Construct the polynomial using Givare interpolation
-			//Stolen from Pascal Giorgi, linbox/examples/omp-block-rank.C
-			typedef Givaro::Poly1CRT<Field>  PolyCRT;
-			PolyCRT Interpolator(field(), evalpoints, "x");
-			typename PolyCRT::Element Determinant;
-			Interpolator.RnsToRing(Determinant,evaldets);
+			//Evaluate the generator at 2d points (FFT ones if the field has them),
+			//take the determinants in parallel and interpolate
+			PolyMatrixEvalInterp<Field> Interpolator(field());
+			typename PolyMatrixEvalInterp<Field>::Polynomial Determinant;
+			Interpolator.det(Determinant, gen, 2*d-1);
 			Givaro::Degree intdetdeg;
-			Interpolator.getpolydom().degree(intdetdeg,Determinant);
+			Interpolator.polynomialDomain().degree(intdetdeg,Determinant);
 			Givaro::Degree intdetval(0);
-			Interpolator.getpolydom().val(intdetval,Determinant);
+			Interpolator.polynomialDomain().val(intdetval,Determinant);
 			if(d != (size_t)intdetdeg.value()){
 				report << "The matrix is singular, determinant is zero" << std::endl;
 				return field(0).zero;
 			}
-			Interpolator.write(report << "Interpolated determinant: ", Determinant) << std::endl;
+			Interpolator.polynomialDomain().write(report << "Interpolated determinant: ", Determinant) << std::endl;
 			Element intdeterminant(field().zero);
-			Interpolator.getpolydom().getEntry(intdeterminant,intdetval,Determinant);
+			Interpolator.polynomialDomain().getEntry(intdeterminant,intdetval,Determinant);
 			commentator().stop ("done", NULL, "Coppersmith determinant");
 			return intdeterminant;
 		}
@@ -0,0 +1,128 @@
+/* linbox/algorithms/cra-batch-schedule.h
+ * Copyright (C) LinBox
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file algorithms/cra-batch-schedule.h
+ * @brief Number of primes of each round of the \ref CRA loops.
+ * @ingroup CRA
+ *
+ * Small rounds while the early termination may trigger, large rounds
+ * once the bound on the result says how many primes are still needed.
+ */
+
+#ifndef __LINBOX_cra_batch_schedule_H
+#define __LINBOX_cra_batch_schedule_H
+
+#include "linbox/integer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace LinBox
+{
+
+	/** \brief Sizes the rounds of primes of the CRA loops.
+	 *
+	 * With a bound on the absolute value of the result (logBound, in bits),
+	 * the loops also stop as soon as the modulus exceeds twice the bound:
+	 * the reconstruction is then exact whatever the early termination says.
+	 */
+	struct PrimeBatchSchedule {
+		double logBound = 0.;      //!< log2 of a bound on the result, 0 when unknown
+		size_t maxBatchFactor = 4; //!< at most this many primes per thread in a round
+
+		/// Whether the modulus, of log2 logModulus, covers the bound
+		bool boundReached (double logModulus) const
+		{
+			return logBound > 0. && logModulus > logBound + 1.;
+		}
+
+		/// Primes still needed to cover the bound, 0 when unknown
+		size_t gap (double logModulus, size_t primes) const
+		{
+			if (logBound <= 0. || primes == 0 || logModulus <= 0.) return 0;
+			if (boundReached(logModulus)) return 0;
+			const double primeBits = logModulus / (double)primes;
+			return (size_t)std::ceil((logBound + 1. - logModulus) / primeBits);
+		}
+
+		/** \brief Primes of the next round.
+		 *
+		 * @param threads     primes of a round without information
+		 * @param logModulus  log2 of the current modulus
+		 * @param primes      good primes in the current modulus
+		 * @param agreements  consecutive residues that did not change the result
+		 * @param threshold   agreements needed by the early termination, 0 if none
+		 */
+		size_t next (size_t threads, double logModulus, size_t primes, size_t agreements, size_t threshold) const
+		{
+			threads = std::max<size_t>(threads, 1);
+			auto rounded = [threads](size_t b) { return std::max<size_t>((b + threads - 1) / threads, 1) * threads; };
+			const size_t remaining = gap(logModulus, primes);
+
+			// The result stabilises: just enough primes to confirm it.
+			if (threshold > agreements && agreements > 0) {
+				size_t needed = threshold - agreements;
+				if (remaining) needed = std::min(needed, remaining);
+				return rounded(needed);
+			}
+			// Still moving, but the bound says how far it can go.
+			if (remaining) return std::min(rounded(remaining), maxBatchFactor * threads);
+			return threads;
+		}
+	};
+
+	namespace Protected {
+		// log2 of the modulus of builders providing getModulus, 0 for the others
+		template <class Builder>
+		auto craLogModulus (Builder& B, int) -> decltype(B.getModulus(std::declval<Integer&>()), double())
+		{
+			Integer m;
+			B.getModulus(m);
+			return (m > 1) ? (double)Givaro::logtwo(m) : 0.;
+		}
+
+		template <class Builder>
+		double craLogModulus (Builder&, long) { return 0.; }
+
+		// (agreements, threshold) of the early terminated builders, (0, 0) for the others
+		template <class Builder>
+		auto craAgreements (const Builder& B, int) -> decltype(B.agreements(), std::pair<size_t, size_t>())
+		{
+			return std::pair<size_t, size_t>(B.agreements(), B.EARLY_TERM_THRESHOLD);
+		}
+
+		template <class Builder>
+		std::pair<size_t, size_t> craAgreements (const Builder&, long) { return std::pair<size_t, size_t>(0, 0); }
+	}
+
+}
+
+#endif // __LINBOX_cra_batch_schedule_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
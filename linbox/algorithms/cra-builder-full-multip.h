@@ -38,6 +38,8 @@
 #include <utility>
 
 #include "linbox/algorithms/lazy-product.h"
+#include "linbox/util/serialization.h"
+#include "linbox/util/error.h"
 
 namespace LinBox
 {
@@ -259,6 +261,61 @@ namespace LinBox
         size_t getDimension() const
         { return dimension_; }
 
+        /** @brief Appends the state of the builder to bytes, for checkpointing.
+         * @returns the number of bytes written
+         */
+        uint64_t serialize(std::vector<uint8_t>& bytes) const
+        {
+            uint64_t n = LinBox::serialize(bytes, LOGARITHMIC_UPPER_BOUND);
+            n += LinBox::serialize(bytes, totalsize_);
+            n += LinBox::serialize(bytes, static_cast<uint64_t>(dimension_));
+            n += LinBox::serialize(bytes, static_cast<uint8_t>(collapsed_));
+            n += LinBox::serialize(bytes, static_cast<uint8_t>(normalized_));
+            n += LinBox::serialize(bytes, static_cast<uint64_t>(shelves_.size()));
+            for (auto& shelf : shelves_) {
+                n += LinBox::serialize(bytes, static_cast<uint8_t>(shelf.occupied));
+                n += LinBox::serialize(bytes, shelf.residue);
+                n += LinBox::serialize(bytes, shelf.mod);
+                n += LinBox::serialize(bytes, shelf.logmod);
+                n += LinBox::serialize(bytes, static_cast<int32_t>(shelf.count));
+            }
+            return n;
+        }
+
+        /** @brief Restores a state written by serialize().
+         * The builder must have been created with the same bound.
+         * @returns the number of bytes read
+         */
+        uint64_t unserialize(const std::vector<uint8_t>& bytes, uint64_t offset = 0u)
+        {
+            double bound;
+            uint64_t dim, nshelves;
+            uint8_t flag;
+            int32_t count;
+            uint64_t n = LinBox::unserialize(bound, bytes, offset);
+            if (bound != LOGARITHMIC_UPPER_BOUND)
+                throw LinboxError("LinBox ERROR: CRA checkpoint made with another bound\n");
+            n += LinBox::unserialize(totalsize_, bytes, offset + n);
+            n += LinBox::unserialize(dim, bytes, offset + n);
+            dimension_ = dim;
+            n += LinBox::unserialize(flag, bytes, offset + n);
+            collapsed_ = flag;
+            n += LinBox::unserialize(flag, bytes, offset + n);
+            normalized_ = flag;
+            n += LinBox::unserialize(nshelves, bytes, offset + n);
+            shelves_.assign(nshelves, Shelf(dimension_));
+            for (auto& shelf : shelves_) {
+                n += LinBox::unserialize(flag, bytes, offset + n);
+                shelf.occupied = flag;
+                n += LinBox::unserialize(shelf.residue, bytes, offset + n);
+                n += LinBox::unserialize(shelf.mod, bytes, offset + n);
+                n += LinBox::unserialize(shelf.logmod, bytes, offset + n);
+                n += LinBox::unserialize(count, bytes, offset + n);
+                shelf.count = count;
+            }
+            return n;
+        }
+
         // XXX iterator invalidated by many other method calls
         decltype(shelves_.crbegin()) shelves_begin() const {
             return shelves_.rbegin();
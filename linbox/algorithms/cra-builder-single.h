@@ -305,6 +305,37 @@ namespace LinBox
 			return ( (gcd(g, i, nextM_) != 1) || (gcd(g, i, primeProd_) != 1) );
 		}
 
+	protected:
+		// residue, moduli and iteration counter, for the checkpoints of the subclasses;
+		// the counter slot is written in every build, so that the format does not depend on __LB_CRA_TIMING__
+		uint64_t serializeBase(std::vector<uint8_t>& bytes) const
+		{
+			uint64_t n = LinBox::serialize(bytes, primeProd_);
+			n += LinBox::serialize(bytes, nextM_);
+			n += LinBox::serialize(bytes, residue_);
+#ifdef __LB_CRA_TIMING__
+			n += LinBox::serialize(bytes, static_cast<uint64_t>(IterCounter_));
+#else
+			n += LinBox::serialize(bytes, static_cast<uint64_t>(0));
+#endif
+			return n;
+		}
+
+		uint64_t unserializeBase(const std::vector<uint8_t>& bytes, uint64_t offset)
+		{
+			uint64_t n = LinBox::unserialize(primeProd_, bytes, offset);
+			n += LinBox::unserialize(nextM_, bytes, offset + n);
+			n += LinBox::unserialize(residue_, bytes, offset + n);
+			uint64_t iterations;
+			n += LinBox::unserialize(iterations, bytes, offset + n);
+#ifdef __LB_CRA_TIMING__
+			IterCounter_ = (size_t)iterations;
+#endif
+			return n;
+		}
+
+	public:
+
 		/** @brief Returns a lower bound on the number of bits in the modulus.
 		 */
 		decltype(Integer().bitsize()) modbits() const
@@ -454,6 +485,38 @@ namespace LinBox
 		{
 			return occurency_ > EARLY_TERM_THRESHOLD;
 		}
+
+		/** @brief Consecutive residues that left the result unchanged.
+		 *
+		 * The loop terminates when this reaches EARLY_TERM_THRESHOLD.
+		 */
+		size_t agreements() const
+		{
+			return occurency_ ? occurency_ - 1 : 0;
+		}
+
+		/** @brief Appends the residue, moduli and early termination
+		 * counter to bytes, for checkpointing.
+		 * @returns the number of bytes written
+		 */
+		uint64_t serialize(std::vector<uint8_t>& bytes) const
+		{
+			uint64_t n = Base::serializeBase(bytes);
+			n += LinBox::serialize(bytes, static_cast<uint32_t>(occurency_));
+			return n;
+		}
+
+		/** @brief Restores a state written by serialize().
+		 * @returns the number of bytes read
+		 */
+		uint64_t unserialize(const std::vector<uint8_t>& bytes, uint64_t offset = 0u)
+		{
+			uint32_t occ;
+			uint64_t n = Base::unserializeBase(bytes, offset);
+			n += LinBox::unserialize(occ, bytes, offset + n);
+			occurency_ = occ;
+			return n;
+		}
 	};
 
 
@@ -26,7 +26,8 @@
  * @brief Parallel (PALADIN) version of \ref CRA
  * @brief Naive parallel chinese remaindering
  * @brief Launch by blocks of NN iterations
- * @brief in parallel, by default, NN is numver of available threads
+ * @brief in parallel, by default, NN is numver of available threads,
+ * @brief resized each round by the PrimeBatchSchedule
  * @brief Then synchronization and termintation test.
  * @ingroup CRA
  */
@@ -90,6 +91,19 @@ namespace LinBox
             return res;
         }
 
+        /** \brief The parallel loop, with checkpoints between rounds.
+         *
+         * Same checkpoint contents as ChineseRemainderSequential: the
+         * primes of a round being all incorporated before the next
+         * save, no residue of a running task is lost or counted twice.
+         */
+		template <class ResultType, class Function, class PrimeIterator>
+		ResultType& operator() (ResultType& res, Function& Iteration, PrimeIterator& primeiter, Checkpoint& checkpoint)
+		{
+            Father_t::checkpointLoop(*this, res, Iteration, primeiter, checkpoint);
+            return res;
+        }
+
 		template <class ResultType, class Function, class PrimeIterator>
 		bool operator() (int k, ResultType& res, Function& Iteration, PrimeIterator& primeiter, size_t NN = NUM_THREADS)
         {
@@ -97,16 +111,25 @@ namespace LinBox
 			using ResidueType = typename CRAResidue<ResultType,Function>::template ResidueType<Domain>;
 			if (NN == 1) return Father_t::operator()(k, res,Iteration,primeiter);
 
-			std::vector<Domain> ROUNDdomains; ROUNDdomains.reserve(NN);
-			std::vector<ResidueType> ROUNDresidues; ROUNDresidues.reserve(NN);
-			std::vector<IterationResult> ROUNDresults(NN);
+			const size_t threads = NN;
+			std::vector<Domain> ROUNDdomains;
+			std::vector<ResidueType> ROUNDresidues;
+			std::vector<IterationResult> ROUNDresults;
 			std::set<Integer> coprimeset;
 
-			while (k != 0 && ! this->Builder_.terminated()) {
+			while (k != 0 && ! this->Builder_.terminated() && ! this->boundReached()) {
+				// Round size from the early termination state and the bound
+				const std::pair<size_t, size_t> agreed = Protected::craAgreements(this->Builder_, 0);
+				NN = (this->ngood_ == 0) ? threads
+					: this->schedule_.next(threads, Protected::craLogModulus(this->Builder_, 0),
+							       (size_t)this->ngood_, agreed.first, agreed.second);
                 if ( (k>0) && (size_t(k)<NN) ) NN = k;
                 k -= NN;
 				ROUNDdomains.clear();
 				ROUNDresidues.clear();
+				ROUNDdomains.reserve(NN);
+				ROUNDresidues.reserve(NN);
+				ROUNDresults.assign(NN, IterationResult::CONTINUE);
 				coprimeset.clear();
 
 				while (coprimeset.size() < NN) {
@@ -135,6 +158,7 @@ namespace LinBox
 #endif
 
                     ROUNDresults[i] = Iteration(ROUNDresidues[i], ROUNDdomains[i]);
+                    LINBOX_COUNT(CRAPrimes, 1);
 
                 })}
                 }
@@ -147,6 +171,8 @@ namespace LinBox
 					if (res == IterationResult::RESTART) anyrestart = true;
 				}
 				if (anyrestart) {
+					LINBOX_COUNT(CRARestarts, 1);
+					LINBOX_COUNT(CRABadPrimes, this->ngood_);
 					this->nbad_ += this->ngood_;
 					this->ngood_ = 0;
 				}
@@ -157,6 +183,7 @@ namespace LinBox
 					}
 					else if (anyrestart && ROUNDresults[i] == IterationResult::SKIP) {
 						// commentator should indicate that this prime is bad
+						LINBOX_COUNT(CRABadPrimes, 1);
 						++this->nbad_;
 					}
 					else if (this->ngood_ == 0) {
@@ -178,7 +205,7 @@ namespace LinBox
 			}
 
 			this->Builder_.result(res);
-			return this->Builder_.terminated();
+			return this->Builder_.terminated() || this->boundReached();
 		}
 	};
 }
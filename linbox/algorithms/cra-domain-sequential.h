@@ -38,6 +38,9 @@
 #include <stdlib.h>
 #include "linbox/util/commentator.h"
 #include "linbox/util/commentator.h"
+#include "linbox/util/checkpoint.h"
+#include "linbox/util/counters.h"
+#include "linbox/algorithms/cra-batch-schedule.h"
 
 namespace LinBox
 {
@@ -58,6 +61,15 @@ namespace LinBox
 		int ngood_ = 0;
 		int nbad_ = 0;
 		int nskip_ = 0;
+		PrimeBatchSchedule schedule_;
+
+		/** \brief Whether the modulus covers the bound of the schedule, if any.
+		 */
+		bool boundReached()
+		{
+			return schedule_.logBound > 0. && ngood_ > 0
+				&& schedule_.boundReached(Protected::craLogModulus(Builder_, 0));
+		}
 
 		/** \brief Helper class to sample unique primes.
 		*/
@@ -91,6 +103,7 @@ namespace LinBox
 		 */
 		void doskip() {
 			commentator().report(Commentator::LEVEL_IMPORTANT,INTERNAL_WARNING) << "bad prime, skipping\n";
+			LINBOX_COUNT(CRABadPrimes, 1);
 			++nbad_;
 			if (++nskip_ > MAXSKIP) {
 				commentator().report(Commentator::LEVEL_ALWAYS,INTERNAL_ERROR) << "you are running out of GOOD primes. " << ngood_ << " good primes and " << nbad_ << " bad primes with " << nskip_ << " skipped in a row.\n";
@@ -121,6 +134,15 @@ namespace LinBox
 			return ngood_ + nbad_;
 		}
 
+		/** \brief Sizes of the rounds, and bound on the result if known.
+		 *
+		 * Setting schedule().logBound stops the loop once the modulus
+		 * exceeds twice the bound, before the early termination if need be.
+		 */
+		PrimeBatchSchedule& schedule() {
+			return schedule_;
+		}
+
             /** \brief The \ref CRA loop
              *
              * Given a function to generate residues \c mod a single prime,
@@ -183,6 +205,7 @@ namespace LinBox
 #ifdef __LB_CRA_TIMING__
                     Timer chrono; chrono.start();
 #endif
+					LINBOX_COUNT(CRAPrimes, 1);
 					if (Iteration(r,D) == IterationResult::SKIP) {
 						doskip();
 					}
@@ -196,13 +219,14 @@ namespace LinBox
 #endif
 				}
 
-				while (k != 0 && ! Builder_.terminated()) {
+				while (k != 0 && ! Builder_.terminated() && ! boundReached()) {
 					--k;
 					Domain D(get_coprime(primeiter));
                     commentator().report(Commentator::LEVEL_IMPORTANT, INTERNAL_DESCRIPTION) << "With prime " << *primeiter << std::endl;
 					++primeiter;
 					auto r = CRAResidue<ResultType,Function>::create(D);
 
+					LINBOX_COUNT(CRAPrimes, 1);
 					switch (Iteration(r, D)) {
 					case IterationResult::CONTINUE:
 						++ngood_;
@@ -213,6 +237,8 @@ namespace LinBox
 						break;
 					case IterationResult::RESTART:
 						commentator().report(Commentator::LEVEL_IMPORTANT,INTERNAL_WARNING) << "previous primes were bad; restarting\n";
+						LINBOX_COUNT(CRARestarts, 1);
+						LINBOX_COUNT(CRABadPrimes, ngood_);
 						nbad_ += ngood_;
 						ngood_ = 1;
 						Builder_.initialize(D, r);
@@ -221,9 +247,73 @@ namespace LinBox
 				}
 
                 Builder_.result(res);
-				return ngood_ > 0 && Builder_.terminated();
+				return ngood_ > 0 && (Builder_.terminated() || boundReached());
+            }
+
+            /** \brief The \ref CRA loop, with checkpoints.
+             *
+             * Same as above, but the loop and prime iterator states are
+             * saved to \p checkpoint whenever it is due, and restored from
+             * it when a previous run left one.  The checkpoint file is
+             * removed on termination.
+             */
+		template<class ResultType, class Function, class PrimeIterator>
+		ResultType& operator() (ResultType& res, Function& Iteration, PrimeIterator& primeiter, Checkpoint& checkpoint)
+            {
+                commentator().start ("Givaro::Modular iteration", "mmcravit");
+				checkpointLoop(*this, res, Iteration, primeiter, checkpoint);
+                commentator().stop ("done", NULL, "mmcravit");
+				return res;
             }
 
+		/** \brief Appends the iteration counters, the schedule and the builder state to bytes.
+		 */
+		uint64_t serialize(std::vector<uint8_t>& bytes) const
+            {
+                uint64_t n = LinBox::serialize(bytes, static_cast<int32_t>(ngood_));
+                n += LinBox::serialize(bytes, static_cast<int32_t>(nbad_));
+                n += LinBox::serialize(bytes, static_cast<int32_t>(nskip_));
+                n += LinBox::serialize(bytes, schedule_.logBound);
+                n += LinBox::serialize(bytes, static_cast<uint64_t>(schedule_.maxBatchFactor));
+                n += LinBox::serialize(bytes, Builder_);
+                return n;
+            }
+
+		/** \brief Restores a state written by serialize().
+		 */
+		uint64_t unserialize(const std::vector<uint8_t>& bytes, uint64_t offset = 0u)
+            {
+                int32_t good, bad, skip;
+                uint64_t factor;
+                uint64_t n = LinBox::unserialize(good, bytes, offset);
+                n += LinBox::unserialize(bad, bytes, offset + n);
+                n += LinBox::unserialize(skip, bytes, offset + n);
+                n += LinBox::unserialize(schedule_.logBound, bytes, offset + n);
+                n += LinBox::unserialize(factor, bytes, offset + n);
+                n += LinBox::unserialize(Builder_, bytes, offset + n);
+                ngood_ = good; nbad_ = bad; nskip_ = skip;
+                schedule_.maxBatchFactor = (size_t)factor;
+                return n;
+            }
+
+	protected:
+		/** \brief Runs cra by rounds of checkpoint.stride() primes, saving between rounds when due.
+		 *
+		 * Shared with the parallel CRA, whose rounds are its own operator().
+		 */
+		template<class CRA, class ResultType, class Function, class PrimeIterator>
+		static void checkpointLoop (CRA& cra, ResultType& res, Function& Iteration, PrimeIterator& primeiter, Checkpoint& checkpoint)
+            {
+				if (checkpoint.restore(cra, primeiter))
+					commentator().report(Commentator::LEVEL_IMPORTANT, INTERNAL_DESCRIPTION) << "Resuming from " << checkpoint.path() << " after " << cra.iterCount() << " iterations" << std::endl;
+				while (! cra(checkpoint.stride(), res, Iteration, primeiter))
+					if (checkpoint.due())
+						checkpoint.save(cra, primeiter);
+				checkpoint.clear();
+            }
+
+	public:
+
 		template<class Param>
 		bool changeFactor(const Param& p)
             {
@@ -0,0 +1,231 @@
+/*
+ * Copyright (C) LinBox Team
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file algorithms/dixon-solver/dixon-prepared.h
+ * @ingroup algorithms
+ * @brief Dixon solver for one matrix and many right-hand sides, the inverse mod p being computed once.
+ */
+
+#pragma once
+
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "linbox/util/error.h"
+#include "linbox/ring/modular.h"
+#include "linbox/randiter/random-prime.h"
+#include "linbox/algorithms/rational-solver.h"
+
+namespace LinBox {
+
+    /** \brief Dixon solver prepared for one nonsingular integer matrix.
+     *
+     * The inverse of A mod p and the Hadamard bound of A are computed once,
+     * by the constructor, then each solve only costs the p-adic lifting and
+     * the rational reconstruction (see DixonSolver::solveNonsingularBlock).
+     *
+     * The solves do not modify the object, so many threads may solve
+     * against one prepared solver.  Copies share the prepared data.
+     *
+     * write() saves the prime, A, its inverse mod p and the Hadamard bound;
+     * the stream constructor reloads them without any elimination, checking
+     * A (invA v) = v mod p for a random v.
+     */
+    template <class Ring, class Field = Givaro::Modular<double>>
+    class DixonPreparedSolver {
+    public:
+        typedef typename Ring::Element Integer;
+        typedef BlasMatrix<Ring> IMatrix;
+        typedef BlasMatrix<Field> FMatrix;
+
+        /** Prepare A, with the first of maxPrimes primes modulo which it is nonsingular.
+         * @throws LinboxMathError if A is singular modulo all of them.
+         */
+        explicit DixonPreparedSolver(const IMatrix& A, int maxPrimes = DEFAULT_MAXPRIMES)
+            : DixonPreparedSolver(A, PrimeIterator<IteratorCategories::HeuristicTag>(FieldTraits<Field>::bestBitSize(A.coldim())),
+                                  maxPrimes)
+        {
+        }
+
+        /// Prepare A, with primes taken from genprime.
+        template <class RandomPrime>
+        DixonPreparedSolver(const IMatrix& A, RandomPrime genprime, int maxPrimes = DEFAULT_MAXPRIMES)
+            : _ring(A.field())
+            , _A(new IMatrix(A))
+            , _hb(DetailedHadamardBound(A))
+        {
+            linbox_check(A.rowdim() == A.coldim());
+            for (int trials = 0; trials < maxPrimes; ++trials, ++genprime)
+                if (invert(*genprime)) return;
+            throw LinboxMathError("DixonPreparedSolver: singular matrix modulo all the primes tried");
+        }
+
+        /** Reload a solver saved by write().
+         * @throws LinboxBadFormat if the stream does not hold a prepared solver,
+         * or if the inverse it holds is not the one of A mod p.
+         */
+        explicit DixonPreparedSolver(std::istream& is, const Ring& R = Ring())
+            : _ring(R)
+        {
+            std::string tag;
+            size_t n;
+            if (!(is >> tag) || (tag != "DixonPreparedSolver") || !(is >> _prime >> n >> _hb.logBound >> _hb.logBoundOverMinNorm))
+                throw LinboxBadFormat("DixonPreparedSolver: bad header");
+
+            _A.reset(new IMatrix(_ring, n, n));
+            _field.reset(new Field(_prime));
+            _invA.reset(new FMatrix(*_field, n, n));
+            Integer e;
+            integer v;
+            typename Field::Element x;
+            for (size_t i = 0; i < n; ++i)
+                for (size_t j = 0; j < n; ++j) {
+                    _ring.read(is, e);
+                    _A->setEntry(i, j, e);
+                }
+            for (size_t i = 0; i < n; ++i)
+                for (size_t j = 0; j < n; ++j) {
+                    is >> v;
+                    _invA->setEntry(i, j, _field->init(x, v));
+                }
+            if (!is) throw LinboxBadFormat("DixonPreparedSolver: truncated matrices");
+            if (!checkInverse()) throw LinboxBadFormat("DixonPreparedSolver: the inverse is not the one of A mod p");
+        }
+
+        /// Save the prime, the Hadamard bound, A and its inverse mod p.
+        std::ostream& write(std::ostream& os) const
+        {
+            const size_t n = _A->rowdim();
+            const std::streamsize precision = os.precision(std::numeric_limits<double>::max_digits10);
+            os << "DixonPreparedSolver " << _prime << ' ' << n << ' ' << _hb.logBound << ' ' << _hb.logBoundOverMinNorm << '\n';
+            os.precision(precision);
+            for (size_t i = 0; i < n; ++i) {
+                for (size_t j = 0; j < n; ++j) _ring.write(os, _A->getEntry(i, j)) << ' ';
+                os << '\n';
+            }
+            integer v;
+            for (size_t i = 0; i < n; ++i) {
+                for (size_t j = 0; j < n; ++j) os << _field->convert(v, _invA->getEntry(i, j)) << ' ';
+                os << '\n';
+            }
+            return os;
+        }
+
+        /** Solve Ax = b, <code>x = 1/den * num</code>.
+         * @return SS_OK, or SS_FAILED if the solution did not reconstruct.
+         */
+        template <class Vector1, class Vector2>
+        SolverReturnStatus solve(Vector1& num, Integer& den, const Vector2& b) const
+        {
+            linbox_check(b.size() == _A->rowdim());
+            linbox_check(num.size() == _A->coldim());
+            IMatrix B(_ring, b.size(), 1);
+            Integer e;
+            for (size_t i = 0; i < b.size(); ++i) B.setEntry(i, 0, _ring.init(e, b[i]));
+
+            std::vector<BlasVector<Ring>> nums;
+            std::vector<Integer> dens;
+            if (solve(nums, dens, B) != SS_OK) return SS_FAILED;
+            for (size_t i = 0; i < num.size(); ++i) _ring.assign(num[i], nums[0][i]);
+            _ring.assign(den, dens[0]);
+            return SS_OK;
+        }
+
+        /** Solve AX = B, column j of X being <code>1/den[j] * num[j]</code>.
+         * The projections of the lifting are drawn from a generator of the
+         * call, so that concurrent solves share no state.
+         * @return SS_OK, or SS_FAILED if the solution did not reconstruct.
+         */
+        SolverReturnStatus solve(std::vector<BlasVector<Ring>>& num, std::vector<Integer>& den, const IMatrix& B) const
+        {
+            linbox_check(B.rowdim() == _A->rowdim());
+            size_t steps;
+            std::mt19937_64 gen(std::random_device{}());
+            return Protected::dixonLiftBlock(num, den, steps, _ring, *_field, *_A, *_invA, _hb, B, gen) ? SS_OK : SS_FAILED;
+        }
+
+        const Ring& ring() const { return _ring; }
+        const IMatrix& matrix() const { return *_A; }
+        const integer& prime() const { return _prime; }
+        const Field& field() const { return *_field; }
+        /// Inverse of A mod prime()
+        const FMatrix& inverse() const { return *_invA; }
+        /// Hadamard bound of A, for the length of the lifting
+        const HadamardLogBoundDetails& hadamardBound() const { return _hb; }
+
+    protected:
+        Ring _ring;
+        std::shared_ptr<const IMatrix> _A;
+        integer _prime;
+        std::shared_ptr<const Field> _field;
+        std::shared_ptr<const FMatrix> _invA;
+        HadamardLogBoundDetails _hb;
+
+        bool invert(const integer& p)
+        {
+            std::shared_ptr<Field> F(new Field(p));
+            FMatrix Ap(*F, _A->rowdim(), _A->coldim());
+            MatrixHom::map(Ap, *_A);
+            std::shared_ptr<FMatrix> invA(new FMatrix(*F, _A->rowdim(), _A->coldim()));
+            int nullity;
+            BlasMatrixDomain<Field>(*F).invin(*invA, Ap, nullity);
+            if (nullity != 0) return false;
+            _invA = invA;
+            _field = F;
+            _prime = p;
+            return true;
+        }
+
+        // A (invA v) = v mod p for a random v
+        bool checkInverse() const
+        {
+            const Field& F = *_field;
+            const size_t n = _A->rowdim();
+            std::mt19937_64 gen(std::random_device{}());
+            Hom<Ring, Field> hom(_ring, F);
+            std::vector<typename Field::Element> v(n), w(n, F.zero);
+            typename Field::Element a, y;
+            for (size_t j = 0; j < n; ++j) F.init(v[j], int64_t(gen() >> 33));
+            for (size_t i = 0; i < n; ++i)
+                for (size_t j = 0; j < n; ++j) F.axpyin(w[i], _invA->getEntry(i, j), v[j]);
+            for (size_t i = 0; i < n; ++i) {
+                F.assign(y, F.zero);
+                for (size_t j = 0; j < n; ++j) F.axpyin(y, hom.image(a, _A->getEntry(i, j)), w[j]);
+                if (!F.areEqual(y, v[i])) return false;
+            }
+            return true;
+        }
+    };
+}
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
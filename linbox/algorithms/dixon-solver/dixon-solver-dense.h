@@ -22,6 +22,10 @@
 
 #pragma once
 
+#include <memory>
+#include <random>
+#include <vector>
+
 #include "../rational-solver.h"
 
 namespace LinBox {
@@ -92,6 +96,13 @@ namespace LinBox {
 
         BlasMatrixDomain<Field> _bmdf;
 
+        // inverse of the last nonsingular matrix mod _invPrime, for the solves with oldMatrix
+        mutable std::shared_ptr<Field> _invField;
+        mutable std::shared_ptr<BlasMatrix<Field>> _invMatrix;
+        mutable Prime _invPrime;
+        // projections of the block lifting
+        mutable std::mt19937_64 _projGen;
+
 #ifdef RSTIMING
         mutable Timer tSetup, ttSetup, tFastInvert,
             ttFastInvert,                                               // only done in deterministic or inconsistent
@@ -117,6 +128,7 @@ namespace LinBox {
             : lastCertificate(r, 0)
             , _genprime(rp)
             , _ring(r)
+            , _projGen(std::random_device()())
         {
             _genprime.setBits(FieldTraits<Field>::bestBitSize());
             _prime = *_genprime;
@@ -136,6 +148,7 @@ namespace LinBox {
             , _genprime(rp)
             , _prime(p)
             , _ring(r)
+            , _projGen(std::random_device()())
         {
             _genprime.setBits(FieldTraits<Field>::bestBitSize());
 #ifdef RSTIMING
@@ -191,6 +204,27 @@ namespace LinBox {
         SolverReturnStatus solveNonsingular(Vector1& num, Integer& den, const IMatrix& A, const Vector2& b, bool s = false,
                                             int maxPrimes = DEFAULT_MAXPRIMES);
 
+        /** Solve a nonsingular, square linear system \c AX=B for several right-hand sides.
+         *
+         * The columns of B are lifted together from one inverse of A mod p:
+         * each p-adic step is a product by the inverse mod p and a product
+         * by A over the ring, matrix by matrix.  The lifting stops when a
+         * random projection of every column has stabilized.
+         *
+         * @param num       Numerators, num[j] for column j of B
+         * @param den       Denominators, <code>1/den[j] * num[j]</code> solves <code>Ax = B_j</code>
+         * @param A         Matrix of linear system (it must be square and dense)
+         * @param B         Right-hand sides
+         * @param oldMatrix the inverse of the previous solve is reused, A must be the same matrix
+         * @param maxPrimes maximum number of moduli to try
+         *
+         * @return status of solution, as solveNonsingular.
+         */
+        template <class IMatrix>
+        SolverReturnStatus solveNonsingularBlock(std::vector<BlasVector<Ring>>& num, std::vector<Integer>& den, const IMatrix& A,
+                                                 const BlasMatrix<Ring>& B, bool oldMatrix = false,
+                                                 int maxPrimes = DEFAULT_MAXPRIMES);
+
         /** Solve a general rectangular linear system \c Ax=b over quotient field of a ring.
          *  If A is known to be square and nonsingular, calling solveNonsingular is more efficient.
          *
@@ -340,6 +374,11 @@ namespace LinBox {
 #endif
 
     private:
+        /// Inverse of A modulo one of maxPrimes primes, kept for the next solves.
+        /// @return false if A is singular modulo all of them
+        template <class IMatrix>
+        bool prepareInverse(const IMatrix& A, bool oldMatrix, int maxPrimes);
+
         /// Internal usage
         template <class TAS>
         SolverReturnStatus solveApparentlyInconsistent(const BlasMatrix<Ring>& A, TAS& tas, BlasMatrix<Field>* Atp_minor_inv,
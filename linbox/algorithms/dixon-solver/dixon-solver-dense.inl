@@ -26,9 +26,144 @@
 #include "linbox/algorithms/lifting-container.h"
 #include "linbox/algorithms/matrix-inverse.h"
 #include "linbox/algorithms/rational-reconstruction.h"
+#include "linbox/solutions/hadamard-bound.h"
 
 namespace LinBox {
 
+    namespace Protected {
+        /* Dixon lifting of the columns of B together, from the inverse invA
+         * of A over the field F mod p, hb being the Hadamard bound of A.
+         * Returns false if a column does not reconstruct, steps is the
+         * number of p-adic steps done.  A and invA are only read, the
+         * projections are drawn from gen.
+         */
+        template <class Ring, class Field, class IMatrix>
+        bool dixonLiftBlock(std::vector<BlasVector<Ring>>& num, std::vector<typename Ring::Element>& den, size_t& steps,
+                            const Ring& ring, const Field& F, const IMatrix& A, const BlasMatrix<Field>& invA,
+                            const HadamardLogBoundDetails& hb, const BlasMatrix<Ring>& B, std::mt19937_64& gen)
+        {
+            typedef typename Ring::Element Integer;
+            const size_t n = A.rowdim(), k = B.coldim();
+            Integer p, tmp;
+            integer q;
+            ring.init(p, F.characteristic(q));
+
+            // length of the lifting for the largest column of B, as in LiftingContainerBase
+            double bLogNorm = 0.;
+            for (typename BlasMatrix<Ring>::ConstColIterator col = B.colBegin(); col != B.colEnd(); ++col) {
+                double colLogNorm;
+                if (vectorLogNorm(colLogNorm, col->begin(), col->end()) && (colLogNorm > bLogNorm)) bLogNorm = colLogNorm;
+            }
+            const double numLogBound = hb.logBoundOverMinNorm + bLogNorm + 1.0;
+            const size_t length = (size_t)std::ceil((1 + numLogBound + hb.logBound) / Givaro::logtwo(p));
+
+            BlasMatrixDomain<Field> BMDF(F);
+            BlasMatrixDomain<Ring> BMDR(ring);
+            Hom<Ring, Field> hom(ring, F);
+            BlasMatrix<Ring> R(B), X(ring, n, k), D(ring, n, k), AD(ring, n, k);
+            BlasMatrix<Field> Rp(F, n, k), Dp(F, n, k);
+
+            // a random projection of each column, reconstructed as the lifting goes
+            BlasVector<Ring> proj(ring, n);
+            for (size_t i = 0; i < n; ++i) ring.init(proj[i], int64_t(gen() >> 33));
+            std::vector<Integer> c(k, ring.zero), cNum(k, ring.zero), cDen(k, ring.one);
+            std::vector<bool> stable(k, false);
+
+            Integer modulus(ring.one), pmodulus, bound, rNum, rDen;
+            size_t step = 0;
+            while (step < length) {
+                // D = A^{-1} R mod p
+                MatrixHom::map(Rp, R);
+                BMDF.mul(Dp, invA, Rp);
+                for (size_t i = 0; i < n; ++i)
+                    for (size_t j = 0; j < k; ++j) {
+                        hom.preimage(tmp, Dp.getEntry(i, j));
+                        D.setEntry(i, j, tmp);
+                    }
+
+                // R = (R - A D) / p, exactly
+                BMDR.mul(AD, A, D);
+                for (size_t i = 0; i < n; ++i)
+                    for (size_t j = 0; j < k; ++j) {
+                        ring.sub(tmp, R.getEntry(i, j), AD.getEntry(i, j));
+                        ring.divin(tmp, p);
+                        R.setEntry(i, j, tmp);
+                    }
+
+                // X += D p^step, and its projections
+                ring.assign(pmodulus, modulus);
+                ring.mulin(modulus, p);
+                ++step;
+                for (size_t j = 0; j < k; ++j) {
+                    Integer t(ring.zero);
+                    for (size_t i = 0; i < n; ++i) {
+                        ring.axpy(tmp, D.getEntry(i, j), pmodulus, X.getEntry(i, j));
+                        X.setEntry(i, j, tmp);
+                        ring.axpyin(t, proj[i], D.getEntry(i, j));
+                    }
+                    ring.axpyin(c[j], t, pmodulus);
+                    ring.modin(c[j], modulus);
+                }
+
+                // early termination, when every projection agrees twice with its fraction
+                if ((step % 2) == 0) {
+                    ring.sqrt(bound, modulus / 2);
+                    bool done = true;
+                    for (size_t j = 0; j < k; ++j) {
+                        ring.mul(tmp, c[j], cDen[j]);
+                        ring.subin(tmp, cNum[j]);
+                        ring.modin(tmp, modulus);
+                        stable[j] = stable[j] && ring.isZero(tmp);
+                        if (stable[j]) continue;
+                        done = false;
+                        if (Givaro::Rational::RationalReconstruction(rNum, rDen, c[j], modulus, bound, bound)) {
+                            ring.assign(cNum[j], rNum);
+                            ring.assign(cDen[j], rDen);
+                            stable[j] = true;
+                        }
+                    }
+                    if (done) break;
+                }
+            }
+
+            // each column with a common denominator, starting from the one of its projection
+            ring.sqrt(bound, modulus / 2);
+            num.assign(k, BlasVector<Ring>(ring, n));
+            den.assign(k, ring.one);
+            Integer neg, absNeg, l, g;
+            for (size_t j = 0; j < k; ++j) {
+                Integer& d = den[j];
+                ring.assign(d, cDen[j]);
+                for (size_t i = 0; i < n; ++i) {
+                    ring.mul(tmp, X.getEntry(i, j), d);
+                    ring.modin(tmp, modulus);
+                    ring.sub(neg, tmp, modulus);
+                    if (ring.compare(tmp, bound) < 0) {
+                        ring.assign(num[j][i], tmp);
+                        continue;
+                    }
+                    ring.abs(absNeg, neg);
+                    if (ring.compare(absNeg, bound) < 0) {
+                        ring.assign(num[j][i], neg);
+                        continue;
+                    }
+                    if (!Givaro::Rational::RationalReconstruction(rNum, rDen, X.getEntry(i, j), modulus, bound, bound))
+                        return false;
+                    ring.lcm(l, d, rDen);
+                    ring.div(g, l, d);
+                    if (!ring.isOne(g))
+                        for (size_t h = 0; h < i; ++h) ring.mulin(num[j][h], g);
+                    ring.div(g, l, rDen);
+                    ring.mul(num[j][i], g, rNum);
+                    ring.assign(d, l);
+                }
+            }
+
+            steps = step;
+            return true;
+        }
+    }
+
     template <class Ring, class Field, class RandomPrime>
     template <class IMatrix, class Vector1, class Vector2>
     SolverReturnStatus DixonSolver<Ring, Field, RandomPrime, Method::DenseElimination>::solve(Vector1& num, Integer& den,
@@ -59,92 +194,104 @@ namespace LinBox {
     }
 
     template <class Ring, class Field, class RandomPrime>
-    template <class IMatrix, class Vector1, class Vector2>
-    SolverReturnStatus DixonSolver<Ring, Field, RandomPrime, Method::DenseElimination>::solveNonsingular(
-        Vector1& num, Integer& den, const IMatrix& A, const Vector2& b, bool oldMatrix, int maxPrimes)
+    template <class IMatrix>
+    bool DixonSolver<Ring, Field, RandomPrime, Method::DenseElimination>::prepareInverse(const IMatrix& A, bool oldMatrix,
+                                                                                          int maxPrimes)
     {
-        commentator().start("solve.dixon.integer.nonsingular.denseelim");
-
-        int trials = 0, notfr;
+        // the inverse of the previous matrix is still at hand
+        if (oldMatrix && _invMatrix) return true;
 
-        // history sensitive data for optimal reason
-        // static const IMatrix* IMP;
-
-        BlasMatrix<Field>* FMP = NULL;
-        Field* F = NULL;
-
-        do {
+        int notfr;
+        for (int trials = 0; trials < maxPrimes; ++trials) {
 #ifdef RSTIMING
             tNonsingularSetup.start();
 #endif
-            // typedef typename Field::Element Element;
-            // typedef typename Ring::Element Integer;
-
-            // checking size of system
-            linbox_check(A.rowdim() == A.coldim());
-            linbox_check(A.rowdim() == b.size());
-
-            LinBox::integer tmp;
-
-            // if input matrix A is different one.
-            if (!oldMatrix) {
-                if (trials == maxPrimes) return SS_SINGULAR;
-                if (trials != 0) chooseNewPrime();
-                ++trials;
-
-                // Could delete a non allocated matrix -> segfault
-                if (FMP != NULL) delete FMP;
-
-                // IMP = &A;
-
-                if (F != NULL) delete F;
+            if (trials != 0) chooseNewPrime();
 
-                F = new Field(_prime);
-                FMP = new BlasMatrix<Field>(*F, A.rowdim(), A.coldim());
-                MatrixHom::map(*FMP, A); // use MatrixHom to reduce matrix PG 2005-06-16
+            std::shared_ptr<Field> F(new Field(_prime));
+            BlasMatrix<Field> Ap(*F, A.rowdim(), A.coldim());
+            MatrixHom::map(Ap, A); // use MatrixHom to reduce matrix PG 2005-06-16
 
-                BlasMatrix<Field>* invA = new BlasMatrix<Field>(*F, A.rowdim(), A.coldim());
-                BlasMatrixDomain<Field> BMDF(*F);
+            std::shared_ptr<BlasMatrix<Field>> invA(new BlasMatrix<Field>(*F, A.rowdim(), A.coldim()));
+            BlasMatrixDomain<Field> BMDF(*F);
 #ifdef RSTIMING
-                tNonsingularSetup.stop();
-                ttNonsingularSetup += tNonsingularSetup;
-                tNonsingularInv.start();
+            tNonsingularSetup.stop();
+            ttNonsingularSetup += tNonsingularSetup;
+            tNonsingularInv.start();
 #endif
-                assert(FMP != NULL);
-                BMDF.invin(*invA, *FMP, notfr); // notfr <- nullity
-                delete FMP;
-                FMP = invA;
-
+            BMDF.invin(*invA, Ap, notfr); // notfr <- nullity
 #ifdef RSTIMING
-                tNonsingularInv.stop();
-                ttNonsingularInv += tNonsingularInv;
+            tNonsingularInv.stop();
+            ttNonsingularInv += tNonsingularInv;
 #endif
+            if (notfr == 0) {
+                _invMatrix = invA;
+                _invField = F;
+                _invPrime = _prime;
+                return true;
             }
-            else {
-#ifdef RSTIMING
-                tNonsingularSetup.stop();
-                ttNonsingularSetup += tNonsingularSetup;
-#endif
-                notfr = 0;
-            }
-        } while (notfr);
+        }
+        return false;
+    }
+
+    template <class Ring, class Field, class RandomPrime>
+    template <class IMatrix, class Vector1, class Vector2>
+    SolverReturnStatus DixonSolver<Ring, Field, RandomPrime, Method::DenseElimination>::solveNonsingular(
+        Vector1& num, Integer& den, const IMatrix& A, const Vector2& b, bool oldMatrix, int maxPrimes)
+    {
+        commentator().start("solve.dixon.integer.nonsingular.denseelim");
+
+        // checking size of system
+        linbox_check(A.rowdim() == A.coldim());
+        linbox_check(A.rowdim() == b.size());
+
+        if (!prepareInverse(A, oldMatrix, maxPrimes)) {
+            commentator().stop("solve.dixon.integer.nonsingular.denseelim");
+            return SS_SINGULAR;
+        }
 
         typedef DixonLiftingContainer<Ring, Field, IMatrix, BlasMatrix<Field>> LiftingContainer;
-        LiftingContainer lc(_ring, *F, A, *FMP, b, _prime);
+        LiftingContainer lc(_ring, *_invField, A, *_invMatrix, b, _invPrime);
         RationalReconstruction<LiftingContainer> re(lc);
         if (!re.getRational(num, den, 0)) {
-            delete FMP;
+            commentator().stop("solve.dixon.integer.nonsingular.denseelim");
             return SS_FAILED;
         }
 #ifdef RSTIMING
         ttNonsingularSolve.update(re, lc);
 #endif
-        if (F != NULL) delete F;
-        if (FMP != NULL) delete FMP;
         commentator().stop("solve.dixon.integer.nonsingular.denseelim");
         return SS_OK;
     }
 
+    template <class Ring, class Field, class RandomPrime>
+    template <class IMatrix>
+    SolverReturnStatus DixonSolver<Ring, Field, RandomPrime, Method::DenseElimination>::solveNonsingularBlock(
+        std::vector<BlasVector<Ring>>& num, std::vector<Integer>& den, const IMatrix& A, const BlasMatrix<Ring>& B,
+        bool oldMatrix, int maxPrimes)
+    {
+        commentator().start("solve.dixon.integer.nonsingular.block");
+
+        linbox_check(A.rowdim() == A.coldim());
+        linbox_check(A.rowdim() == B.rowdim());
+
+        if (!prepareInverse(A, oldMatrix, maxPrimes)) {
+            commentator().stop("solve.dixon.integer.nonsingular.block");
+            return SS_SINGULAR;
+        }
+
+        size_t steps;
+        if (!Protected::dixonLiftBlock(num, den, steps, _ring, *_invField, A, *_invMatrix, DetailedHadamardBound(A), B, _projGen)) {
+            commentator().stop("solve.dixon.integer.nonsingular.block");
+            return SS_FAILED;
+        }
+
+        commentator().report(Commentator::LEVEL_NORMAL, INTERNAL_DESCRIPTION)
+            << B.coldim() << " right-hand sides lifted in " << steps << " p-adic steps" << std::endl;
+        commentator().stop("solve.dixon.integer.nonsingular.block");
+        return SS_OK;
+    }
+
     template <class Ring, class Field, class RandomPrime>
     template <class IMatrix, class Vector1, class Vector2>
     SolverReturnStatus DixonSolver<Ring, Field, RandomPrime, Method::DenseElimination>::solveSingular(
@@ -239,6 +239,7 @@ namespace LinBox
 							// if (! field().isZero (tmp)) {
 							++columns[j_piv];
 							construit[j++] = E ((unsigned)j_piv, tmp);
+							LINBOX_COUNT(GaussFillIn, 1);
 							// }
 							// else
 							// std::cerr << "NEVER HAPPENED" << std::endl;
@@ -253,6 +254,7 @@ namespace LinBox
 						construit[j++] = lignecourante[m++];
 
 					construit.resize (j);
+					LINBOX_COUNT(GaussRowUpdates, 1);
 					lignecourante = construit;
 				}
 				else {
@@ -473,6 +475,7 @@ namespace LinBox
 							// if (! field().isZero (tmp)) {
 							++columns[j_piv];
 							construit[j++] = E ((unsigned)j_piv, tmp);
+							LINBOX_COUNT(GaussFillIn, 1);
 							// }
 							// else
 							// std::cerr << "NEVER HAPPENED" << std::endl;
@@ -487,6 +490,7 @@ namespace LinBox
 						construit[j++] = lignecourante[m++];
 
 					construit.resize (j);
+					LINBOX_COUNT(GaussRowUpdates, 1);
 					lignecourante = construit;
 				}
 				else {
@@ -675,6 +679,7 @@ namespace LinBox
 							field().mul (tmp, headcoeff, lignepivot[l].second);
 							// if (! field().isZero (tmp))
 							construit[j++] = E (j_piv, tmp);
+							LINBOX_COUNT(GaussFillIn, 1);
 							// else
 							// std::cerr << "NEVER HAPPENED" << std::endl;
 						}
@@ -686,6 +691,7 @@ namespace LinBox
 						construit[j++] = lignecourante[m++];
 
 					construit.resize (j);
+					LINBOX_COUNT(GaussRowUpdates, 1);
 					lignecourante = construit;
 				}
 				else {
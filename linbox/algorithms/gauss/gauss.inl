@@ -475,6 +475,8 @@ namespace LinBox
                             size_t   Nj) const
     {
         typedef typename _Matrix::Row        Vector;
+        // Temporary rows share the arena of LigneA, if any
+        SparseRowArena::Scope arenaScope(eliminationArena(LigneA));
 
         // Requirements : LigneA is an array of sparse rows
         // In place (LigneA is modified)
@@ -619,6 +621,8 @@ namespace LinBox
                             size_t   Nj) const
     {
         typedef typename _Matrix::Row        Vector;
+        // Temporary rows share the arena of LigneA, if any
+        SparseRowArena::Scope arenaScope(eliminationArena(LigneA));
 
         // Requirements : LigneA is an array of sparse rows
         // In place (LigneA is modified)
@@ -39,6 +39,14 @@
 #include "linbox/randiter/random-prime.h"
 #include "linbox/algorithms/matrix-hom.h"
 #include "linbox/solutions/det.h"
+#include "linbox/solutions/hadamard-bound.h"
+#include "linbox/util/parallel-policy.h"
+
+#include <chrono>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
 
 // #define _LB_H_DET_TIMING
 
@@ -434,6 +442,166 @@ namespace LinBox
 
 	}
 
+	/** \brief Residues of det(A), divided by a known divisor.
+	 *
+	 * The determinant modulo each prime is kept, so that the residues
+	 * of det(A)/divisor can be replayed once a divisor is known.
+	 * The divisor must only change while no iteration runs.
+	 */
+	template <class Blackbox, class MyMethod>
+	struct IntegerModularDetDivided {
+		const Blackbox &A;
+		const MyMethod &M;
+		integer divisor;
+		std::map<integer, integer> residues; //!< det(A) mod p, for each prime p used so far
+		std::mutex lock;
+
+		IntegerModularDetDivided(const Blackbox& b, const MyMethod& n) :
+			A(b), M(n), divisor(1)
+		{}
+
+		template<class Element, typename Field>
+		IterationResult operator()(Element& d, const Field& F)
+		{
+			integer p, dp;
+			F.characteristic(p);
+			bool known;
+			{
+				std::lock_guard<std::mutex> guard(lock);
+				auto it = residues.find(p);
+				known = (it != residues.end());
+				if (known) dp = it->second;
+			}
+
+			if (known)
+				F.init(d, dp);
+			else {
+				typedef typename Blackbox::template rebind<Field>::other FBlackbox;
+				FBlackbox Ap(A, F);
+				detInPlace(d, Ap, RingCategories::ModularTag(), M);
+				F.convert(dp, d);
+				std::lock_guard<std::mutex> guard(lock);
+				residues[p] = dp;
+			}
+
+			if (divisor != 1) {
+				Element s;
+				F.init(s, divisor);
+				if (F.isZero(s)) return IterationResult::SKIP;
+				F.divin(d, s);
+			}
+			return IterationResult::CONTINUE;
+		}
+
+		/// Iterates over the primes already used
+		struct Replay {
+			typedef std::true_type UniqueSamplingTag;
+			std::map<integer, integer>::const_iterator it;
+			const integer& operator*() const { return it->first; }
+			Replay& operator++() { ++it; return *this; }
+		};
+	};
+
+	/** \brief Compute the determinant of A over the integers
+	 *
+	 * Variant of lif_cra_det where the last invariant factor s of A, a
+	 * divisor of det(A), is computed by a Dixon solve in a thread of its
+	 * own, while the CRA goes on with det(A) mod p.  When s is known, the
+	 * CRA restarts on det(A)/s from the residues already computed, with a
+	 * bound smaller by log2(s) bits.  The rounds of primes are sized by
+	 * the Hadamard bound (see PrimeBatchSchedule).
+	 *
+	 * The divisor is only looked for on dense matrices, where the solve
+	 * costs about one elimination, and when the first round of primes did
+	 * not terminate early; the result waits for the solve to finish.
+	 * Other matrices go through cra_det.
+	 *
+	 * @param d Field element into which to store the result
+	 * @param A Black box of which to compute the determinant
+	 * @param tag explicit over the integers
+	 * @param M method of the modular determinants
+	 \ingroup solutions
+	 */
+	template <class Blackbox, class MyMethod>
+	typename Blackbox::Field::Element & concurrent_lif_cra_det (typename Blackbox::Field::Element         &d,
+								    const Blackbox                            &A,
+								    const RingCategories::IntegerTag          &tag,
+								    const MyMethod                            &M)
+	{
+		typedef Givaro::ModularBalanced<double> mymodular;
+		typedef typename Blackbox::Field Integers;
+		typedef DixonSolver<Integers, mymodular, PrimeIterator<IteratorCategories::HeuristicTag>, Method::DenseElimination> Solver;
+		typedef ChineseRemainder<CRABuilderEarlySingle<mymodular> > CRA;
+		typedef IntegerModularDetDivided<Blackbox, MyMethod> Iteration;
+
+		if (! std::is_same<typename MatrixContainerTrait<Blackbox>::Type, MatrixContainerCategory::BlasContainer>::value)
+			return cra_det(d, A, tag, M);
+
+		commentator().start ("Integer Determinant - concurrent divisor", "det");
+
+		const double logBound = HadamardBound(A);
+
+		Iteration iteration(A, M);
+		PrimeIterator<IteratorCategories::HeuristicTag> genprime(FieldTraits<mymodular>::bestBitSize(A.coldim()));
+		std::unique_ptr<CRA> cra(new CRA(LINBOX_DEFAULT_EARLY_TERMINATION_THRESHOLD));
+		cra->schedule().logBound = logBound;
+		const int stride = (int)(cra->schedule().maxBatchFactor * ParallelPolicy::allThreads().threads());
+
+		integer res;
+		if ((*cra)(stride, res, iteration, genprime)) {
+			A.field().init(d, res);
+			commentator().stop ("first step", NULL, "det");
+			return d;
+		}
+
+		// Last invariant factor, concurrently; the future joins it on any exit
+		std::future<integer> lifTask = std::async(std::launch::async, [&A]() {
+			try {
+				Solver RSolver;
+				LastInvariantFactor<Integers, Solver> LIF(RSolver);
+				BlasVector<Integers> r_num(A.field(), A.coldim());
+				typename Integers::Element s;
+				LIF.lastInvariantFactor1(s, r_num, A);
+				return integer(s);
+			}
+			catch (...) {
+				return integer(1); // no divisor, the CRA goes on with det(A)
+			}
+		});
+
+		integer lif(1);
+		bool divided = false, done = false;
+		while (! done) {
+			if (! divided && lifTask.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+				divided = true;
+				lif = lifTask.get();
+				if (lif == 0) {
+					res = 0;
+					break;
+				}
+				commentator().report (Commentator::LEVEL_NORMAL, INTERNAL_DESCRIPTION) << "lif calculated\n";
+
+				// Restart on det/lif, from the residues at hand
+				iteration.divisor = lif;
+				cra.reset(new CRA(LINBOX_DEFAULT_EARLY_TERMINATION_THRESHOLD));
+				cra->schedule().logBound = (logBound > 0.) ? std::max(logBound - (double)Givaro::logtwo(lif), 1.) : 0.;
+				typename Iteration::Replay replay { iteration.residues.cbegin() };
+				done = (*cra)((int)iteration.residues.size(), res, iteration, replay);
+				continue;
+			}
+			done = (*cra)(stride, res, iteration, genprime);
+		}
+
+		if (! divided) lifTask.wait();
+		if (divided && lif != 0) res *= lif;
+		A.field().init(d, res);
+
+		commentator().report(Commentator::LEVEL_NORMAL, INTERNAL_DESCRIPTION)
+			<< "Iterations done " << iteration.residues.size() << ", divisor " << (divided ? lif : integer(1)) << "\n";
+		commentator().stop ("done", NULL, "det");
+		return d;
+	}
+
 #if 0
 	template <class Integers, class MyMethod>
 	typename Integers::Element & lif_cra_det (typename Integers::Element                &d,
@@ -0,0 +1,383 @@
+/* linbox/algorithms/incremental-echelon.h
+ * Copyright (C) LinBox
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+#ifndef __LINBOX_algorithms_incremental_echelon_H
+#define __LINBOX_algorithms_incremental_echelon_H
+
+/*! @file algorithms/incremental-echelon.h
+ * @brief  Reduced row echelon form updated by appended rows and columns
+ * @ingroup algorithms
+ *
+ * Rank and right nullspace of a matrix whose rows arrive over time,
+ * without restarting the elimination at each new batch.
+ */
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "linbox/util/debug.h"
+#include "linbox/field/gf2.h"
+#include "linbox/vector/vector-traits.h"
+#include "linbox/matrix/dense-matrix.h"
+
+namespace LinBox
+{
+
+	/** \brief Reduced row echelon form of a matrix growing by rows and columns.
+	 *
+	 * The rows of the echelon form are kept sparse, in the SparseSeq
+	 * format of GaussDomain: sorted (column, value) pairs, no zero stored.
+	 * Every row has a pivot, equal to one, which is its leading entry and
+	 * the only non zero of its column.  So a row of the echelon form has at
+	 * most coldim() - rank() + 1 entries, even for dense input.
+	 *
+	 * A new row is reduced by the rows of its pivot columns only, each
+	 * once.  If something is left, it becomes a new pivot row and its
+	 * pivot column is cleared from the older rows.  Neither costs more than
+	 * the size of the echelon form: no earlier row is eliminated again.
+	 *
+	 * Appended columns are new zero columns, i.e. new free variables.
+	 * Dense (BlasMatrix, BlasVector) and SparseSeq (SparseMatrix,
+	 * GaussDomain::Matrix) rows are accepted.  GF2 has its own
+	 * specialisation, on sets of column indices.
+	 */
+	template<class _Field>
+	class IncrementalEchelon {
+	public:
+		typedef _Field                                  Field;
+		typedef typename Field::Element                 Element;
+		typedef std::vector<std::pair<size_t, Element> > Row;
+
+		/// Empty echelon form, with n columns
+		IncrementalEchelon (const Field & F, size_t n = 0) :
+			_field(&F), _rowdim(0), _pivotRow(n, none)
+		{}
+
+		/// Echelon form of the rows of A
+		template<class Matrix>
+		explicit IncrementalEchelon (const Matrix & A) :
+			IncrementalEchelon(A.field(), A.coldim())
+		{
+			appendRows(A);
+		}
+
+		const Field & field () const { return *_field; }
+		size_t rank () const { return _rows.size(); }
+		/// Number of rows appended so far
+		size_t rowdim () const { return _rowdim; }
+		size_t coldim () const { return _pivotRow.size(); }
+		size_t nullity () const { return coldim() - rank(); }
+
+		/// Row i of the echelon form, rows being kept in the order their pivots appeared
+		const Row & echelonRow (size_t i) const { return _rows[i]; }
+		/// Pivot column of row i of the echelon form
+		size_t pivot (size_t i) const { return _rows[i].front().first; }
+		bool isPivot (size_t j) const { return _pivotRow[j] != none; }
+
+		/** Append one row, dense or SparseSeq, of at most coldim() entries.
+		 * @return true if the rank grew
+		 */
+		template<class Vector>
+		bool appendRow (const Vector & v)
+		{
+			Row r;
+			toRow(r, v, typename VectorTraits<Vector>::VectorCategory());
+			return absorb(r);
+		}
+
+		/** Append the rows of A, a BlasMatrix or a SparseSeq matrix.
+		 * @return the rank increase
+		 */
+		template<class Matrix>
+		size_t appendRows (const Matrix & A)
+		{
+			linbox_check(A.coldim() <= coldim());
+			const size_t r = rank();
+			for (typename Matrix::ConstRowIterator row = A.rowBegin(); row != A.rowEnd(); ++row)
+				appendRow(*row);
+			return rank() - r;
+		}
+
+		/// Append k zero columns: the rank is unchanged and the nullity grows by k
+		void appendColumns (size_t k = 1)
+		{
+			_pivotRow.resize(coldim() + k, none);
+		}
+
+		/** Right nullspace basis, as the columns of the coldim() x nullity() matrix K.
+		 * Column j of K has a one in the j-th non pivot column f, and -R(i,f)
+		 * in the pivot column of each row i of the echelon form R.
+		 */
+		BlasMatrix<Field> & nullspaceBasis (BlasMatrix<Field> & K) const
+		{
+			std::vector<size_t> freeIndex;
+			const size_t k = freeColumns(freeIndex);
+			K.resize(coldim(), k);
+			for (size_t i = 0; i < coldim(); ++i)
+				for (size_t j = 0; j < k; ++j)
+					K.setEntry(i, j, field().zero);
+			for (size_t f = 0; f < coldim(); ++f)
+				if (! isPivot(f))
+					K.setEntry(f, freeIndex[f], field().one);
+			Element t;
+			field().init(t);
+			for (const Row & r : _rows)
+				for (typename Row::const_iterator e = r.begin() + 1; e != r.end(); ++e)
+					K.setEntry(r.front().first, freeIndex[e->first], field().neg(t, e->second));
+			return K;
+		}
+
+	protected:
+		enum : size_t { none = (size_t)-1 };
+
+		template<class Vector>
+		void toRow (Row & r, const Vector & v, VectorCategories::DenseVectorTag) const
+		{
+			linbox_check(v.size() <= coldim());
+			size_t j = 0;
+			for (typename Vector::const_iterator e = v.begin(); e != v.end(); ++e, ++j)
+				if (! field().isZero(*e))
+					r.push_back(std::make_pair(j, *e));
+		}
+
+		template<class Vector>
+		void toRow (Row & r, const Vector & v, VectorCategories::SparseSequenceVectorTag) const
+		{
+			for (typename Vector::const_iterator e = v.begin(); e != v.end(); ++e)
+				if (! field().isZero(e->second))
+					r.push_back(std::make_pair((size_t)e->first, e->second));
+			if (! std::is_sorted(r.begin(), r.end(), SparseSequenceVectorPairLessThan<Element>()))
+				std::sort(r.begin(), r.end(), SparseSequenceVectorPairLessThan<Element>());
+			linbox_check(r.empty() || r.back().first < coldim());
+		}
+
+		/// y <- y - a x, by merging the two rows into z, whose storage is reused
+		void maxpyin (Row & y, const Element & a, const Row & x, Row & z) const
+		{
+			z.clear();
+			z.reserve(y.size() + x.size());
+			Element t;
+			field().init(t);
+			typename Row::const_iterator yi = y.begin(), xi = x.begin();
+			while (yi != y.end() && xi != x.end()) {
+				if (yi->first < xi->first)
+					z.push_back(*yi++);
+				else if (xi->first < yi->first) {
+					field().mul(t, a, xi->second);
+					z.push_back(std::make_pair(xi->first, field().negin(t)));
+					++xi;
+				}
+				else {
+					field().assign(t, yi->second);
+					if (! field().isZero(field().maxpyin(t, a, xi->second)))
+						z.push_back(std::make_pair(xi->first, t));
+					++xi; ++yi;
+				}
+			}
+			for (; yi != y.end(); ++yi)
+				z.push_back(*yi);
+			for (; xi != x.end(); ++xi) {
+				field().mul(t, a, xi->second);
+				z.push_back(std::make_pair(xi->first, field().negin(t)));
+			}
+			y.swap(z);
+		}
+
+		bool absorb (Row & v)
+		{
+			++_rowdim;
+			// The pivot rows are zero in the other pivot columns, so the
+			// multipliers are the entries of v itself in the pivot columns
+			std::vector<std::pair<size_t, Element> > coefs;
+			for (const auto & e : v)
+				if (isPivot(e.first))
+					coefs.push_back(std::make_pair(_pivotRow[e.first], e.second));
+			Row tmp;
+			for (const auto & c : coefs)
+				maxpyin(v, c.second, _rows[c.first], tmp);
+			if (v.empty()) return false;
+
+			const size_t p = v.front().first;
+			Element s;
+			field().init(s);
+			field().inv(s, v.front().second);
+			for (auto & e : v) field().mulin(e.second, s);
+
+			// clear the new pivot column from the older rows
+			for (Row & r : _rows) {
+				typename Row::iterator e = std::lower_bound(r.begin(), r.end(), std::make_pair(p, field().zero),
+									     SparseSequenceVectorPairLessThan<Element>());
+				if (e != r.end() && e->first == p) {
+					field().assign(s, e->second);
+					maxpyin(r, s, v, tmp);
+				}
+			}
+			_pivotRow[p] = _rows.size();
+			_rows.push_back(Row());
+			_rows.back().swap(v);
+			return true;
+		}
+
+		/// freeIndex[f] is the rank of the non pivot column f among the non pivot columns
+		size_t freeColumns (std::vector<size_t> & freeIndex) const
+		{
+			freeIndex.assign(coldim(), none);
+			size_t k = 0;
+			for (size_t f = 0; f < coldim(); ++f)
+				if (! isPivot(f)) freeIndex[f] = k++;
+			return k;
+		}
+
+		const Field *       _field;
+		size_t              _rowdim;
+		std::vector<size_t> _pivotRow; // row of the echelon form of each pivot column, none for the others
+		std::vector<Row>    _rows;
+	};
+
+	/** \brief Reduced row echelon form over GF2, growing by rows and columns.
+	 * Rows are sorted vectors of the columns of their ones, eliminations
+	 * are symmetric differences.  Rows are given as containers of column
+	 * indices, as the rows of GaussDomain<GF2>::Matrix (ZeroOne<GF2>).
+	 */
+	template<>
+	class IncrementalEchelon<GF2> {
+	public:
+		typedef GF2                 Field;
+		typedef GF2::Element        Element;
+		typedef std::vector<size_t> Row;
+
+		IncrementalEchelon (const Field & F, size_t n = 0) :
+			_field(&F), _rowdim(0), _pivotRow(n, none)
+		{}
+
+		const Field & field () const { return *_field; }
+		size_t rank () const { return _rows.size(); }
+		size_t rowdim () const { return _rowdim; }
+		size_t coldim () const { return _pivotRow.size(); }
+		size_t nullity () const { return coldim() - rank(); }
+
+		const Row & echelonRow (size_t i) const { return _rows[i]; }
+		size_t pivot (size_t i) const { return _rows[i].front(); }
+		bool isPivot (size_t j) const { return _pivotRow[j] != none; }
+
+		/** Append the row with ones in the columns listed by v.
+		 * @return true if the rank grew
+		 */
+		template<class Vector>
+		bool appendRow (const Vector & v)
+		{
+			Row r(v.begin(), v.end());
+			if (! std::is_sorted(r.begin(), r.end()))
+				std::sort(r.begin(), r.end());
+			linbox_check(r.empty() || r.back() < coldim());
+			return absorb(r);
+		}
+
+		/** Append the rows of A, a container of rows of column indices.
+		 * @return the rank increase
+		 */
+		template<class SparseSeqMatrix>
+		size_t appendRows (const SparseSeqMatrix & A)
+		{
+			const size_t r = rank();
+			for (typename SparseSeqMatrix::const_iterator row = A.begin(); row != A.end(); ++row)
+				appendRow(*row);
+			return rank() - r;
+		}
+
+		void appendColumns (size_t k = 1)
+		{
+			_pivotRow.resize(coldim() + k, none);
+		}
+
+		/** Right nullspace basis, one row of column indices per kernel vector.
+		 * Vector j has a one in the j-th non pivot column f, and in the
+		 * pivot column of each row of the echelon form with a one in f.
+		 */
+		std::vector<Row> & nullspaceBasis (std::vector<Row> & K) const
+		{
+			std::vector<size_t> freeIndex(coldim(), none);
+			K.clear();
+			for (size_t f = 0; f < coldim(); ++f)
+				if (! isPivot(f)) {
+					freeIndex[f] = K.size();
+					K.push_back(Row(1, f));
+				}
+			for (const Row & r : _rows)
+				for (Row::const_iterator e = r.begin() + 1; e != r.end(); ++e)
+					K[freeIndex[*e]].push_back(r.front());
+			for (Row & k : K)
+				std::sort(k.begin(), k.end());
+			return K;
+		}
+
+	protected:
+		enum : size_t { none = (size_t)-1 };
+
+		/// y <- y + x
+		static void addin (Row & y, const Row & x, Row & tmp)
+		{
+			tmp.clear();
+			std::set_symmetric_difference(y.begin(), y.end(), x.begin(), x.end(), std::back_inserter(tmp));
+			y.swap(tmp);
+		}
+
+		bool absorb (Row & v)
+		{
+			++_rowdim;
+			std::vector<size_t> coefs;
+			for (size_t j : v)
+				if (isPivot(j)) coefs.push_back(_pivotRow[j]);
+			Row tmp;
+			for (size_t i : coefs)
+				addin(v, _rows[i], tmp);
+			if (v.empty()) return false;
+
+			const size_t p = v.front();
+			for (Row & r : _rows)
+				if (std::binary_search(r.begin(), r.end(), p))
+					addin(r, v, tmp);
+			_pivotRow[p] = _rows.size();
+			_rows.push_back(Row());
+			_rows.back().swap(v);
+			return true;
+		}
+
+		const Field *       _field;
+		size_t              _rowdim;
+		std::vector<size_t> _pivotRow;
+		std::vector<Row>    _rows;
+	};
+
+} // LinBox
+
+#endif // __LINBOX_algorithms_incremental_echelon_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
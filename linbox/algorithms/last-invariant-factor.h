@@ -29,7 +29,9 @@
 #include "linbox/algorithms/default.h"
 #include "linbox/algorithms/rational-solver.h"
 #include "linbox/vector/blas-vector.h"
+#include "linbox/matrix/dense-matrix.h"
 #include <utility>
+#include <vector>
 
 namespace LinBox
 {
@@ -38,6 +40,9 @@ namespace LinBox
 
 	  This computes the last invariant factor of an integer matrix,
 	  whether zero or not, by rational solving.
+	  The right-hand sides of a dense matrix over the ring are solved as
+	  one block when the Solver has solveNonsingularBlock, as the dense
+	  DixonSolver and RationalSolverAdaptive do, one by one otherwise.
 	  */
 	template<class _Ring,
 		class _Solver>
@@ -57,6 +62,62 @@ namespace LinBox
 		Solver solver;
 		int threshold;
 
+		// fill B with random right-hand sides
+		BlasMatrix<Ring>& randomBlock (BlasMatrix<Ring>& B) const
+		{
+			Integer e;
+			for (size_t i = 0; i < B.rowdim(); ++i)
+				for (size_t j = 0; j < B.coldim(); ++j) {
+					_gen(e);
+					B.setEntry(i, j, e);
+				}
+			return B;
+		}
+
+		// divide x by the primes of PrimeL as long as they divide it
+		template<class Vector>
+		Integer& filterPrimes (Integer& x, const Vector& PrimeL) const
+		{
+			if (r.isZero (x)) return x;
+			Integer pri, quo, rem;
+			typename Vector::const_iterator Prime_p;
+			for (Prime_p = PrimeL.begin(); Prime_p != PrimeL.end(); ++ Prime_p) {
+				r.init (pri, *Prime_p);
+				do {
+					r.quoRem(quo,rem,x,pri);
+					if (r.isZero(rem)) r.assign(x,quo);
+					else break;
+				} while (true);
+			}
+			return x;
+		}
+
+		// a solver with solveNonsingularBlock lifts all the columns of B together
+		template<class S, class IMatrix>
+		static auto solveBlock (S& s, std::vector<DVect>& num, std::vector<Integer>& den,
+					const IMatrix& A, const BlasMatrix<Ring>& B, int)
+			-> decltype(s.solveNonsingularBlock(num, den, A, B))
+		{
+			return s.solveNonsingularBlock(num, den, A, B);
+		}
+
+		// the others solve them one after another
+		template<class S, class IMatrix>
+		SolverReturnStatus solveBlock (S& s, std::vector<DVect>& num, std::vector<Integer>& den,
+					       const IMatrix& A, const BlasMatrix<Ring>& B, long) const
+		{
+			num.assign(B.coldim(), DVect(r, A.coldim()));
+			den.resize(B.coldim());
+			DVect b(r, A.rowdim());
+			for (size_t j = 0; j < B.coldim(); ++j) {
+				for (size_t i = 0; i < B.rowdim(); ++i)
+					r.assign(b[i], B.getEntry(i, j));
+				SolverReturnStatus tmp = s.solveNonsingular(num[j], den[j], A, b);
+				if (tmp != SS_OK) return tmp;
+			}
+			return SS_OK;
+		}
+
 	public:
 
 		/** _Ring, an integer ring,
@@ -113,9 +174,8 @@ namespace LinBox
 			// vector b, RHS, int is good enough
 			std::vector<int> b(A.rowdim());
 			typename std::vector<int>::iterator b_p;
-			typename Vector::const_iterator Prime_p;
 
-			Integer pri, quo, rem, itmp;
+			Integer itmp;
             int failedattempts(0);
 
 			for (; count < threshold; ++ count) {
@@ -137,20 +197,34 @@ namespace LinBox
 				} else r.lcmin (lif, r_den);
 			}
 			// filter out primes in PRIMEL from lif.
-			if (!r. isZero (lif))
-				for ( Prime_p = PrimeL.begin();
-				      Prime_p != PrimeL.end();
-				      ++ Prime_p) {
-					r.init (pri, *Prime_p);
-					do {
-						r.quoRem(quo,rem,lif,pri);
-						if (r.isZero(rem)) r.assign(lif,quo);
-						else break;
-					}
-					while (true);
+			return filterPrimes (lif, PrimeL);
+		}
+
+		/** \brief Compute the last invariant factor of a dense integer matrix,
+		 * by solving linear systems,
+		 * ignoring these factors of primes in list PrimeL
+		 * The threshold right-hand sides are solved together, from one
+		 * inverse of A mod p, when the Solver has solveNonsingularBlock.
+		 */
+		template<class _Rep, class Vector>
+		Integer& lastInvariantFactor(Integer& lif, const BlasMatrix<Ring, _Rep>& A,
+					     const Vector& PrimeL)
+		{
+			r.assign(lif, r.one);
+			BlasMatrix<Ring> B(r, A.rowdim(), (size_t)threshold);
+			std::vector<DVect> r_num;
+			std::vector<Integer> r_den;
+			int failedattempts(0);
+			while (solveBlock(solver, r_num, r_den, A, randomBlock(B), 0) != SS_OK)
+				if (++failedattempts > threshold) {
+					r.assign (lif, r.zero);
+					return lif;
 				}
+			for (size_t j = 0; j < r_den.size(); ++j)
+				r.lcmin (lif, r_den[j]);
 
-			return lif;
+			// filter out primes in PRIMEL from lif.
+			return filterPrimes (lif, PrimeL);
 		}
 
 		/** \brief Compute the last invariant factor of an integer matrix,
@@ -175,8 +249,6 @@ namespace LinBox
 			// vector b, RHS, 32-bit int is good enough
 			std::vector<int> b1(A. rowdim()), b2(A. rowdim());
 			typename std::vector<int>::iterator b_p;
-			typename Vector::const_iterator Prime_p;
-			Integer pri, quo, rem;
 
 			for (; count < (threshold + 1) / 2; ++ count) {
 				// assign b to be a random vector
@@ -242,26 +314,43 @@ namespace LinBox
 			}
 
 			// filter out primes in PRIMEL from lif.
-			if (!r. isZero (lif))
-				for ( Prime_p = PrimeL.begin(); Prime_p != PrimeL.end(); ++ Prime_p) {
-					r.init (pri, *Prime_p);
-					do {
-						r.quoRem(quo,rem,lif,pri);
-						if (r.isZero(rem)) r.assign(lif,quo);
-						else break;
-					} while (true);
-				}
+			filterPrimes (lif, PrimeL);
 			r. gcdin (Bonus, lif);
-			if (!r. isZero (Bonus))
-				for ( Prime_p = PrimeL.begin(); Prime_p != PrimeL.end(); ++ Prime_p) {
-					r.init (pri, *Prime_p);
-					do {
-						r.quoRem(quo,rem,Bonus,pri);
-						if (r.isZero(rem)) r.assign(lif,quo);
-						else break;
-					} while (true);
+			filterPrimes (Bonus, PrimeL);
+
+			return lif;
+		}
+
+		/** \brief Compute the last invariant factor of a dense integer matrix,
+		 * by solving linear systems,
+		 * ignoring these factors of primes in list PrimeL
+		 * Implement the Bonus in ref{....}
+		 * The pairs of right-hand sides are solved together, from one
+		 * inverse of A mod p, when the Solver has solveNonsingularBlock.
+		 */
+		template<class _Rep, class Vector>
+		Integer& lastInvariantFactor_Bonus(Integer& lif, Integer& Bonus, const BlasMatrix<Ring, _Rep>& A,
+						   const Vector& PrimeL)
+		{
+			r. assign(lif, r.one);
+			r. assign(Bonus, r.one);
+			const size_t pairs = (size_t)(threshold + 1) / 2;
+			BlasMatrix<Ring> B(r, A.rowdim(), 2 * pairs);
+			std::vector<DVect> r_num;
+			std::vector<Integer> r_den;
+			if (solveBlock(solver, r_num, r_den, A, randomBlock(B), 0) != SS_OK)
+				r.assign (lif, r.zero);
+			else
+				for (size_t c = 0; c < pairs; ++c) {
+					r. lcmin (lif, r_den[2*c]);
+					r. lcmin (lif, r_den[2*c+1]);
+					bonus (Bonus, r_den[2*c], r_den[2*c+1], r_num[2*c], r_num[2*c+1]);
 				}
 
+			// filter out primes in PRIMEL from lif.
+			filterPrimes (lif, PrimeL);
+			r. gcdin (Bonus, lif);
+			filterPrimes (Bonus, PrimeL);
 
 			return lif;
 		}
@@ -0,0 +1,167 @@
+/* linbox/algorithms/lattice-reduction.h
+ * Copyright (C) LinBox
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+#ifndef __LINBOX_algorithms_lattice_reduction_H
+#define __LINBOX_algorithms_lattice_reduction_H
+
+/*! @file algorithms/lattice-reduction.h
+ * @brief  LLL and BKZ reductions on BlasMatrix storage
+ * @ingroup algorithms
+ * @ingroup lattice
+ *
+ * No NTL nor fplll is needed: the rows of the BlasMatrix are reduced in place.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+#include "linbox/util/error.h"
+#include "linbox/util/parallel-policy.h"
+#include "linbox/matrix/dense-matrix.h"
+
+namespace LinBox
+{
+
+	/** \brief LLL and BKZ reduction of the rows of an integer matrix.
+	 *
+	 * The reduction works on the exact Gram matrix of the rows, with a
+	 * floating point Cholesky factorisation of it for the Gram–Schmidt
+	 * coefficients, as in the L² algorithm of Nguyen and Stehlé.  When
+	 * doubles are not enough (overflow, or a size reduction that does not
+	 * converge), the rows at hand are reduced again by the integral LLL of
+	 * Cohen (Algorithm 2.6.7), all in exact arithmetic.
+	 *
+	 * The rows are cut into segments of segment() rows.  The segments are
+	 * reduced independently, then merged two by two until one is left.
+	 * Merging a pair first size reduces the rows of the second segment
+	 * against the first one, every row independently, then runs LLL from
+	 * the first row of the second segment.  The segments of one level, and
+	 * the rows of one block size reduction, are shared between the threads
+	 * of the ParallelPolicy.
+	 *
+	 * The rows must be linearly independent, else LinboxMathError is thrown.
+	 * Element is expected to be an integer type such as Givaro::Integer.
+	 */
+	template<class Ring>
+	class LatticeReductionDomain {
+	public:
+		typedef typename Ring::Element Element;
+		typedef BlasMatrix<Ring>       Matrix;
+
+		/** @param delta Lovász constant, in (1/4, 1)
+		 * @param eta   size reduction bound, in [1/2, sqrt(delta))
+		 * @param segment number of rows reduced before any merge
+		 */
+		LatticeReductionDomain(const Ring & Z, double delta = 0.99, double eta = 0.51, size_t segment = 32,
+				       const ParallelPolicy & policy = ParallelPolicy()) :
+			_Z(Z), _delta(delta), _eta(eta), _segment(std::max(segment, (size_t)2)), _policy(policy), _fallbacks(0)
+		{}
+
+		/** LLL reduce the rows of B in place.
+		 * If U is given, it is set to the unimodular matrix such that
+		 * B_out = U B_in.
+		 */
+		void lll(Matrix & B, Matrix * U = nullptr);
+
+		/** BKZ reduce the rows of B in place, with blocks of blockSize rows.
+		 * B is first LLL reduced, then tours are run until one of them
+		 * changes nothing, or maxTours have been run.  BKZ stops at the
+		 * LLL reduced basis if the Gram–Schmidt norms do not fit in doubles.
+		 */
+		void bkz(Matrix & B, size_t blockSize, Matrix * U = nullptr, size_t maxTours = 16);
+
+		/// Number of segments that were reduced in exact arithmetic
+		size_t exactFallbacks() const { return _fallbacks; }
+
+		double delta() const { return _delta; }
+		double eta() const { return _eta; }
+		size_t segment() const { return _segment; }
+		const ParallelPolicy & policy() const { return _policy; }
+
+	protected:
+		/// Matrices of one reduction, with the Gram matrix and its Cholesky factorisation
+		struct Workspace {
+			Matrix * B;
+			Matrix * U;
+			size_t m, n;
+			std::vector<Element> G;    // Gram matrix of the rows of B
+			std::vector<double>  r;    // r(i,j) = <b_i, b*_j>, r(i,i) = |b*_i|^2
+			std::vector<double>  mu;   // Gram–Schmidt coefficients
+
+			Element & g(size_t i, size_t j) { return G[i*m+j]; }
+			double & rr(size_t i, size_t j) { return r[i*m+j]; }
+			double & mm(size_t i, size_t j) { return mu[i*m+j]; }
+		};
+
+		typedef std::vector<std::pair<size_t, Element> > Combination;
+
+		// row operations on B and U, with the Gram matrix kept exact for the rows lo..hi-1
+		void combineRows(Workspace & W, size_t k, const Combination & X);
+		void gramCombine(Workspace & W, size_t k, const Combination & X, size_t lo, size_t hi);
+		void gramAxpy(Workspace & W, size_t d, size_t s, const Element & q, size_t lo, size_t hi);
+		void addRow(Workspace & W, size_t d, size_t s, const Element & q, size_t lo, size_t hi);
+		void swapRows(Workspace & W, size_t i, size_t j, size_t lo, size_t hi);
+		void negateRow(Workspace & W, size_t i, size_t lo, size_t hi);
+		void gram(Workspace & W, size_t ilo, size_t ihi, size_t jlo, size_t jhi);
+
+		// floating point Gram–Schmidt
+		bool choleskyRow(Workspace & W, size_t i, size_t lo);
+		bool gramSchmidt(Workspace & W, size_t lo, size_t hi);
+
+		// reductions of the rows lo..hi-1
+		bool lllFloat(Workspace & W, size_t lo, size_t hi, size_t start);
+		void lllExact(Workspace & W, size_t lo, size_t hi);
+		void lllRange(Workspace & W, size_t lo, size_t hi, size_t start);
+		void sizeReduceBlock(Workspace & W, size_t lo, size_t mid, size_t hi);
+		void lllSegmented(Workspace & W);
+
+		// BKZ
+		bool enumerate(Workspace & W, size_t k, size_t e, std::vector<long> & x);
+		void insert(Workspace & W, size_t k, size_t e, std::vector<long> & x);
+
+		void start(Workspace & W, Matrix & B, Matrix * U);
+		template<class Task>
+		void parallelTasks(size_t count, Task task);
+
+		const Ring & _Z;
+		double _delta;
+		double _eta;
+		size_t _segment;
+		ParallelPolicy _policy;
+		std::atomic<size_t> _fallbacks;
+	};
+
+} // LinBox
+
+#include "linbox/algorithms/lattice-reduction.inl"
+
+#endif // __LINBOX_algorithms_lattice_reduction_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
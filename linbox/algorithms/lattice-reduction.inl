@@ -0,0 +1,581 @@
+/* linbox/algorithms/lattice-reduction.inl
+ * Copyright (C) LinBox
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+#ifndef __LINBOX_algorithms_lattice_reduction_INL
+#define __LINBOX_algorithms_lattice_reduction_INL
+
+/*!@internal
+ * @file algorithms/lattice-reduction.inl
+ * @brief  LLL and BKZ reductions on BlasMatrix storage
+ * @ingroup algorithms
+ * @ingroup lattice
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+
+namespace LinBox
+{
+
+	template<class Ring>
+	template<class Task>
+	void LatticeReductionDomain<Ring>::parallelTasks(size_t count, Task task)
+	{
+		if (count == 0) return;
+		const size_t nt = std::min(_policy.threads(), count);
+		std::exception_ptr failure;
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for num_threads((int)nt) schedule(dynamic, 1) if (nt > 1)
+#endif
+		for (long t = 0; t < (long)count; ++t) {
+			try {
+				task((size_t)t);
+			}
+			catch (...) {
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp critical (lattice_reduction)
+#endif
+				failure = std::current_exception();
+			}
+		}
+		if (failure) std::rethrow_exception(failure);
+	}
+
+	template<class Ring>
+	void LatticeReductionDomain<Ring>::start(Workspace & W, Matrix & B, Matrix * U)
+	{
+		W.B = &B;
+		W.U = U;
+		W.m = B.rowdim();
+		W.n = B.coldim();
+		W.G.assign(W.m * W.m, _Z.zero);
+		W.r.assign(W.m * W.m, 0.);
+		W.mu.assign(W.m * W.m, 0.);
+		if (U) {
+			U->resize(W.m, W.m);
+			for (size_t i = 0; i < W.m; ++i)
+				for (size_t j = 0; j < W.m; ++j)
+					U->setEntry(i, j, (i == j) ? _Z.one : _Z.zero);
+		}
+	}
+
+	/* b_k -= sum q_j b_j, the columns shared between the threads when rows are long */
+	template<class Ring>
+	void LatticeReductionDomain<Ring>::combineRows(Workspace & W, size_t k, const Combination & X)
+	{
+		if (X.empty()) return;
+		const size_t n = W.n, strideB = W.B->getStride();
+		Element * B = W.B->getPointer();
+		const size_t nt = (n >= _policy.grain) ? _policy.threads() : 1;
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for num_threads((int)nt) schedule(static) if (nt > 1)
+#endif
+		for (long c = 0; c < (long)n; ++c)
+			for (const auto & x : X)
+				_Z.maxpyin(B[k*strideB + (size_t)c], x.second, B[x.first*strideB + (size_t)c]);
+
+		if (W.U) {
+			const size_t strideU = W.U->getStride();
+			Element * U = W.U->getPointer();
+			for (size_t c = 0; c < W.m; ++c)
+				for (const auto & x : X)
+					_Z.maxpyin(U[k*strideU + c], x.second, U[x.first*strideU + c]);
+		}
+	}
+
+	template<class Ring>
+	void LatticeReductionDomain<Ring>::gramCombine(Workspace & W, size_t k, const Combination & X, size_t lo, size_t hi)
+	{
+		Element q;
+		for (const auto & x : X)
+			gramAxpy(W, k, x.first, _Z.neg(q, x.second), lo, hi);
+	}
+
+	/* The Gram matrix after b_d += q b_s, for the columns lo..hi-1 and the diagonal */
+	template<class Ring>
+	void LatticeReductionDomain<Ring>::gramAxpy(Workspace & W, size_t d, size_t s, const Element & q, size_t lo, size_t hi)
+	{
+		Element old(W.g(d, s)), t;
+		for (size_t l = lo; l < hi; ++l) {
+			if (l == d) continue;
+			_Z.axpyin(W.g(d, l), q, W.g(s, l));
+			_Z.assign(W.g(l, d), W.g(d, l));
+		}
+		// |b_d + q b_s|^2 = |b_d|^2 + q (<b_d, b_s> + <b_d + q b_s, b_s>)
+		_Z.add(t, old, W.g(d, s));
+		_Z.axpyin(W.g(d, d), q, t);
+	}
+
+	template<class Ring>
+	void LatticeReductionDomain<Ring>::addRow(Workspace & W, size_t d, size_t s, const Element & q, size_t lo, size_t hi)
+	{
+		if (_Z.isZero(q)) return;
+		for (size_t c = 0; c < W.n; ++c)
+			_Z.axpyin(W.B->refEntry(d, c), q, W.B->getEntry(s, c));
+		if (W.U)
+			for (size_t c = 0; c < W.m; ++c)
+				_Z.axpyin(W.U->refEntry(d, c), q, W.U->getEntry(s, c));
+		gramAxpy(W, d, s, q, lo, hi);
+	}
+
+	template<class Ring>
+	void LatticeReductionDomain<Ring>::swapRows(Workspace & W, size_t i, size_t j, size_t lo, size_t hi)
+	{
+		for (size_t c = 0; c < W.n; ++c)
+			std::swap(W.B->refEntry(i, c), W.B->refEntry(j, c));
+		if (W.U)
+			for (size_t c = 0; c < W.m; ++c)
+				std::swap(W.U->refEntry(i, c), W.U->refEntry(j, c));
+		for (size_t l = lo; l < hi; ++l) {
+			if (l == i || l == j) continue;
+			std::swap(W.g(i, l), W.g(j, l));
+			_Z.assign(W.g(l, i), W.g(i, l));
+			_Z.assign(W.g(l, j), W.g(j, l));
+		}
+		std::swap(W.g(i, i), W.g(j, j));
+	}
+
+	template<class Ring>
+	void LatticeReductionDomain<Ring>::negateRow(Workspace & W, size_t i, size_t lo, size_t hi)
+	{
+		for (size_t c = 0; c < W.n; ++c)
+			_Z.negin(W.B->refEntry(i, c));
+		if (W.U)
+			for (size_t c = 0; c < W.m; ++c)
+				_Z.negin(W.U->refEntry(i, c));
+		for (size_t l = lo; l < hi; ++l) {
+			if (l == i) continue;
+			_Z.negin(W.g(i, l));
+			_Z.assign(W.g(l, i), W.g(i, l));
+		}
+	}
+
+	/* Gram matrix entries of the rows ilo..ihi-1 against jlo..jhi-1, j <= i on a diagonal block */
+	template<class Ring>
+	void LatticeReductionDomain<Ring>::gram(Workspace & W, size_t ilo, size_t ihi, size_t jlo, size_t jhi)
+	{
+		const Matrix & B = *W.B;
+		parallelTasks(ihi - ilo, [&](size_t t) {
+			const size_t i = ilo + t;
+			const size_t last = (ilo == jlo) ? i + 1 : jhi;
+			for (size_t j = jlo; j < last; ++j) {
+				Element & e = W.g(i, j);
+				_Z.assign(e, _Z.zero);
+				for (size_t c = 0; c < W.n; ++c)
+					_Z.axpyin(e, B.getEntry(i, c), B.getEntry(j, c));
+				_Z.assign(W.g(j, i), e);
+			}
+		});
+	}
+
+	/* Row i of r and mu against the rows lo..i-1, false if it does not fit in doubles */
+	template<class Ring>
+	bool LatticeReductionDomain<Ring>::choleskyRow(Workspace & W, size_t i, size_t lo)
+	{
+		for (size_t j = lo; j < i; ++j) {
+			double v;
+			_Z.convert(v, W.g(i, j));
+			for (size_t l = lo; l < j; ++l)
+				v -= W.mm(j, l) * W.rr(i, l);
+			W.rr(i, j) = v;
+			W.mm(i, j) = v / W.rr(j, j);
+			if (! std::isfinite(W.mm(i, j))) return false;
+		}
+		return true;
+	}
+
+	template<class Ring>
+	bool LatticeReductionDomain<Ring>::gramSchmidt(Workspace & W, size_t lo, size_t hi)
+	{
+		for (size_t i = lo; i < hi; ++i) {
+			if (! choleskyRow(W, i, lo)) return false;
+			double s;
+			_Z.convert(s, W.g(i, i));
+			for (size_t j = lo; j < i; ++j)
+				s -= W.mm(i, j) * W.rr(i, j);
+			if (! (std::isfinite(s) && (s > 0.))) return false;
+			W.rr(i, i) = s;
+		}
+		return true;
+	}
+
+	/* L² on the rows lo..hi-1, the rows before start being reduced already.
+	 * Returns false when doubles do not carry enough precision.
+	 */
+	template<class Ring>
+	bool LatticeReductionDomain<Ring>::lllFloat(Workspace & W, size_t lo, size_t hi, size_t start)
+	{
+		if (hi - lo < 2) return (hi == lo) || ! _Z.isZero(W.g(lo, lo));
+		if (! gramSchmidt(W, lo, std::max(start, lo + 1))) return false;
+
+		// L² does O(d^2 log |B|) swaps
+		double logNorm = 0.;
+		for (size_t i = lo; i < hi; ++i) {
+			double v;
+			_Z.convert(v, W.g(i, i));
+			if (! std::isfinite(v)) return false;
+			if (v > 1.) logNorm = std::max(logNorm, std::log2(v) / 2.);
+		}
+		const size_t d = hi - lo;
+		size_t budget = 4 * d * d * ((size_t)logNorm + 64);
+
+		std::vector<double> s(d + 1), mk(d);
+		Combination X;
+		Element q;
+		size_t k = std::max(start, lo + 1);
+		while (k < hi) {
+			if (budget-- == 0) return false;
+
+			// lazy size reduction of b_k, until its Gram–Schmidt coefficients are below eta
+			for (size_t it = 0; ; ++it) {
+				if (! choleskyRow(W, k, lo)) return false;
+				bool reduced = true;
+				for (size_t j = lo; reduced && j < k; ++j)
+					reduced = (std::fabs(W.mm(k, j)) <= _eta);
+				if (reduced) break;
+				if (it > 2 * d + 16) return false;
+
+				X.clear();
+				for (size_t j = lo; j < k; ++j) mk[j - lo] = W.mm(k, j);
+				for (size_t j = k; j-- > lo; ) {
+					const double x = std::round(mk[j - lo]);
+					if (x == 0.) continue;
+					X.emplace_back(j, _Z.init(q, x));
+					for (size_t l = lo; l < j; ++l) mk[l - lo] -= x * W.mm(j, l);
+				}
+				combineRows(W, k, X);
+				gramCombine(W, k, X, lo, hi);
+			}
+
+			// s[j] = |b_k projected orthogonally to b_lo..b_{j-1}|^2
+			_Z.convert(s[0], W.g(k, k));
+			if (! std::isfinite(s[0])) return false;
+			for (size_t j = lo; j < k; ++j)
+				s[j - lo + 1] = s[j - lo] - W.mm(k, j) * W.rr(k, j);
+
+			if (_delta * W.rr(k - 1, k - 1) <= s[k - 1 - lo]) {
+				if (! (s[k - lo] > 0.)) return false;
+				W.rr(k, k) = s[k - lo];
+				++k;
+			}
+			else {
+				swapRows(W, k - 1, k, lo, hi);
+				if (--k == lo) {
+					_Z.convert(W.rr(lo, lo), W.g(lo, lo));
+					k = lo + 1;
+				}
+			}
+		}
+		return true;
+	}
+
+	/* Integral LLL of Cohen, Algorithm 2.6.7, on the rows lo..hi-1 */
+	template<class Ring>
+	void LatticeReductionDomain<Ring>::lllExact(Workspace & W, size_t lo, size_t hi)
+	{
+		++_fallbacks;
+		const size_t n = hi - lo;
+		if (n == 0) return;
+
+		// d[i+1] = det of the Gram matrix of b_0..b_i, lambda(k,j) = d[j+1] mu(k,j)
+		std::vector<Element> d(n + 1, _Z.zero), lambda(n * n, _Z.zero);
+		auto lam = [&](size_t i, size_t j) -> Element & { return lambda[i * n + j]; };
+		_Z.assign(d[0], _Z.one);
+		_Z.assign(d[1], W.g(lo, lo));
+		if (_Z.isZero(d[1])) throw LinboxMathError("lattice reduction: linearly dependent rows");
+
+		// delta as dp / dn
+		Element dn, dp;
+		_Z.init(dn, int64_t(1) << 30);
+		_Z.init(dp, (int64_t)std::floor(_delta * (double)(int64_t(1) << 30)));
+
+		Element q, t, u, l1, l2, Bk;
+		auto reduce = [&](size_t k, size_t l) {
+			// nearest integer to lambda(k,l) / d[l+1]
+			_Z.add(t, lam(k, l), lam(k, l));
+			_Z.abs(u, t);
+			if (_Z.compare(u, d[l + 1]) <= 0) return;
+			_Z.addin(t, d[l + 1]);
+			_Z.add(u, d[l + 1], d[l + 1]);
+			_Z.div(q, t, u);
+			_Z.mul(l1, q, u);
+			if ((_Z.compare(t, _Z.zero) < 0) && ! _Z.areEqual(l1, t)) _Z.subin(q, _Z.one);
+
+			addRow(W, lo + k, lo + l, _Z.neg(t, q), lo, hi);
+			_Z.maxpyin(lam(k, l), q, d[l + 1]);
+			for (size_t i = 0; i < l; ++i)
+				_Z.maxpyin(lam(k, i), q, lam(l, i));
+		};
+
+		size_t k = 1, kmax = 0;
+		auto swap = [&](size_t k) {
+			swapRows(W, lo + k, lo + k - 1, lo, hi);
+			for (size_t j = 0; j + 1 < k; ++j) std::swap(lam(k, j), lam(k - 1, j));
+			const Element L(lam(k, k - 1));
+			// Bk = (d[k-1] d[k+1] + L^2) / d[k]
+			_Z.mul(Bk, d[k - 1], d[k + 1]);
+			_Z.axpyin(Bk, L, L);
+			_Z.divin(Bk, d[k]);
+			for (size_t i = k + 1; i <= kmax; ++i) {
+				_Z.assign(t, lam(i, k));
+				_Z.mul(u, d[k + 1], lam(i, k - 1));
+				_Z.maxpyin(u, L, t);
+				_Z.div(lam(i, k), u, d[k]);
+				_Z.mul(u, Bk, t);
+				_Z.axpyin(u, L, lam(i, k));
+				_Z.div(lam(i, k - 1), u, d[k + 1]);
+			}
+			_Z.assign(d[k], Bk);
+		};
+
+		while (k < n) {
+			if (k > kmax) {
+				// incremental Gram–Schmidt of b_k
+				kmax = k;
+				for (size_t j = 0; j <= k; ++j) {
+					_Z.assign(u, W.g(lo + k, lo + j));
+					for (size_t i = 0; i < j; ++i) {
+						_Z.mulin(u, d[i + 1]);
+						_Z.maxpyin(u, lam(k, i), lam(j, i));
+						_Z.divin(u, d[i]);
+					}
+					if (j < k)
+						_Z.assign(lam(k, j), u);
+					else if (_Z.isZero(u))
+						throw LinboxMathError("lattice reduction: linearly dependent rows");
+					else
+						_Z.assign(d[k + 1], u);
+				}
+			}
+			for (;;) {
+				reduce(k, k - 1);
+				// Lovász condition: dn d[k+1] d[k-1] >= dp d[k]^2 - dn lambda(k,k-1)^2
+				_Z.mul(l1, d[k + 1], d[k - 1]);
+				_Z.mulin(l1, dn);
+				_Z.mul(l2, d[k], d[k]);
+				_Z.mulin(l2, dp);
+				_Z.mul(t, lam(k, k - 1), lam(k, k - 1));
+				_Z.maxpyin(l2, dn, t);
+				if (_Z.compare(l1, l2) >= 0) break;
+				swap(k);
+				if (k > 1) --k;
+			}
+			for (size_t l = k - 1; l-- > 0; )
+				reduce(k, l);
+			++k;
+		}
+	}
+
+	template<class Ring>
+	void LatticeReductionDomain<Ring>::lllRange(Workspace & W, size_t lo, size_t hi, size_t start)
+	{
+		if (! lllFloat(W, lo, hi, start))
+			lllExact(W, lo, hi);
+	}
+
+	/* Size reduce the rows mid..hi-1 against the reduced rows lo..mid-1.
+	 * The rows mid..hi-1 only read the rows lo..mid-1, so they are
+	 * reduced at the same time.
+	 */
+	template<class Ring>
+	void LatticeReductionDomain<Ring>::sizeReduceBlock(Workspace & W, size_t lo, size_t mid, size_t hi)
+	{
+		if (! gramSchmidt(W, lo, mid)) return; // the LLL of the merge will go exact
+
+		const size_t h = mid - lo;
+		parallelTasks(hi - mid, [&](size_t t) {
+			const size_t k = mid + t;
+			std::vector<double> rk(h), mk(h);
+			Combination X;
+			Element q;
+			for (size_t it = 0; it < 2 * h + 16; ++it) {
+				bool finite = true, reduced = true;
+				for (size_t j = lo; j < mid; ++j) {
+					double v;
+					_Z.convert(v, W.g(k, j));
+					for (size_t l = lo; l < j; ++l)
+						v -= W.mm(j, l) * rk[l - lo];
+					rk[j - lo] = v;
+					mk[j - lo] = v / W.rr(j, j);
+					finite = finite && std::isfinite(mk[j - lo]);
+					reduced = reduced && (std::fabs(mk[j - lo]) <= _eta);
+				}
+				if (! finite || reduced) break;
+
+				X.clear();
+				for (size_t j = mid; j-- > lo; ) {
+					const double x = std::round(mk[j - lo]);
+					if (x == 0.) continue;
+					X.emplace_back(j, _Z.init(q, x));
+					for (size_t l = lo; l < j; ++l) mk[l - lo] -= x * W.mm(j, l);
+				}
+				combineRows(W, k, X);
+				gramCombine(W, k, X, lo, mid);
+			}
+		});
+		gram(W, mid, hi, mid, hi);
+	}
+
+	template<class Ring>
+	void LatticeReductionDomain<Ring>::lllSegmented(Workspace & W)
+	{
+		std::vector<std::pair<size_t, size_t> > segments;
+		for (size_t lo = 0; lo < W.m; lo += _segment)
+			segments.emplace_back(lo, std::min(lo + _segment, W.m));
+
+		parallelTasks(segments.size(), [&](size_t s) {
+			const size_t lo = segments[s].first, hi = segments[s].second;
+			gram(W, lo, hi, lo, hi);
+			lllRange(W, lo, hi, lo);
+		});
+
+		while (segments.size() > 1) {
+			const size_t pairs = segments.size() / 2;
+			parallelTasks(pairs, [&](size_t s) {
+				const size_t lo = segments[2*s].first, mid = segments[2*s].second, hi = segments[2*s+1].second;
+				gram(W, mid, hi, lo, mid);
+				sizeReduceBlock(W, lo, mid, hi);
+				lllRange(W, lo, hi, mid);
+			});
+			std::vector<std::pair<size_t, size_t> > merged;
+			for (size_t s = 0; s < pairs; ++s)
+				merged.emplace_back(segments[2*s].first, segments[2*s+1].second);
+			if (segments.size() % 2) merged.push_back(segments.back());
+			segments.swap(merged);
+		}
+	}
+
+	template<class Ring>
+	void LatticeReductionDomain<Ring>::lll(Matrix & B, Matrix * U)
+	{
+		Workspace W;
+		start(W, B, U);
+		lllSegmented(W);
+	}
+
+	/* Schnorr–Euchner enumeration of the projected block k..e-1, for a
+	 * vector shorter than delta |b*_k|.  x gets its coordinates.
+	 */
+	template<class Ring>
+	bool LatticeReductionDomain<Ring>::enumerate(Workspace & W, size_t k, size_t e, std::vector<long> & x)
+	{
+		const size_t d = e - k;
+		std::vector<double> R(d), c(d, 0.), l(d + 1, 0.), y(d, 0.), dy(d, 0.), ddy(d, 0.);
+		for (size_t i = 0; i < d; ++i) R[i] = W.rr(k + i, k + i);
+
+		double A = _delta * R[0];
+		bool found = false;
+		y[0] = 1.;
+		size_t i = 0;
+		for (;;) {
+			const double z = y[i] - c[i];
+			l[i] = l[i + 1] + z * z * R[i];
+			if (l[i] < A) {
+				if (i > 0) {
+					// go down, starting from the nearest integer to the center
+					--i;
+					double ci = 0.;
+					for (size_t j = i + 1; j < d; ++j) ci -= y[j] * W.mm(k + j, k + i);
+					c[i] = ci;
+					y[i] = std::round(ci);
+					dy[i] = ddy[i] = (ci < y[i]) ? -1. : 1.;
+					continue;
+				}
+				x.assign(d, 0);
+				for (size_t j = 0; j < d; ++j) x[j] = (long)y[j];
+				A = l[0];
+				found = true;
+			}
+			else if (++i == d)
+				break;
+			// next candidate at level i, zigzag around the center
+			if (l[i + 1] == 0.)
+				y[i] += 1.;
+			else {
+				y[i] += dy[i];
+				ddy[i] = -ddy[i];
+				dy[i] = ddy[i] - dy[i];
+			}
+		}
+		return found;
+	}
+
+	/* Make sum x_i b_{k+i} the row k, by a unimodular transformation of the rows k..e-1 */
+	template<class Ring>
+	void LatticeReductionDomain<Ring>::insert(Workspace & W, size_t k, size_t e, std::vector<long> & x)
+	{
+		long g = 0;
+		for (long v : x) {
+			long a = std::labs(v);
+			while (a) { long t = g % a; g = a; a = t; }
+		}
+		for (long & v : x) v /= g;
+
+		Element q;
+		for (size_t i = e - k - 1; i > 0; --i)
+			while (x[i] != 0) {
+				// x[i-1] b + x[i] b' = (x[i-1] - t x[i]) b + x[i] (b' + t b)
+				const long t = x[i - 1] / x[i];
+				x[i - 1] -= t * x[i];
+				addRow(W, k + i, k + i - 1, _Z.init(q, (int64_t)t), 0, W.m);
+				std::swap(x[i - 1], x[i]);
+				swapRows(W, k + i - 1, k + i, 0, W.m);
+			}
+		if (x[0] < 0) negateRow(W, k, 0, W.m);
+	}
+
+	template<class Ring>
+	void LatticeReductionDomain<Ring>::bkz(Matrix & B, size_t blockSize, Matrix * U, size_t maxTours)
+	{
+		Workspace W;
+		start(W, B, U);
+		lllSegmented(W);
+		if ((blockSize < 2) || (W.m < 2) || ! gramSchmidt(W, 0, W.m)) return;
+
+		std::vector<long> x;
+		for (size_t tour = 0; tour < maxTours; ++tour) {
+			bool changed = false;
+			for (size_t k = 0; k + 1 < W.m; ++k) {
+				const size_t e = std::min(k + blockSize, W.m);
+				if (! enumerate(W, k, e, x)) continue;
+				changed = true;
+				insert(W, k, e, x);
+				lllRange(W, 0, W.m, k);
+				if (! gramSchmidt(W, 0, W.m)) return;
+			}
+			if (! changed) break;
+		}
+	}
+
+} // LinBox
+
+#endif // __LINBOX_algorithms_lattice_reduction_INL
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
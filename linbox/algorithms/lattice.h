@@ -29,16 +29,13 @@
  * @ingroup algorithms
  * @ingroup lattice
  *
- * This is an interface to NTL/FPLLL.
- *
- * @todo Create a BlasMatrix<NTL_ZZ> that is just like a mat_ZZ !
- * @todo Create a BlasMatrix<FPLLL_ZZ> that is just like a IntMatrix !
- * @todo This will avoid copy back/forth a BlasMatrix<Givaro::ZRing<Integer> >
+ * This is an interface to NTL/FPLLL, and to LatticeReductionDomain.
+ * The NTL and FPLLL methods copy the matrix back and forth,
+ * latticeLinBox_LLL and latticeLinBox_BKZ reduce it in place.
  */
 
-#if !defined(__LINBOX_HAVE_FPLLL) && !defined(__LINBOX_HAVE_NTL)
-#error "you need either FPLLL or NTL here"
-#endif
+#include "linbox/util/parallel-policy.h"
+#include "linbox/algorithms/lattice-reduction.h"
 
 
 #ifdef __LINBOX_HAVE_NTL
@@ -257,6 +254,86 @@ namespace LinBox
 		};
 #endif // __LINBOX_HAVE_FPLLL
 
+		/*! LinBox LLL.
+		 * LatticeReductionDomain on the BlasMatrix itself,
+		 * available without NTL nor FPLLL.
+		 */
+		struct latticeLinBox_LLL : public virtual genericMethod {
+		private :
+			double _delta ;
+			double   _eta ;
+			size_t _segment ;
+			ParallelPolicy _policy ;
+		public :
+			latticeLinBox_LLL() :
+				_delta(0.99),
+				_eta(0.51),
+				_segment(32)
+			{}
+			void setDelta(const double & delta)
+			{
+				_delta = delta ;
+			}
+			void setEta(const double & eta)
+			{
+				_eta = eta ;
+			}
+			//! rows reduced together before the segments are merged
+			void setSegment(size_t segment)
+			{
+				_segment = segment ;
+			}
+			void setPolicy(const ParallelPolicy & policy)
+			{
+				_policy = policy ;
+			}
+			double getDelta() const
+			{
+				return _delta ;
+			}
+			double getEta() const
+			{
+				return _eta ;
+			}
+			size_t getSegment() const
+			{
+				return _segment ;
+			}
+			const ParallelPolicy & getPolicy() const
+			{
+				return _policy ;
+			}
+		};
+
+		/*! LinBox BKZ.
+		 * LLL, then BKZ tours with blocks of getBlockSize() rows.
+		 */
+		struct latticeLinBox_BKZ : public latticeLinBox_LLL {
+		private :
+			size_t _bsize ;
+			size_t _tours ;
+		public :
+			latticeLinBox_BKZ() :
+				_bsize(10),
+				_tours(16)
+			{}
+			void setBlockSize(size_t bsize)
+			{
+				_bsize = bsize ;
+			}
+			void setMaxTours(size_t tours)
+			{
+				_tours = tours ;
+			}
+			size_t getBlockSize() const
+			{
+				return _bsize ;
+			}
+			size_t getMaxTours() const
+			{
+				return _tours ;
+			}
+		};
 
 	};
 
@@ -265,10 +342,12 @@ namespace LinBox
 #include "linbox/algorithms/lattice.inl"
 
 
-#ifdef __LINBOX_HAVE_FPLLL
+#if defined(__LINBOX_HAVE_FPLLL)
 #define defaultLllMeth latticeMethod::latticeFPLLL
-#else
+#elif defined(__LINBOX_HAVE_NTL)
 #define defaultLllMeth latticeMethod::latticeNTL_LLL
+#else
+#define defaultLllMeth latticeMethod::latticeLinBox_LLL
 #endif
 
 namespace LinBox
@@ -383,6 +383,30 @@ namespace LinBox
 
 }
 
+/* LatticeReductionDomain */
+namespace LinBox
+{
+	template<class Ring, bool withU>
+	void
+	lllReduceInBase(BlasMatrix<Ring>                      & H,
+			BlasMatrix<Ring>                      & UU,
+			const latticeMethod::latticeLinBox_LLL & meth)
+	{
+		LatticeReductionDomain<Ring> LRD(H.field(), meth.getDelta(), meth.getEta(), meth.getSegment(), meth.getPolicy());
+		LRD.lll(H, withU ? &UU : nullptr);
+	}
+
+	template<class Ring, bool withU>
+	void
+	lllReduceInBase(BlasMatrix<Ring>                      & H,
+			BlasMatrix<Ring>                      & UU,
+			const latticeMethod::latticeLinBox_BKZ & meth)
+	{
+		LatticeReductionDomain<Ring> LRD(H.field(), meth.getDelta(), meth.getEta(), meth.getSegment(), meth.getPolicy());
+		LRD.bkz(H, meth.getBlockSize(), withU ? &UU : nullptr, meth.getMaxTours());
+	}
+}
+
 #endif // __LINBOX_algorithms_lattice_INL
 
 // Local Variables:
@@ -35,6 +35,7 @@
 
 #include "linbox/linbox-config.h"
 #include "linbox/util/debug.h"
+#include "linbox/util/counters.h"
 
 #include "linbox/blackbox/apply.h"
 #include "linbox/blackbox/diagonal.h"
@@ -451,6 +452,7 @@ namespace LinBox
 		virtual IVector& nextdigit(IVector& digit, const IVector& residu) const
 		{
 			linbox_check(digit.size()==residu.size());
+			LINBOX_COUNT(DixonSteps, 1);
 #ifdef RSTIMING
 			tGetDigitConvert.start();
 #endif
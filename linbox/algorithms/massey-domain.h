@@ -53,6 +53,7 @@
 #include "linbox/vector/subvector.h"
 #include "linbox/vector/vector-domain.h"
 #include "linbox/util/timer.h"
+#include "linbox/util/counters.h"
 
 namespace LinBox
 {
@@ -244,6 +245,7 @@ namespace LinBox
 
 				if (!(NN % COMMOD))
 					commentator().progress (NN);
+				LINBOX_COUNT(MasseySteps, 1);
 
 				// ====================================================
 				// Next coefficient in the sequence
@@ -346,6 +348,9 @@ namespace LinBox
 #endif // INCLUDE_TIMING
 			}
 
+			if (x >= (long) EARLY_TERM_THRESHOLD)
+				LINBOX_COUNT(MasseyEarlyTerminations, 1);
+
 			commentator().stop ("done", NULL, "masseyd");
 			//		commentator().stop ("Done", "Done", "LinBox::MasseyDomain::massey");
 			return L;
@@ -5,6 +5,7 @@
 
 #include <givaro/extension.h>
 #include <linbox/algorithms/poly-interpolation.h>
+#include <linbox/algorithms/poly-eval-interp.h>
 #include <linbox/solutions/det.h>
 
 namespace LinBox {
@@ -13,7 +14,9 @@ Matrix is a polynomial matrix.
 result is set to its determinant and returned (a polynomial).
 d is the number of evaluation points.
 
-The method is to compute dets at each evaluation point and interpolate.
+The method is to compute dets at each evaluation point and interpolate,
+see PolyMatrixEvalInterp: FFT points when the field has the roots of unity,
+a subproduct tree otherwise.
  (note by bds)
  */
 template <class Field>
@@ -24,8 +27,6 @@ computePolyDet(typename Givaro::Poly1Dom<Field,Givaro::Dense>::Element& result,
 {
 	typedef Givaro::Poly1Dom<Field,Givaro::Dense> PolyDom;
 	typedef typename PolyDom::Element PolyElt;
-	typedef typename Field::Element FieldElt;
-	//typedef MatrixDomain<Field> FieldMatDom;
 	typedef DenseMatrix<Field> FieldMat;
 
 	int n=A.coldim(),m=A.rowdim();
@@ -33,43 +34,32 @@ computePolyDet(typename Givaro::Poly1Dom<Field,Givaro::Dense>::Element& result,
 	PolyDom BR=A.field();
 	Field F(BR.subDomain()); // coeff field
 
-	std::vector<FieldMat> mats;
-	std::vector<FieldElt> pts(d);
-	FieldElt fieldElt;
-	F.assign(fieldElt,F.zero);
-	for (int i=0;i<d;++i) {
-		mats.push_back(FieldMat(F,m,n));
-		F.init(pts[i],int64_t(i));
+	// Coefficient matrices of A, lowest degree first
+	int deg=0;
+	for (int i=0;i<m;++i) {
+		for (int j=0;j<n;++j) {
+			PolyElt p;
+			A.getEntry(p,i,j);
+			if (!BR.isZero(p)) deg=std::max(deg,(int)BR.degree(p).value());
+		}
 	}
-
-	commentator().report(Commentator::LEVEL_IMPORTANT,PROGRESS_REPORT)
-		<< "Initialized mats" << std::endl;
-
-
-	PolyInterpolation<Field,PolyDom> PI(pts,F,BR);
-#pragma omp parallel for shared(mats,A,PI,BR,F)
+	std::vector<FieldMat> coeffs(deg+1,FieldMat(F,m,n));
 	for (int i=0;i<m;++i) {
 		for (int j=0;j<n;++j) {
 			PolyElt p;
 			A.getEntry(p,i,j);
-			std::vector<FieldElt> vals;
-			PI.evaluate(vals,p,BR,F);
-			for (int k=0;k<d;++k) {
-				mats[k].setEntry(i,j,vals[k]);
+			if (BR.isZero(p)) continue;
+			for (int k=0;k<=BR.degree(p).value();++k) {
+				coeffs[k].setEntry(i,j,p[k]);
 			}
 		}
 	}
 
 	commentator().report(Commentator::LEVEL_IMPORTANT,PROGRESS_REPORT)
-		<< "Finished evaluations" << std::endl;
-
-	std::vector<FieldElt> dets(d);
-#pragma omp parallel for shared(dets,mats)
-	for (int k=0;k<d;++k) {
-		det(dets[k],mats[k],Method::Elimination());
-	}
+		<< "Initialized mats" << std::endl;
 
-	PI.interpolate(result,pts,dets,BR,F);
+	PolyMatrixEvalInterp<Field> EI(F);
+	EI.det(result,coeffs,(size_t)(d-1));
 	return result;
 }
 
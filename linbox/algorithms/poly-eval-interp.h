@@ -0,0 +1,558 @@
+/* linbox/algorithms/poly-eval-interp.h
+ * Copyright (C) LinBox
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file algorithms/poly-eval-interp.h
+ * @brief Determinant and rank of a polynomial matrix by evaluation and interpolation.
+ * @ingroup algorithms
+ *
+ * The polynomial matrix is given by its coefficient matrices, lowest
+ * degree first, as the generators of BlockCoppersmithDomain.
+ */
+
+#ifndef __LINBOX_poly_eval_interp_H
+#define __LINBOX_poly_eval_interp_H
+
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include <givaro/givpoly1.h>
+
+#include "linbox/linbox-config.h"
+#include "linbox/integer.h"
+#include "linbox/util/debug.h"
+#include "linbox/util/error.h"
+#include "linbox/util/parallel-policy.h"
+#include "linbox/matrix/dense-matrix.h"
+#include "linbox/matrix/matrixdomain/blas-matrix-domain.h"
+#include "linbox/algorithms/polynomial-matrix/fft.h"
+
+#ifdef __LINBOX_USE_OPENMP
+#include <omp.h>
+#endif
+
+namespace LinBox
+{
+	namespace Protected {
+
+		// Whether FFT<Field> exists, that is whether FFT_base is specialized for Field
+		template <class Field, class = void>
+		struct HasFieldFFT : std::false_type {};
+
+		template <class Field>
+		struct HasFieldFFT<Field, decltype(void(sizeof(FFT_base<Field>)))> : std::true_type {};
+
+		/* Points s w^k, 0 <= k < N, for w of order N = 2^l: one FFT
+		 * evaluates a polynomial at all of them, one inverse FFT
+		 * interpolates.  The k-th point is s w^bitreverse(k), the order in
+		 * which FFT_direct writes the values.
+		 */
+		template <class Field, bool = HasFieldFFT<Field>::value>
+		class FFTPoints {
+		public:
+			typedef typename Field::Element Element;
+			typedef std::vector<Element> Buffer;
+
+			FFTPoints (const Field&) {}
+			bool setup (size_t, const Element&) { return false; }
+			size_t size () const { return 0; }
+			Buffer buffer () const { return Buffer(); }
+			void points (std::vector<Element>&) const {}
+			template <class Coeff>
+			void evaluate (Buffer&, const Coeff&, size_t) const {}
+			void interpolate (Buffer&) const {}
+		};
+
+		template <class Field>
+		class FFTPoints<Field, true> {
+		public:
+			typedef typename Field::Element Element;
+			typedef typename Simd<Element>::aligned_vector Buffer;
+			typedef FFT<Field> Transform;
+
+			FFTPoints (const Field& F) : _field(&F), _size(0) {}
+
+			/// At least count points shifted by s, false if the field lacks the roots of unity
+			bool setup (size_t count, const Element& s)
+			{
+				const Field& F = *_field;
+				size_t lpts = 1, pts = 2;
+				while (pts < std::max<size_t>(count, 4 * Simd<Element>::vect_size)) { pts <<= 1; ++lpts; }
+				integer p;
+				F.characteristic(p);
+				if (((p - 1) % integer(pts)) != 0) return false;
+
+				if (pts != _size) {
+					_fwd = std::make_shared<const Transform>(F, lpts);
+					_inv = std::make_shared<const Transform>(F, lpts, _fwd->invroot());
+					_size = pts;
+					_lsize = lpts;
+				}
+
+				// s^k and 1/(N s^k), for the twist and the untwist
+				_shift = s;
+				_pow.resize(pts);
+				_invPow.resize(pts);
+				Element u;
+				F.init(u, (uint64_t)pts);
+				F.invin(u);
+				Element sinv;
+				F.inv(sinv, s);
+				F.assign(_pow[0], F.one);
+				F.assign(_invPow[0], u);
+				for (size_t k = 1; k < pts; ++k) {
+					F.mul(_pow[k], _pow[k-1], s);
+					F.mul(_invPow[k], _invPow[k-1], sinv);
+				}
+				return true;
+			}
+
+			size_t size () const { return _size; }
+
+			Buffer buffer () const { return Buffer(_size, _field->zero); }
+
+			void points (std::vector<Element>& pts) const
+			{
+				const Field& F = *_field;
+				std::vector<Element> w(_size);
+				F.assign(w[0], F.one);
+				for (size_t k = 1; k < _size; ++k)
+					F.mul(w[k], w[k-1], _fwd->root());
+				pts.resize(_size);
+				for (size_t k = 0; k < _size; ++k)
+					F.mul(pts[k], _shift, w[FFT_utils::bitreverse(k, _lsize)]);
+			}
+
+			/// Values at the points of sum_t c(t) x^t, t < len, folded modulo x^N - s^N
+			template <class Coeff>
+			void evaluate (Buffer& buf, const Coeff& c, size_t len) const
+			{
+				const Field& F = *_field;
+				std::fill(buf.begin(), buf.end(), F.zero);
+				Element sN, wrap;
+				F.mul(sN, _pow[_size - 1], _shift);
+				F.assign(wrap, F.one);
+				for (size_t t = 0; t < len; ++t) {
+					const size_t k = t & (_size - 1);
+					if (k == 0 && t > 0) F.mulin(wrap, sN);
+					Element e;
+					F.mul(e, c(t), _pow[k]);
+					F.axpyin(buf[k], e, wrap);
+				}
+				_fwd->FFT_direct(buf.data());
+			}
+
+			/// Coefficients, lowest first, of the polynomial of degree < N with values buf
+			void interpolate (Buffer& buf) const
+			{
+				_inv->FFT_inverse(buf.data());
+				for (size_t k = 0; k < _size; ++k)
+					_field->mulin(buf[k], _invPow[k]);
+			}
+
+		protected:
+			const Field* _field;
+			size_t _size, _lsize;
+			Element _shift;
+			std::vector<Element> _pow, _invPow;
+			std::shared_ptr<const Transform> _fwd, _inv;
+		};
+
+		/* Subproduct tree of the x - a_k: remainders down the tree for the
+		 * multipoint evaluation, linear combinations up the tree for the
+		 * interpolation.  A node without sibling goes up unchanged, so that
+		 * any number of points works.
+		 */
+		template <class Field>
+		class SubproductTree {
+		public:
+			typedef typename Field::Element Element;
+			typedef Givaro::Poly1Dom<Field, Givaro::Dense> PolyDom;
+			typedef typename PolyDom::Element Polynomial;
+
+			SubproductTree (const PolyDom& PD, const std::vector<Element>& pts) : _points(pts)
+			{
+				_tree.clear();
+				_tree.emplace_back(pts.size());
+				for (size_t k = 0; k < pts.size(); ++k) {
+					PD.assign(_tree[0][k], PD.one);
+					PD.shiftin(_tree[0][k], 1);
+					PD.subin(_tree[0][k], pts[k]);
+				}
+				while (_tree.back().size() > 1) {
+					const std::vector<Polynomial>& below = _tree.back();
+					std::vector<Polynomial> level((below.size() + 1) / 2);
+					for (size_t k = 0; k + 1 < below.size(); k += 2)
+						PD.mul(level[k/2], below[k], below[k+1]);
+					if (below.size() & 1)
+						PD.assign(level.back(), below.back());
+					_tree.push_back(std::move(level));
+				}
+
+				// 1 / M'(a_k), the weights of the interpolation
+				Polynomial dM;
+				PD.diff(dM, _tree.back()[0]);
+				evaluate(PD, _weights, dM);
+				for (auto& w : _weights)
+					PD.subDomain().invin(w);
+			}
+
+			size_t size () const { return _points.size(); }
+
+			void evaluate (const PolyDom& PD, std::vector<Element>& values, const Polynomial& p) const
+			{
+				std::vector<Polynomial> rem(1), next;
+				PD.mod(rem[0], p, _tree.back()[0]);
+				for (size_t l = _tree.size() - 1; l-- > 0;) {
+					const std::vector<Polynomial>& level = _tree[l];
+					next.resize(level.size());
+					for (size_t k = 0; k < level.size(); ++k)
+						PD.mod(next[k], rem[k/2], level[k]);
+					rem.swap(next);
+				}
+				values.resize(size());
+				for (size_t k = 0; k < size(); ++k)
+					PD.getEntry(values[k], Givaro::Degree(0), rem[k]);
+			}
+
+			void interpolate (const PolyDom& PD, Polynomial& p, const std::vector<Element>& values) const
+			{
+				linbox_check(values.size() == size());
+				std::vector<Polynomial> comb(size()), next;
+				for (size_t k = 0; k < size(); ++k) {
+					Element c;
+					PD.subDomain().mul(c, values[k], _weights[k]);
+					PD.assign(comb[k], c);
+				}
+				Polynomial q;
+				for (size_t l = 0; l + 1 < _tree.size(); ++l) {
+					const std::vector<Polynomial>& level = _tree[l];
+					next.resize((level.size() + 1) / 2);
+					for (size_t k = 0; k + 1 < level.size(); k += 2) {
+						PD.mul(next[k/2], comb[k], level[k+1]);
+						PD.mul(q, comb[k+1], level[k]);
+						PD.addin(next[k/2], q);
+					}
+					if (level.size() & 1)
+						PD.assign(next.back(), comb.back());
+					comb.swap(next);
+				}
+				PD.assign(p, comb[0]);
+			}
+
+		protected:
+			std::vector<Element> _points, _weights;
+			std::vector<std::vector<Polynomial> > _tree;
+		};
+	}
+
+	/** \brief Evaluation and interpolation engine for polynomial matrices.
+	 *
+	 * All the entries are evaluated at all the points at once: by one FFT
+	 * per entry when the field has the roots of unity (FFT<Field> exists and
+	 * 2^l divides p-1), by a subproduct tree otherwise.  The determinants or
+	 * ranks at the points are computed by BlasMatrixDomain, one point per
+	 * thread of the parallel policy, and the determinant is interpolated
+	 * back by the inverse FFT or the subproduct tree.
+	 *
+	 * The coefficient matrices Coeff only need rowdim, coldim and getEntry.
+	 */
+	template <class _Field>
+	class PolyMatrixEvalInterp {
+	public:
+		typedef _Field Field;
+		typedef typename Field::Element Element;
+		typedef Givaro::Poly1Dom<Field, Givaro::Dense> PolyDom;
+		typedef typename PolyDom::Element Polynomial;
+		typedef BlasMatrix<Field> Matrix;
+
+		PolyMatrixEvalInterp (const Field& F, const ParallelPolicy& policy = ParallelPolicy::allThreads()) :
+			_field(&F), _pd(F, "x"), _policy(policy), _fft(F), _usesFFT(false)
+		{}
+
+		const Field& field () const { return *_field; }
+		const PolyDom& polynomialDomain () const { return _pd; }
+
+		/// Whether the current points are the FFT ones
+		bool usesFFT () const { return _usesFFT; }
+
+		/// The current evaluation points
+		const std::vector<Element>& points () const { return _points; }
+
+		/** \brief At least count evaluation points, shifted by s.
+		 *
+		 * The points are s times roots of unity when the field has them,
+		 * s, s+1, ..., s+count-1 otherwise.
+		 * @throw LinboxError if count is not less than the characteristic.
+		 */
+		void setup (size_t count, const Element& s)
+		{
+			checkPointCount(count);
+			_usesFFT = (! field().isZero(s)) && _fft.setup(count, s);
+			if (_usesFFT) {
+				_fft.points(_points);
+				_tree.reset();
+				return;
+			}
+			std::vector<Element> pts(count);
+			for (size_t k = 0; k < count; ++k) {
+				field().init(pts[k], (int64_t)k);
+				field().addin(pts[k], s);
+			}
+			setPoints(pts);
+		}
+
+		void setup (size_t count) { setup(count, field().one); }
+
+		/// Given (pairwise distinct) evaluation points, with the subproduct tree
+		void setPoints (const std::vector<Element>& pts)
+		{
+			_usesFFT = false;
+			_points = pts;
+			_tree = std::make_shared<const Protected::SubproductTree<Field> >(_pd, _points);
+		}
+
+		/// values[k] = P(points()[k]), for P = sum_t P[t] x^t
+		template <class Coeff>
+		void evaluate (std::vector<Matrix>& values, const std::vector<Coeff>& P) const
+		{
+			linbox_check(! P.empty());
+			const size_t m = P[0].rowdim(), n = P[0].coldim(), len = P.size(), npts = _points.size();
+			values.assign(npts, Matrix(field(), m, n));
+
+			const long entries = (long)(m * n);
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel num_threads((int)_policy.threads()) if(_policy.isParallel())
+#endif
+			{
+				PolyDom PD(_pd);
+				typename Protected::FFTPoints<Field>::Buffer buf = _fft.buffer();
+				Polynomial p;
+				std::vector<Element> vals;
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp for schedule(static)
+#endif
+				for (long e = 0; e < entries; ++e) {
+					const size_t i = (size_t)e / n, j = (size_t)e % n;
+					if (_usesFFT) {
+						_fft.evaluate(buf, [&P, i, j](size_t t) -> Element { return P[t].getEntry(i, j); }, len);
+						for (size_t k = 0; k < npts; ++k)
+							values[k].setEntry(i, j, buf[k]);
+						continue;
+					}
+					PD.init(p, Givaro::Degree((long)len - 1));
+					for (size_t t = 0; t < len; ++t)
+						PD.setEntry(p, P[t].getEntry(i, j), Givaro::Degree((long)t));
+					PD.setdegree(p);
+					_tree->evaluate(PD, vals, p);
+					for (size_t k = 0; k < npts; ++k)
+						values[k].setEntry(i, j, vals[k]);
+				}
+			}
+		}
+
+		/// The polynomial of degree < points().size() taking the values at the points
+		Polynomial& interpolate (Polynomial& p, const std::vector<Element>& values) const
+		{
+			linbox_check(values.size() == _points.size());
+			if (! _usesFFT) {
+				_tree->interpolate(_pd, p, values);
+				return p;
+			}
+			typename Protected::FFTPoints<Field>::Buffer buf(values.begin(), values.end());
+			_fft.interpolate(buf);
+			_pd.init(p, Givaro::Degree((long)buf.size() - 1));
+			for (size_t k = 0; k < buf.size(); ++k)
+				_pd.setEntry(p, buf[k], Givaro::Degree((long)k));
+			return _pd.setdegree(p);
+		}
+
+		/// The determinants of P at the current points, interpolated
+		template <class Coeff>
+		Polynomial& detAtPoints (Polynomial& d, const std::vector<Coeff>& P) const
+		{
+			std::vector<Matrix> values;
+			evaluate(values, P);
+			std::vector<Element> dets(values.size());
+			forEachPoint(values, [&dets](BlasMatrixDomain<Field>& BMD, Matrix& M, size_t k) {
+				dets[k] = BMD.detInPlace(M);
+			});
+			return interpolate(d, dets);
+		}
+
+		/** \brief Determinant of the square polynomial matrix P, of degree at most degreeBound.
+		 *
+		 * degreeBound + 1 points are used, as given by setup.
+		 */
+		template <class Coeff>
+		Polynomial& det (Polynomial& d, const std::vector<Coeff>& P, size_t degreeBound)
+		{
+			linbox_check(! P.empty() && P[0].rowdim() == P[0].coldim());
+			setup(degreeBound + 1);
+			return detAtPoints(d, P);
+		}
+
+		/** \brief Determinant of the square polynomial matrix P, with early termination.
+		 *
+		 * The number of points doubles until the interpolated determinant
+		 * agrees with the determinant at a random point outside the points,
+		 * or until it reaches the sum of the row degrees.  Each round uses a
+		 * random shift of the points, so that no fixed polynomial fools the
+		 * check (Monte Carlo).
+		 * @throw LinboxError if the field has too few elements for the bound.
+		 */
+		template <class Coeff>
+		Polynomial& det (Polynomial& d, const std::vector<Coeff>& P)
+		{
+			linbox_check(! P.empty() && P[0].rowdim() == P[0].coldim());
+			const size_t bound = rowDegreeSum(P);
+			checkPointCount(bound + 1);
+			typename Field::RandIter gen(field());
+
+			for (size_t count = std::min<size_t>(16, bound + 1); ; count = std::min(2 * count, bound + 1)) {
+				Element s, r, v, w;
+				do gen.random(s); while (field().isZero(s));
+				setup(count, s);
+				detAtPoints(d, P);
+				if (_points.size() > bound)
+					return d;
+
+				do gen.random(r); while (std::find(_points.begin(), _points.end(), r) != _points.end());
+				_pd.eval(v, d, r);
+				if (field().areEqual(v, detAt(P, r)))
+					return d;
+			}
+		}
+
+		/** \brief Rank of P over the rational functions.
+		 *
+		 * The largest rank at trials random points: it is the rank of P
+		 * unless all the points are roots of its nonzero maximal minors.
+		 */
+		template <class Coeff>
+		size_t rank (const std::vector<Coeff>& P, size_t trials = 2)
+		{
+			typename Field::RandIter gen(field());
+			std::vector<Element> pts(trials);
+			for (auto& a : pts) gen.random(a);
+			std::sort(pts.begin(), pts.end());
+			pts.erase(std::unique(pts.begin(), pts.end()), pts.end());
+			setPoints(pts);
+
+			std::vector<Matrix> values;
+			evaluate(values, P);
+			std::vector<size_t> ranks(values.size());
+			forEachPoint(values, [&ranks](BlasMatrixDomain<Field>& BMD, Matrix& M, size_t k) {
+				ranks[k] = BMD.rankInPlace(M);
+			});
+			return *std::max_element(ranks.begin(), ranks.end());
+		}
+
+		/// Sum over the rows of the largest degree of their entries, a bound on the degree of the determinant
+		template <class Coeff>
+		static size_t rowDegreeSum (const std::vector<Coeff>& P)
+		{
+			const size_t m = P.empty() ? 0 : P[0].rowdim();
+			size_t sum = 0;
+			for (size_t i = 0; i < m; ++i) {
+				size_t t = P.size();
+				while (t > 0 && rowIsZero(P[t-1], i)) --t;
+				sum += (t > 0) ? t - 1 : 0;
+			}
+			return sum;
+		}
+
+	protected:
+		// Points s, s+1, ... are distinct, and leave one out for the random check, below the characteristic
+		void checkPointCount (size_t count) const
+		{
+			integer p;
+			field().characteristic(p);
+			if (p != 0 && integer(count) >= p)
+				throw LinboxError("PolyMatrixEvalInterp: the field has too few elements for the evaluation points");
+		}
+
+		template <class Coeff>
+		static bool rowIsZero (const Coeff& C, size_t i)
+		{
+			for (size_t j = 0; j < C.coldim(); ++j)
+				if (! C.field().isZero(C.getEntry(i, j))) return false;
+			return true;
+		}
+
+		// det P(r), by Horner
+		template <class Coeff>
+		Element detAt (const std::vector<Coeff>& P, const Element& r) const
+		{
+			const size_t m = P[0].rowdim(), n = P[0].coldim();
+			Matrix M(field(), m, n);
+			for (size_t t = P.size(); t-- > 0;)
+				for (size_t i = 0; i < m; ++i)
+					for (size_t j = 0; j < n; ++j) {
+						Element e;
+						field().mul(e, M.getEntry(i, j), r);
+						field().addin(e, P[t].getEntry(i, j));
+						M.setEntry(i, j, e);
+					}
+			BlasMatrixDomain<Field> BMD(field());
+			return BMD.detInPlace(M);
+		}
+
+		// body(BMD, values[k], k) for each point, distributed over the threads
+		template <class Body>
+		void forEachPoint (std::vector<Matrix>& values, const Body& body) const
+		{
+			const long npts = (long)values.size();
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel num_threads((int)_policy.threads()) if(_policy.isParallel())
+#endif
+			{
+				BlasMatrixDomain<Field> BMD(field());
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+				for (long k = 0; k < npts; ++k)
+					body(BMD, values[k], (size_t)k);
+			}
+		}
+
+		const Field* _field;
+		PolyDom _pd;
+		ParallelPolicy _policy;
+		Protected::FFTPoints<Field> _fft;
+		bool _usesFFT;
+		std::vector<Element> _points;
+		std::shared_ptr<const Protected::SubproductTree<Field> > _tree;
+	};
+
+}
+
+#endif // __LINBOX_poly_eval_interp_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
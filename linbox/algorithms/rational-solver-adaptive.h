@@ -33,6 +33,7 @@
 #include "linbox/ring/modular.h"
 #include "linbox/algorithms/rational-solver.h"
 #include "linbox/randiter/random-prime.h"
+#include <vector>
 
 namespace LinBox
 {
@@ -94,6 +95,14 @@ namespace LinBox
 		static SolverReturnStatus solveNonsingular(OutVector& num, typename IRing::Element& den, const BlasMatrix<IRing>& M, const InVector& b) {
 			return RationalSolverAdaptiveClass<IRing,OutVector,InVector>::solveNonsingular(num, den, M, b);
 		}
+
+		// the columns of B together, from one inverse of M mod p
+		template<class IRing, class IMatrix>
+		static SolverReturnStatus solveNonsingularBlock(std::vector<BlasVector<IRing> >& num, std::vector<typename IRing::Element>& den,
+								const IMatrix& M, const BlasMatrix<IRing>& B) {
+			DixonSolver<IRing, Givaro::Modular<double>, PrimeIterator<IteratorCategories::HeuristicTag>, Method::DenseElimination> solver(M.field());
+			return solver. solveNonsingularBlock(num, den, M, B);
+		}
 	};
 
 }
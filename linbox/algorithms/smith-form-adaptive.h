@@ -31,8 +31,10 @@
  */
 
 #include <vector>
+#include <ostream>
 #include "linbox/integer.h"
 #include "linbox/matrix/dense-matrix.h"
+#include "linbox/util/parallel-policy.h"
 
 namespace LinBox
 {
@@ -49,32 +51,72 @@ namespace LinBox
 		 */
 		template <class Matrix>
 		static void compute_local_long (BlasVector<Givaro::ZRing<Integer> >& s, const Matrix& A, int64_t p, int64_t e);
+		template <class Matrix>
+		static void compute_local_long (BlasVector<Givaro::ZRing<Integer> >& s, const Matrix& A, int64_t p, int64_t e,
+						std::ostream& report);
 
 		/* Compute the local smith form at prime p, when modular (p^e) doesnot fit in int64_t
 		 * Should work with SparseMatrix and BlasMatrix
 		 */
 		template <class Matrix>
 		static void compute_local_big (BlasVector<Givaro::ZRing<Integer> >& s, const Matrix& A, int64_t p, int64_t e);
+		template <class Matrix>
+		static void compute_local_big (BlasVector<Givaro::ZRing<Integer> >& s, const Matrix& A, int64_t p, int64_t e,
+					       std::ostream& report);
 
 		/* Compute the local smith form at prime p
-		*/
+		 * The overloads with a report stream do not use the commentator,
+		 * they are the ones to call from concurrent tasks.
+		 */
 		template <class Matrix>
 		static void compute_local (BlasVector<Givaro::ZRing<Integer> >& s, const Matrix& A, int64_t p, int64_t e);
+		template <class Matrix>
+		static void compute_local (BlasVector<Givaro::ZRing<Integer> >& s, const Matrix& A, int64_t p, int64_t e,
+					   std::ostream& report);
+
+		/* Compute the local smith form at prime p, modulo p^(sev+extra),
+		 * raising the extra exponent until it agrees with the rank r.
+		 */
+		template <class Matrix>
+		static void compute_local_checked (BlasVector<Givaro::ZRing<Integer> >& s, const Matrix& A, long r, int64_t p, int64_t sev,
+						   std::ostream& report);
 
 		/* Compute the k-smooth part of the invariant factor, where k = 100.
 		 * @param sev is the exponent part ...
 		 * By local smith form and rank computation
+		 * The local forms are independent, a parallel policy runs them
+		 * concurrently, the largest moduli first, with no more tasks at
+		 * a time than policy.memory allows; their progress is reported
+		 * once they are all done.
 		 * Should work with SparseMatrix and BlasMatrix
 		 */
 		template <class Matrix>
-		static void smithFormSmooth (BlasVector<Givaro::ZRing<Integer> >& s, const Matrix& A, long r, const std::vector<int64_t>& sev);
+		static void smithFormSmooth (BlasVector<Givaro::ZRing<Integer> >& s, const Matrix& A, long r, const std::vector<int64_t>& sev,
+					     const ParallelPolicy& policy = ParallelPolicy());
 
 		/* Compute the k-rough part of the invariant factor, where k = 100.
 		 * By EGV+ algorithm or Iliopoulos' algorithm for Smith form.
+		 * A parallel policy selects the multithreaded Iliopoulos elimination
+		 * when the modulus fits PIRModular<int32_t>.
 		 * Should work with BlasMatrix
 		 */
 		template <class Matrix>
-		static void smithFormRough  (BlasVector<Givaro::ZRing<Integer> >& s, const Matrix& A, integer m );
+		static void smithFormRough  (BlasVector<Givaro::ZRing<Integer> >& s, const Matrix& A, integer m,
+					     const ParallelPolicy& policy = ParallelPolicy());
+		template <class Matrix>
+		static void smithFormRough  (BlasVector<Givaro::ZRing<Integer> >& s, const Matrix& A, integer m,
+					     const ParallelPolicy& policy, std::ostream& report);
+
+		/* Compute the k-rough part of RA and the k-smooth part of SA, which
+		 * are the same matrix stored differently.
+		 * With a parallel policy the rough part runs in a thread of its own
+		 * while the smooth part shares out the remaining threads, unless
+		 * the rough part needs the bisection, which uses the commentator.
+		 */
+		template <class RMatrix, class SMatrix>
+		static void smithFormParts (BlasVector<Givaro::ZRing<Integer> >& rough, const RMatrix& RA, integer m,
+					    BlasVector<Givaro::ZRing<Integer> >& smooth, const SMatrix& SA, long r, const std::vector<int64_t>& sev,
+					    const ParallelPolicy& policy);
 
 		/* Compute the Smith form via valence algorithms
 		 * Compute the local Smith form at each possible prime
@@ -88,15 +130,18 @@ namespace LinBox
 		 *
 		 * Compute the largest invariant factor, then, based on that,
 		 * compute the rough and smooth part, separately.
+		 * The policy is shared by the rough and the smooth part.
 		 * Should work with SparseMatrix and BlasMatrix
 		 */
 		template <class Matrix>
-		static void smithForm (BlasVector<Givaro::ZRing<Integer> >& s, const Matrix& A);
+		static void smithForm (BlasVector<Givaro::ZRing<Integer> >& s, const Matrix& A,
+				       const ParallelPolicy& policy = ParallelPolicy());
 		/** Specialization for dense case*/
 		// template <class IRing>
 		// static void smithForm (BlasVector<Givaro::ZRing<Integer> >& s, const BlasMatrix<IRing>& A);
 		template <class IRing, class _Rep>
-		static void smithForm (BlasVector<Givaro::ZRing<Integer> >& s, const BlasMatrix<IRing, _Rep>& A);
+		static void smithForm (BlasVector<Givaro::ZRing<Integer> >& s, const BlasMatrix<IRing, _Rep>& A,
+				       const ParallelPolicy& policy = ParallelPolicy());
 
 	};
 	const int64_t SmithFormAdaptive::prime[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53, 59, 61, 67, 71, 73, 79, 83, 89, 97};
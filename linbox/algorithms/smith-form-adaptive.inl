@@ -28,11 +28,16 @@
 
 #include <cmath>
 #include <vector>
+#include <algorithm>
+#include <thread>
+#include <sstream>
+#include <exception>
 #include <givaro/modular-integral.h>
 
 #include "linbox/linbox-config.h"
 #include "linbox/integer.h"
 #include "linbox/util/debug.h"
+#include "linbox/ring/modular.h"
 #include "linbox/ring/pir-modular-int32.h"
 #include "linbox/ring/local2_32.h"
 #include "linbox/ring/local-pir-modular.h"
@@ -42,6 +47,7 @@
 #include "linbox/algorithms/last-invariant-factor.h"
 #include "linbox/algorithms/one-invariant-factor.h"
 #include "linbox/algorithms/matrix-hom.h"
+#include "linbox/matrix/matrixdomain/blas-matrix-domain.h"
 #include "linbox/blackbox/random-matrix.h"
 #include "linbox/blackbox/scompose.h"
 #include <fflas-ffpack/ffpack/ffpack.h>
@@ -57,9 +63,13 @@ namespace LinBox
 	template <class Matrix>
 	void SmithFormAdaptive::compute_local_long (BlasVector<Givaro::ZRing<Integer> >& s, const Matrix& A, int64_t p, int64_t e)
 	{
-		//std::ostream& report(std::cout);
-		std::ostream& report = commentator().report (Commentator::LEVEL_IMPORTANT, PROGRESS_REPORT);
+		compute_local_long (s, A, p, e, commentator().report (Commentator::LEVEL_IMPORTANT, PROGRESS_REPORT));
+	}
 
+	template <class Matrix>
+	void SmithFormAdaptive::compute_local_long (BlasVector<Givaro::ZRing<Integer> >& s, const Matrix& A, int64_t p, int64_t e,
+						    std::ostream& report)
+	{
 		int order = (int)(A. rowdim() < A. coldim() ? A. rowdim() : A. coldim());
 		linbox_check ((s. size() >= (size_t)order) && (p > 0) && ( e >= 0));
 		if (e == 0) return;
@@ -108,7 +118,11 @@ namespace LinBox
 			std::cout << "Call of ffpack is done\n";
 			delete[] A_local;
 #endif
-			size_t rank; integral_rank(rank, A, Method::Auto());
+			// rank mod p, by elimination that reports nothing
+			Givaro::Modular<double> F ((double)p);
+			BlasMatrix<Givaro::Modular<double> > A_p (F, A.rowdim(), A.coldim());
+			MatrixHom::map (A_p, A);
+			size_t rank = BlasMatrixDomain<Givaro::Modular<double> > (F). rankInPlace (A_p);
 
 			BlasVector<Givaro::ZRing<Integer> >::iterator s_p;
 			for (s_p = s. begin(); s_p != s. begin() + (long) rank; ++ s_p)
@@ -144,9 +158,13 @@ namespace LinBox
 	template <class Matrix>
 	void SmithFormAdaptive::compute_local_big (BlasVector<Givaro::ZRing<Integer> >& s, const Matrix& A, int64_t p, int64_t e)
 	{
+		compute_local_big (s, A, p, e, commentator().report (Commentator::LEVEL_IMPORTANT, PROGRESS_REPORT));
+	}
 
-		//std::ostream& report(std::cout);
-		std::ostream& report = commentator().report (Commentator::LEVEL_IMPORTANT, PROGRESS_REPORT);
+	template <class Matrix>
+	void SmithFormAdaptive::compute_local_big (BlasVector<Givaro::ZRing<Integer> >& s, const Matrix& A, int64_t p, int64_t e,
+						   std::ostream& report)
+	{
 		int order = (int)(A. rowdim() < A. coldim() ? A. rowdim() : A. coldim());
 		linbox_check ((s. size() >= (size_t) order) && (p > 0) && ( e >= 0));
 		integer T; T = order; T <<= 20; T = pow (T, (int) sqrt((double)order));
@@ -173,26 +191,59 @@ namespace LinBox
 	template <class Matrix>
 	void SmithFormAdaptive::compute_local (BlasVector<Givaro::ZRing<Integer> >& s, const Matrix& A, int64_t p, int64_t e)
 	{
+		compute_local (s, A, p, e, commentator().report (Commentator::LEVEL_IMPORTANT, PROGRESS_REPORT));
+	}
 
+	template <class Matrix>
+	void SmithFormAdaptive::compute_local (BlasVector<Givaro::ZRing<Integer> >& s, const Matrix& A, int64_t p, int64_t e,
+					       std::ostream& report)
+	{
 		linbox_check ((p > 0) && ( e >= 0));
 		integer m = 1; int i = 0; for ( i = 0; i < e; ++ i) m *= p;
 		if (((p == 2) && (e <= 32)) || (m <= FieldTraits<PIRModular<int32_t> >::maxModulus()))
-			compute_local_long (s, A, p, e);
+			compute_local_long (s, A, p, e, report);
 		else
-			compute_local_big (s, A, p, e);
+			compute_local_big (s, A, p, e, report);
 
 		// normalize the answer
 		for (BlasVector<Givaro::ZRing<Integer> >::iterator p_it = s. begin(); p_it != s. end(); ++ p_it)
 			*p_it = gcd (*p_it, m);
 	}
 
+	/* Compute the local smith form at prime p, modulo p^(sev+extra),
+	 * raising the extra exponent until it agrees with the rank r.
+	 */
+	template <class Matrix>
+	void SmithFormAdaptive::compute_local_checked (BlasVector<Givaro::ZRing<Integer> >& local, const Matrix& A, long r, int64_t p, int64_t sev,
+						       std::ostream& report)
+	{
+		int order = (int)(A. rowdim() < A. coldim() ? A. rowdim() : A. coldim());
+		int extra = 1;
+		do {
+
+			if ((p == 2) && (sev < 32))
+				extra =  32 -(int) sev;
+			// put in a warning if over 2^32
+			integer m = 1;
+			for (int i = 0; i < sev + extra; ++ i) m *= p;
+			report << "   Compute the local smith form mod " << p <<"^" << sev + extra << std::endl;
+			compute_local (local, A, p, sev + extra, report);
+			//check
+			report << "   Check if it agrees with the rank: ";
+			if ((local[(size_t)r-1] % m != 0 ) && ((r == order) ||(local[(size_t)r] % m == 0))) {report << "yes.\n"; break;}
+			report << "no. \n";
+			extra *= 2;
+		} while (true);
+	}
+
 	/* Compute the k-smooth part of the invariant factor, where k = 100.
 	 * @param sev is the exponent part ...
 	 * By local smith form and rank computation
 	 * r >= 2;
 	 */
 	template <class Matrix>
-	void SmithFormAdaptive::smithFormSmooth (BlasVector<Givaro::ZRing<Integer> >& s, const Matrix& A, long r, const std::vector<int64_t>& sev)
+	void SmithFormAdaptive::smithFormSmooth (BlasVector<Givaro::ZRing<Integer> >& s, const Matrix& A, long r, const std::vector<int64_t>& sev,
+						 const ParallelPolicy& policy)
 	{
 		Givaro::ZRing<Integer> Z;
 		//std::ostream& report(std::cout);
@@ -200,9 +251,7 @@ namespace LinBox
 		report << "Computation the k-smooth part of the invariant factors starts(via local and rank):" << std::endl;
 		int order = (int)(A. rowdim() < A. coldim() ? A. rowdim() : A. coldim());
 		linbox_check (s. size() >= (size_t)order);
-		std::vector<int64_t>::const_iterator sev_p; const int64_t* prime_p; BlasVector<Givaro::ZRing<Integer> >::iterator s_p;
-		BlasVector<Givaro::ZRing<Integer> > local(Z,(size_t)order);
-		BlasVector<Givaro::ZRing<Integer> >::iterator local_p;
+		BlasVector<Givaro::ZRing<Integer> >::iterator s_p;
 
 		for (s_p = s. begin(); s_p != s. begin() +(ptrdiff_t) r; ++ s_p)
 			*s_p = 1;
@@ -210,26 +259,47 @@ namespace LinBox
 			*s_p = 0;
 		if (r == 0) return;
 
-		for (sev_p = sev. begin(), prime_p = prime; sev_p != sev. begin() +(ptrdiff_t) NPrime; ++ sev_p, ++ prime_p) {
-			int extra = 1;
-			do {
-
-				if ((*prime_p == 2) && (*sev_p < 32))
-					extra =  32 -(int) *sev_p;
-				// put in a warning if over 2^32
-				integer m = 1;
-				for (int i = 0; i < *sev_p + extra; ++ i) m *= * prime_p;
-				report << "   Compute the local smith form mod " << *prime_p <<"^" << *sev_p + extra << std::endl;
-				compute_local (local, A, *prime_p, *sev_p + extra);
-				//check
-				report << "   Check if it agrees with the rank: ";
-				if ((local[(size_t)r-1] % m != 0 ) && ((r == order) ||(local[(size_t)r] % m == 0))) {report << "yes.\n"; break;}
-				report << "no. \n";
-				extra *= 2;
-			} while (true);
-			for (s_p = s. begin(), local_p = local. begin(); s_p != s. begin() +(ptrdiff_t) order; ++ s_p, ++ local_p)
-				*s_p *= *local_p;
+		// one task per prime, the largest moduli first since they take longest
+		std::vector<int> task ((size_t)NPrime);
+		std::vector<double> bits ((size_t)NPrime);
+		for (int i = 0; i < NPrime; ++ i) {
+			task[(size_t)i] = i;
+			bits[(size_t)i] = (double)(sev[(size_t)i] + 1) * log ((double)prime[i]) / log (2.);
+		}
+		std::stable_sort (task. begin(), task. end(), [&bits](int a, int b) { return bits[(size_t)a] > bits[(size_t)b]; });
+
+		// a local copy of A takes a word per entry, or an Integer when p^e is big
+		const double maxBits = bits[(size_t)task. front()];
+		const size_t entryBytes = (maxBits < 31.) ? sizeof(int64_t) : sizeof(Integer) + (size_t)(maxBits / 8.) + 8;
+		const size_t nt = policy. concurrentTasks ((size_t)NPrime, A. rowdim() * A. coldim() * entryBytes);
+		if (nt > 1) report << "   " << nt << " local forms at a time\n";
+
+		// the commentator is not thread safe, each task reports to its own buffer
+		std::vector<BlasVector<Givaro::ZRing<Integer> > > local ((size_t)NPrime, BlasVector<Givaro::ZRing<Integer> >(Z, (size_t)order));
+		std::vector<std::ostringstream> localReport ((size_t)NPrime);
+		std::exception_ptr failure;
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for num_threads((int)nt) schedule(dynamic, 1) if (nt > 1)
+#endif
+		for (int t = 0; t < NPrime; ++ t) {
+			const size_t i = (size_t)task[(size_t)t];
+			try {
+				compute_local_checked (local[i], A, r, prime[i], sev[i], localReport[i]);
+			}
+			catch (...) {
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp critical (smith_form_smooth)
+#endif
+				failure = std::current_exception();
+			}
 		}
+		for (size_t i = 0; i < (size_t)NPrime; ++ i)
+			report << localReport[i]. str();
+		if (failure) std::rethrow_exception (failure);
+
+		for (size_t i = 0; i < (size_t)NPrime; ++ i)
+			for (size_t j = 0; j < (size_t)order; ++ j)
+				s[j] *= local[i][j];
 		report << "Computation of the smooth part is done.\n";
 
 	}
@@ -239,11 +309,16 @@ namespace LinBox
 	 * By EGV+ algorithm or Iliopoulos' algorithm for Smith form.
 	 */
 	template <class Matrix>
-	void SmithFormAdaptive::smithFormRough  (BlasVector<Givaro::ZRing<Integer> >& s, const Matrix& A, integer m)
+	void SmithFormAdaptive::smithFormRough  (BlasVector<Givaro::ZRing<Integer> >& s, const Matrix& A, integer m,
+						 const ParallelPolicy& policy)
 	{
+		smithFormRough (s, A, m, policy, commentator().report (Commentator::LEVEL_IMPORTANT, PROGRESS_REPORT));
+	}
 
-		//std::ostream& report(std::cout);
-		std::ostream& report = commentator().report (Commentator::LEVEL_IMPORTANT, PROGRESS_REPORT);
+	template <class Matrix>
+	void SmithFormAdaptive::smithFormRough  (BlasVector<Givaro::ZRing<Integer> >& s, const Matrix& A, integer m,
+						 const ParallelPolicy& policy, std::ostream& report)
+	{
 		report << "Compuation of the k-rough part f the invariant factors starts(via EGV+ or Iliopolous):\n";
 		int order = (int)(A. rowdim() < A. coldim() ? A. rowdim() : A. coldim());
 		integer T; T = order; T <<= 20; T = pow (T, (int) sqrt((double)order));
@@ -255,7 +330,12 @@ namespace LinBox
 			PIRModular<int32_t> R (m);
 			BlasMatrix<PIRModular<int32_t> > A_ilio(R, A.rowdim(), A.coldim());
 			MatrixHom::map (A_ilio, A);
-			SmithFormIliopoulos::smithFormIn (A_ilio);
+			if (policy. isParallel()) {
+				report << "    on " << policy. threads() << " threads\n";
+				SmithFormIliopoulos::smithFormIn (A_ilio, policy);
+			}
+			else
+				SmithFormIliopoulos::smithFormIn (A_ilio);
 			int i; BlasVector<Givaro::ZRing<Integer> >::iterator s_p;
 			for (i = 0, s_p = s. begin(); s_p != s. begin() +(ptrdiff_t) order; ++ i, ++ s_p)
 				R. convert(*s_p, A_ilio[(size_t)i][(size_t)i]);
@@ -295,6 +375,58 @@ namespace LinBox
 		report << "Compuation of the k-rough part of the invariant factors finishes.\n";
 	}
 
+	/* Compute the k-rough part of RA and the k-smooth part of SA,
+	 * concurrently under a parallel policy.
+	 */
+	template <class RMatrix, class SMatrix>
+	void SmithFormAdaptive::smithFormParts (BlasVector<Givaro::ZRing<Integer> >& rough, const RMatrix& RA, integer m,
+						BlasVector<Givaro::ZRing<Integer> >& smooth, const SMatrix& SA, long r, const std::vector<int64_t>& sev,
+						const ParallelPolicy& policy)
+	{
+		// the bisection of a big rough part goes through the commentator
+		const size_t order = std::min (RA. rowdim(), RA. coldim());
+		integer T; T = order; T <<= 20; T = pow (T, (int) sqrt((double)order));
+		if (! policy. isParallel() || (m > T && m > FieldTraits<PIRModular<int32_t> >::maxModulus())) {
+			smithFormSmooth (smooth, SA, r, sev, policy);
+			smithFormRough (rough, RA, m, policy);
+			return;
+		}
+
+		// only the word size elimination of the rough part uses threads
+		const size_t threads = policy. threads();
+		const bool wordRough = (m > 1) && (m <= FieldTraits<PIRModular<int32_t> >::maxModulus());
+		ParallelPolicy roughPolicy (policy), smoothPolicy (policy);
+		roughPolicy. numThreads = wordRough ? threads / 2 : 1;
+		smoothPolicy. numThreads = std::max (threads - roughPolicy. numThreads, (size_t)1);
+		// the rough part holds a word size copy of A, or an Integer one
+		if (policy. memory > 0) {
+			const size_t roughBytes = RA. rowdim() * RA. coldim() * (wordRough ? sizeof(int64_t) : sizeof(Integer) + (size_t)(m. bitsize() + 7) / 8 + 8);
+			smoothPolicy. memory = (policy. memory > roughBytes) ? policy. memory - roughBytes : 1;
+		}
+
+		// the rough thread reports to a buffer, written out after the join
+		std::ostringstream roughReport;
+		std::exception_ptr failure;
+		std::thread roughTask ([&]() {
+			try {
+				smithFormRough (rough, RA, m, roughPolicy, roughReport);
+			}
+			catch (...) {
+				failure = std::current_exception();
+			}
+		});
+		try {
+			smithFormSmooth (smooth, SA, r, sev, smoothPolicy);
+		}
+		catch (...) {
+			roughTask. join();
+			throw;
+		}
+		roughTask. join();
+		commentator().report (Commentator::LEVEL_IMPORTANT, PROGRESS_REPORT) << roughReport. str();
+		if (failure) std::rethrow_exception (failure);
+	}
+
 	/* Compute the Smith form via valence algorithms
 	 * Compute the local Smtih form at each possible prime
 	 * r >= 2;
@@ -338,7 +470,7 @@ namespace LinBox
 				integer m = 1;
 				for (int i = 0; i < extra; ++ i) m *= * prime_p;
 				report << "   Compute the local smith form mod " << *prime_p <<"^" << extra << std::endl;
-				compute_local (local, A, *prime_p, extra);
+				compute_local (local, A, *prime_p, extra, report);
 				//check
 				report << "   Check if it agrees with the rank: ";
 				if ((local[(size_t)r-1] % m != 0 ) && ((r == order) ||(local[(size_t)r] % m == 0))) {report << "yes.\n"; break;}
@@ -359,7 +491,8 @@ namespace LinBox
 	 * then based on that, compute the rough and smooth part, seperately.
 	 */
 	template <class Matrix>
-	void SmithFormAdaptive::smithForm (BlasVector<Givaro::ZRing<Integer> >& s, const Matrix& A)
+	void SmithFormAdaptive::smithForm (BlasVector<Givaro::ZRing<Integer> >& s, const Matrix& A,
+					   const ParallelPolicy& policy)
 	{
 		//commentator().start ("Smith Form starts", "Smithform");
 
@@ -442,8 +575,7 @@ namespace LinBox
 		bonus = gcd (bonus, r_mod);
 		Givaro::ZRing<Integer> Z;
 		BlasVector<Givaro::ZRing<Integer> > smooth (Z,(size_t)order), rough (Z,(size_t)order);
-		smithFormRough (rough, DA, bonus);
-		smithFormSmooth (smooth, A, r, e);
+		smithFormParts (rough, DA, bonus, smooth, A, (long)r, e, policy);
 		//fixed the rough largest invariant factor
 		if (r > 0) rough[r-1] = r_mod;
 
@@ -477,7 +609,8 @@ namespace LinBox
 	 * then based on that, compute the rough and smooth part, seperately.
 	 */
 	template <class IRing, class _Rep>
-	void SmithFormAdaptive::smithForm (BlasVector<Givaro::ZRing<Integer> >& s, const BlasMatrix<IRing, _Rep>& A)
+	void SmithFormAdaptive::smithForm (BlasVector<Givaro::ZRing<Integer> >& s, const BlasMatrix<IRing, _Rep>& A,
+					   const ParallelPolicy& policy)
 	{
 		//commentator().start ("Smith Form starts", "Smithform");
 		Givaro::ZRing<Integer> Z;
@@ -566,10 +699,8 @@ namespace LinBox
 		// bonus assigns to its rough part
 		bonus = gcd (bonus, r_mod);
 		BlasVector<Givaro::ZRing<Integer> > smooth (Z,order), rough (Z,order);
-		report << "Computation of smooth part begins.\n";
-		smithFormSmooth (smooth, A, (long)r, e);
-		report << "Computation of rough part begins.\n";
-		smithFormRough (rough, A, bonus);
+		report << "Computation of rough/smooth parts begins.\n";
+		smithFormParts (rough, A, bonus, smooth, A, (long)r, e, policy);
 		report << "Computation of rough/smooth parts finished.\n";
 		// fixed the rough largest invariant factor
 		if (r > 0) rough[r-1] = r_mod;
@@ -25,9 +25,15 @@
 #ifndef __LINBOX_smith_form_iliopoulos_H
 #define __LINBOX_smith_form_iliopoulos_H
 
+#include <algorithm>
+#include <vector>
+
 #include "linbox/util/debug.h"
+#include "linbox/util/parallel-policy.h"
 #include "linbox/vector/vector-domain.h"
 #include "linbox/blackbox/submatrix-traits.h"
+#include "linbox/matrix/dense-matrix.h"
+#include "linbox/ring/modular/modular-delayed.h"
 
 namespace LinBox
 {
@@ -424,30 +430,275 @@ namespace LinBox
 		}
 
 
-	public:
+		/** \brief Iliopoulos' elimination in place on a dense matrix over a
+		 * word size PIR, such as PIRModular<int32_t>.
+		 *
+		 * Step k does what eliminationRow and eliminationCol do on the
+		 * trailing matrix A[k.., k..], without submatrix views.  The gcd
+		 * bookkeeping of a step is sequential and linear in the dimension;
+		 * the quadratic updates (the combination that brings the pivot
+		 * and the elimination under it) are split in row or column blocks
+		 * among the threads of the policy, and the sums of products are
+		 * reduced lazily, see DelayedFieldAXPY.
+		 */
+		template<class Ring>
+		class WordElimination {
+		public:
+			typedef typename Ring::Element Element;
+			typedef DelayedFieldAXPY<Ring> Delayed;
+			typedef typename Delayed::Abnormal Abnormal;
+
+			WordElimination (const Ring& r, Element* A, size_t m, size_t n, size_t ld, const ParallelPolicy& policy) :
+				_r (r), _acc (r), _A (A), _m (m), _n (n), _ld (ld), _policy (policy)
+			{}
+
+			/// make the row k (*, 0, ..., 0) by column operations
+			void eliminationRow (size_t k)
+			{
+				if (_n - k <= 1) return;
+
+				if (_r.isUnit (at (k, k))) {
+					if (! _r.isOne (at (k, k))) {
+						Element s;
+						_r.inv (s, at (k, k));
+						for (size_t i = k; i < _m; ++i) _r.mulin (at (i, k), s);
+					}
+				}
+				else {
+					/* make A[k][k] = 0.  The cofactors come from the exact
+					 * quotients of dxgcd: the quotients of div are only
+					 * defined up to multiples of p/gcd(g,p), and the 2x2
+					 * transform built with them need not be invertible.
+					 */
+					if (! _r.isZero (at (k, k))) {
+						Element g, s, t, y1, y2, c0, c1;
+						_r.dxgcd (g, s, t, y2, y1, at (k, k), at (k, k+1));
+						_r.negin (y1);
+						for (size_t i = k; i < _m; ++i) {
+							c0 = at (i, k); c1 = at (i, k+1);
+							_r.axpy (at (i, k), y1, c0, _r.mulin (c1, y2));
+							c1 = at (i, k+1);
+							_r.axpy (at (i, k+1), s, c0, _r.mulin (c1, t));
+						}
+						if (! _r.isZero (at (k, k))) {
+							Element q;
+							_r.div (q, at (k, k), g);
+							_r.negin (q);
+							for (size_t i = k; i < _m; ++i) _r.axpyin (at (i, k), q, at (i, k+1));
+						}
+					}
 
-		template <class Vector,class Matrix>
-		static void solve(Vector& factors,const Matrix& A)
-		{
-			Matrix B(A);
-			smithFormIn(B);
-			factors.resize(B.rowdim());
-			for (int i=0;i<B.rowdim();++i) {
-				A.field().assign(factors[i],B.getEntry(i,i));
+					std::vector<Element> v (_n - k);
+					if (! cofactors (v, &at (k, k), 1)) return; // no pivot found
+					rowDots (k, v);
+				}
+
+				// column operations to make A[k][j] = 0, for k < j
+				std::vector<Element> q (_n - k, _r.zero);
+				for (size_t j = k + 1; j < _n; ++j)
+					if (! _r.isZero (at (k, j))) {
+						_r.div (q[j-k], at (k, j), at (k, k));
+						_r.negin (q[j-k]);
+					}
+				addColumnMultiples (k, q);
 			}
-		}
 
-		template<class Matrix>
-		static  Matrix& smithFormIn(Matrix& A) {
+			/// make the column k (*, 0, ..., 0) by row operations
+			void eliminationCol (size_t k)
+			{
+				if (_m - k <= 1) return;
 
-			typedef typename Matrix::Field Ring;
-			typedef typename Ring::Element Element;
+				if (_r.isUnit (at (k, k))) {
+					if (! _r.isOne (at (k, k))) {
+						Element s;
+						_r.inv (s, at (k, k));
+						for (size_t j = k; j < _n; ++j) _r.mulin (at (k, j), s);
+					}
+				}
+				else {
+					if (! _r.isZero (at (k, k))) {
+						Element g, s, t, y1, y2, c0, c1;
+						_r.dxgcd (g, s, t, y2, y1, at (k, k), at (k+1, k));
+						_r.negin (y1);
+						for (size_t j = k; j < _n; ++j) {
+							c0 = at (k, j); c1 = at (k+1, j);
+							_r.axpy (at (k, j), y1, c0, _r.mulin (c1, y2));
+							c1 = at (k+1, j);
+							_r.axpy (at (k+1, j), s, c0, _r.mulin (c1, t));
+						}
+						if (! _r.isZero (at (k, k))) {
+							Element q;
+							_r.div (q, at (k, k), g);
+							_r.negin (q);
+							for (size_t j = k; j < _n; ++j) _r.axpyin (at (k, j), q, at (k+1, j));
+						}
+					}
 
-			Ring r (A.field());
+					std::vector<Element> v (_m - k);
+					if (! cofactors (v, &at (k, k), _ld)) return; // no pivot found
+					columnDots (k, v);
+				}
+
+				// row operations to make A[i][k] = 0, for k < i
+				std::vector<Element> q (_m - k, _r.zero);
+				for (size_t i = k + 1; i < _m; ++i)
+					if (! _r.isZero (at (i, k))) {
+						_r.div (q[i-k], at (i, k), at (k, k));
+						_r.negin (q[i-k]);
+					}
+				addRowMultiples (k, q);
+			}
 
-			typename Matrix::RowIterator row_p;
+			/// whether A[k][k] divides the rest of the row k
+			bool check (size_t k) const
+			{
+				const Element& d = at (k, k);
+				if (_r.isZero (d)) return true;
+				for (size_t j = k + 1; j < _n; ++j)
+					if (! _r.isDivisor (d, at (k, j))) return false;
+				return true;
+			}
 
-			diagonalizationIn(A, r);
+		protected:
+			Element& at (size_t i, size_t j) { return _A[i * _ld + j]; }
+			const Element& at (size_t i, size_t j) const { return _A[i * _ld + j]; }
+
+			size_t threads (size_t m, size_t n) const
+			{
+				return _policy.worthIt (m, n) ? _policy.threads () : 1;
+			}
+
+			/** Cofactors v of the entries a[0], a[inc], ... whose combination
+			 * is their gcd, with v[0] = 1 as in eliminationRow.  Each new
+			 * gcd scales all the previous cofactors, the scalings are
+			 * applied at the end as suffix products.
+			 * Returns false when the gcd is zero.
+			 */
+			bool cofactors (std::vector<Element>& v, const Element* a, size_t inc) const
+			{
+				const size_t len = v.size ();
+				std::vector<Element> scale (len, _r.one);
+				Element g, c;
+				_r.assign (v[0], _r.one);
+				_r.assign (v[1], _r.one);
+				_r.assign (g, a[inc]);
+				for (size_t l = 2; l < len; ++l)
+					_r.xgcd (g, scale[l], v[l], g, a[l * inc]);
+				if (_r.isZero (g)) return false;
+				_r.assign (c, _r.one);
+				for (size_t l = len - 1; l >= 1; --l) {
+					_r.mulin (v[l], c);
+					_r.mulin (c, scale[l]);
+				}
+				return true;
+			}
+
+			/// A[i][k] = sum_l A[i][k+l] v[l], for all i >= k
+			void rowDots (size_t k, const std::vector<Element>& v)
+			{
+				const long rows = (long)(_m - k);
+				const size_t len = v.size (), d = _acc.delay ();
+#ifdef __LINBOX_USE_OPENMP
+				const size_t nt = threads (_m - k, _n - k);
+#pragma omp parallel for num_threads((int)nt) schedule(static) if (nt > 1)
+#endif
+				for (long ii = 0; ii < rows; ++ii) {
+					Element* row = &at (k + (size_t)ii, k);
+					Abnormal y = 0;
+					for (size_t l = 0; l < len; ) {
+						const size_t end = std::min (len, l + d);
+						for (; l < end; ++l) _acc.axpyin (y, row[l], v[l]);
+						y = _acc.reduce (y);
+					}
+					row[0] = _acc.normal (y);
+				}
+			}
+
+			/** A[k][j] = sum_i v[i] A[k+i][j], for all j >= k: each thread
+			 * runs down the rows on its own block of columns.
+			 */
+			void columnDots (size_t k, const std::vector<Element>& v)
+			{
+				const size_t len = v.size (), cols = _n - k, d = _acc.delay ();
+				size_t nt = 1;
+#ifdef __LINBOX_USE_OPENMP
+				nt = threads (_m - k, _n - k);
+#endif
+				const size_t block = (cols + nt - 1) / nt;
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for num_threads((int)nt) schedule(static, 1) if (nt > 1)
+#endif
+				for (long b = 0; b < (long)nt; ++b) {
+					const size_t j0 = k + (size_t)b * block, j1 = std::min (_n, j0 + block);
+					if (j0 >= j1) continue;
+					std::vector<Abnormal> y (j1 - j0, Abnormal (0));
+					size_t left = d;
+					for (size_t i = 0; i < len; ++i) {
+						const Element* row = &at (k + i, j0);
+						for (size_t j = 0; j < j1 - j0; ++j) _acc.axpyin (y[j], v[i], row[j]);
+						if (--left == 0) {
+							for (auto& t : y) t = _acc.reduce (t);
+							left = d;
+						}
+					}
+					Element* row = &at (k, j0);
+					for (size_t j = 0; j < j1 - j0; ++j) row[j] = _acc.normal (_acc.reduce (y[j]));
+				}
+			}
+
+			/// A[i][j] += q[j-k] A[i][k], for all i >= k and j > k
+			void addColumnMultiples (size_t k, const std::vector<Element>& q)
+			{
+				const long rows = (long)(_m - k);
+#ifdef __LINBOX_USE_OPENMP
+				const size_t nt = threads (_m - k, _n - k);
+#pragma omp parallel for num_threads((int)nt) schedule(static) if (nt > 1)
+#endif
+				for (long ii = 0; ii < rows; ++ii) {
+					Element* row = &at (k + (size_t)ii, k);
+					if (_r.isZero (row[0])) continue;
+					for (size_t j = 1; j < q.size (); ++j) {
+						Abnormal y = (Abnormal) row[j];
+						_acc.axpyin (y, q[j], row[0]);
+						row[j] = _acc.normal (_acc.reduce (y));
+					}
+				}
+			}
+
+			/// A[i][j] += q[i-k] A[k][j], for all i > k and j >= k
+			void addRowMultiples (size_t k, const std::vector<Element>& q)
+			{
+				const long rows = (long)(_m - k);
+				const Element* pivot = &at (k, k);
+#ifdef __LINBOX_USE_OPENMP
+				const size_t nt = threads (_m - k, _n - k);
+#pragma omp parallel for num_threads((int)nt) schedule(static) if (nt > 1)
+#endif
+				for (long ii = 1; ii < rows; ++ii) {
+					if (_r.isZero (q[(size_t)ii])) continue;
+					Element* row = &at (k + (size_t)ii, k);
+					for (size_t j = 0; j < _n - k; ++j) {
+						Abnormal y = (Abnormal) row[j];
+						_acc.axpyin (y, q[(size_t)ii], pivot[j]);
+						row[j] = _acc.normal (_acc.reduce (y));
+					}
+				}
+			}
+
+			const Ring& _r;
+			const Delayed _acc;
+			Element* _A;
+			const size_t _m, _n, _ld;
+			const ParallelPolicy& _policy;
+		};
+
+		/** \brief Sort the diagonal of a diagonalized matrix into
+		 * invariant factors: each one divides the next.
+		 */
+		template<class Matrix, class Ring>
+		static Matrix& sortDiagonal (Matrix& A, const Ring& r)
+		{
+			typedef typename Ring::Element Element;
 
 			int min = (int)(A.rowdim() <= A.coldim() ? A.rowdim() : A.coldim());
 
@@ -481,6 +732,58 @@ namespace LinBox
 			}
 
 			return A;
+		}
+
+	public:
+
+		template <class Vector,class Matrix>
+		static void solve(Vector& factors,const Matrix& A)
+		{
+			Matrix B(A);
+			smithFormIn(B);
+			factors.resize(B.rowdim());
+			for (int i=0;i<B.rowdim();++i) {
+				A.field().assign(factors[i],B.getEntry(i,i));
+			}
+		}
+
+		template<class Matrix>
+		static  Matrix& smithFormIn(Matrix& A) {
+
+			typedef typename Matrix::Field Ring;
+
+			Ring r (A.field());
+
+			diagonalizationIn(A, r);
+
+			return sortDiagonal(A, r);
+
+		}
+
+		/** \brief Smith form of a dense matrix over a word size PIR.
+		 *
+		 * The elimination is WordElimination: the updates of the trailing
+		 * matrix after each pivot run on the threads of \p policy when the
+		 * trailing matrix is larger than its grain.
+		 */
+		template<class Ring, class Rep>
+		static BlasMatrix<Ring, Rep>& smithFormIn(BlasMatrix<Ring, Rep>& A, const ParallelPolicy& policy) {
+
+			const Ring& r = A.field();
+
+			WordElimination<Ring> W (r, A.getPointer(), A.rowdim(), A.coldim(), A.getStride(), policy);
+
+			const size_t min = std::min (A.rowdim(), A.coldim());
+
+			for (size_t k = 0; k < min; ++k)
+				do {
+					W.eliminationRow (k);
+
+					W.eliminationCol (k);
+				}
+				while (!W.check (k));
+
+			return sortDiagonal(A, r);
 
 		}
 
@@ -427,6 +427,7 @@ namespace LinBox
                 ranks.resize(0);
 
                 typedef typename BB::Row Vecteur;
+                SparseRowArena::Scope arenaScope(eliminationArena(LigneA));
                 typedef typename Signed_Trait<Modulo>::unsigned_type UModulo;
 
                 Modulo MOD = FMOD;
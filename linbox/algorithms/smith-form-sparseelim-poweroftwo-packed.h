@@ -0,0 +1,421 @@
+/* algorithms/smith-form-sparseelim-poweroftwo-packed.h
+ * Copyright (C) LinBox
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+  * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file algorithms/smith-form-sparseelim-poweroftwo-packed.h
+ * @ingroup algorithms
+ * @brief Word-packed sparse elimination modulo 2^e, e <= 64 (or 128).
+ *
+ * Same interface as PowerGaussDomainPowerOfTwo, but all arithmetic is
+ * native wrap-around on a machine word and the rows live in a single
+ * arena of packed (index, word) arrays.
+ */
+
+#ifndef __LINBOX_pp_gauss_poweroftwo_packed_H
+#define __LINBOX_pp_gauss_poweroftwo_packed_H
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <givaro/givinteger.h>
+#include "linbox/algorithms/smith-form-sparseelim-local.h"
+
+namespace LinBox
+{
+
+        /** \brief 2-adic operations on native unsigned words.
+         * Only uint64_t and, when available, unsigned __int128.
+         */
+    template<typename Word> struct PowerOfTwoWordTraits;
+
+    template<> struct PowerOfTwoWordTraits<uint64_t> {
+        static constexpr size_t bits = 64;
+            // a != 0
+        static inline size_t ctz(const uint64_t& a) {
+            return (size_t)__builtin_ctzll(a);
+        }
+    };
+
+#ifdef __SIZEOF_INT128__
+    template<> struct PowerOfTwoWordTraits<unsigned __int128> {
+        static constexpr size_t bits = 128;
+            // a != 0
+        static inline size_t ctz(const unsigned __int128& a) {
+            const uint64_t lo((uint64_t)a);
+            return lo ? (size_t)__builtin_ctzll(lo)
+                : 64+(size_t)__builtin_ctzll((uint64_t)(a>>64));
+        }
+    };
+#endif
+
+        /** \brief Rank modulo 2^e by sparse elimination on packed words.
+         *
+         * Rows are stored as (column, value) slices of two contiguous
+         * arrays (the arena); updated rows are appended at the tail and
+         * the arena is compacted when half of it is garbage.
+         * Pivots are chosen by 2-adic valuation without rescaling the
+         * matrix: at level v all remaining entries are multiples of 2^v
+         * and any entry with bit v set is a valid pivot.
+         * Among those, the row of least size then the column of least
+         * density is selected.
+         * \tparam Word uint64_t (e <= 64) or unsigned __int128 (e <= 128)
+         */
+    template<typename Word, typename Index = uint32_t>
+    class PowerGaussDomainPowerOfTwoPacked {
+        typedef PowerOfTwoWordTraits<Word> Traits;
+    public:
+        typedef Word Element;
+
+        PowerGaussDomainPowerOfTwoPacked () {}
+
+            /// Largest exponent handled by this engine
+        static constexpr size_t maxExponent() { return Traits::bits; }
+
+            /// 2-adic valuation of a non-zero a
+        static inline size_t valuation(const Word& a) {
+            return Traits::ctz(a);
+        }
+
+            /// x modulo 2^bits, for native integers (two's complement wrap-around)
+        template<class E>
+        static inline Word toWord(const E& x) {
+            return (Word)x;
+        }
+
+            /// x modulo 2^bits, 64 bits at a time
+        static inline Word toWord(const Givaro::Integer& x) {
+            const Givaro::Integer two64( Givaro::Integer(1) << 64 );
+            Givaro::Integer r( x % (Givaro::Integer(1) << (int)Traits::bits) );
+            if (r < 0) r += (Givaro::Integer(1) << (int)Traits::bits);
+            Word w(0U);
+            for(size_t shift=0; shift<Traits::bits; shift+=64) {
+                w |= ((Word)(uint64_t)(r % two64)) << shift;
+                r >>= 64;
+            }
+            return w;
+        }
+
+        template<class E>
+        static inline E& fromWord(E& x, const Word& w) {
+            return x = (E)w;
+        }
+
+        static inline Givaro::Integer& fromWord(Givaro::Integer& x, const Word& w) {
+            x = 0;
+            for(size_t shift=Traits::bits; shift; ) {
+                shift -= 64;
+                x <<= 64;
+                x += (uint64_t)(w >> shift);
+            }
+            return x;
+        }
+
+            /// Inverse of an odd a modulo 2^bits, by Newton-Raphson
+        static inline Word inverse(const Word& a) {
+            Word u(a); // correct to 3 bits
+            for(size_t b=3; b<Traits::bits; b<<=1)
+                u *= Word(2U)-a*u;
+            return u;
+        }
+
+        template<class Matrix, class Perm, template<class, class> class Container, template<class> class Alloc>
+        Container<std::pair<Word,size_t>, Alloc<std::pair<Word,size_t> > >& operator()(Container<std::pair<Word,size_t>, Alloc<std::pair<Word,size_t> > >& L, Matrix& A, Perm& Q, size_t EXPONENT, int StaticParameters=PRIVILEGIATE_NO_COLUMN_PIVOTING) {
+            Container<size_t, Alloc<size_t> > ranks;
+            prime_power_rankin( EXPONENT, ranks, A, Q, A.rowdim(), A.coldim(), std::vector<size_t>(),StaticParameters);
+            L.resize( 0 ) ;
+            Word MOD(1U);
+            size_t num = 0;
+            for( typename Container<size_t, Alloc<size_t> >::const_iterator it = ranks.begin(); it != ranks.end(); ++it) {
+                size_t diff = *it-num;
+                if (diff > 0) L.emplace_back(MOD,diff);
+                MOD <<= 1;
+                num = *it;
+            }
+            return L;
+        }
+
+            /** \brief ranks[j] is the rank modulo 2^(j+1), for j < EXPONENT.
+             * A is consumed; with PRESERVE_UPPER_MATRIX its first rows
+             * hold the upper triangular factor, columns permuted by Q.
+             */
+        template<class BB, class D, class Container, class Perm>
+        void prime_power_rankin (size_t EXPONENT, Container& ranks, BB& A, Perm& Q, const size_t Ni, const size_t Nj, const D&, int StaticParameters=PRIVILEGIATE_NO_COLUMN_PIVOTING) {
+            commentator().start ("Packed Gaussian elimination with reordering modulo a power of 2", "PRGEPo2P", Ni);
+            linbox_check( EXPONENT <= Traits::bits );
+            linbox_check( Nj <= (size_t)std::numeric_limits<Index>::max() );
+            linbox_check( Q.coldim() == Nj );
+
+            const Word MASK( EXPONENT < Traits::bits ? (Word(1U)<<EXPONENT)-1U : ~Word(0U) );
+            const bool privilegiate( PRIVILEGIATE_NO_COLUMN_PIVOTING & StaticParameters );
+
+            load(A, Ni, Nj, MASK);
+
+            std::vector<Index> lab2col(Nj), col2lab(Nj);
+            for(size_t j=0; j<Nj; ++j) lab2col[j] = col2lab[j] = (Index)j;
+
+            ranks.resize(0);
+            size_t rank(0), level(0);
+            const size_t maxout( std::max(Ni/100,size_t(1)) );
+
+            while ( (rank < Ni) && (level < EXPONENT) ) {
+                if ( ! (rank % maxout) ) commentator().progress ((long)rank);
+                if (_live == 0) break;
+
+                size_t prow(rank), ppos(0);
+                if (! findPivot(prow, ppos, rank, level, privilegiate, col2lab) ) {
+                        // No pivot of valuation level: next power of two
+                    ranks.push_back(rank);
+                    ++level;
+                    continue;
+                }
+
+                std::swap(_order[rank], _order[prow]);
+                const size_t pr(_order[rank]);
+                const Index pcol( _cols[_rows[pr].offset+ppos] );
+                const Word pval( _vals[_rows[pr].offset+ppos] );
+                ENSURE( valuation(pval) == level );
+
+                    // Column relabelling, as in PowerGaussDomainPowerOfTwo
+                const size_t c(col2lab[pcol]);
+                if (c != rank) {
+                    Q.permute(rank,c);
+                    const Index oc(lab2col[rank]);
+                    std::swap(lab2col[rank],lab2col[c]);
+                    col2lab[pcol] = (Index)rank;
+                    col2lab[oc] = (Index)c;
+                }
+
+                for(size_t l=_rows[pr].offset; l<_rows[pr].offset+_rows[pr].size; ++l)
+                    --_colDensity[_cols[l]];
+                _live -= _rows[pr].size;
+
+                eliminate(rank+1, pr, pcol, inverse(pval >> level), level, MASK);
+                ++rank;
+            }
+            while (ranks.size() < EXPONENT) ranks.push_back(rank);
+
+            store(A, Ni, col2lab, (PRESERVE_UPPER_MATRIX & StaticParameters) ? rank : 0);
+
+#ifdef LINBOX_PRANK_OUT
+            std::cerr << "Rank mod 2^" << EXPONENT << " : " << rank << std::endl;
+#endif
+            commentator().stop ("done", 0, "PRGEPo2P");
+        }
+
+    protected:
+        struct Slice { size_t offset, size; };
+
+        std::vector<Index> _cols;       // arena, column indices
+        std::vector<Word> _vals;        // arena, values
+        std::vector<Slice> _rows;
+        std::vector<size_t> _order;     // row permutation
+        std::vector<size_t> _colDensity;
+        size_t _live;                   // number of entries in active rows
+        size_t _garbage;                // dead arena entries
+
+            // Pack A (sorted rows) into the arena, reduced modulo 2^e
+        template<class BB>
+        void load(BB& A, const size_t Ni, const size_t Nj, const Word& MASK) {
+            size_t nnz(0);
+            for(size_t i=0; i<Ni; ++i) nnz += A[i].size();
+            _cols.resize(0); _cols.reserve(nnz<<1);
+            _vals.resize(0); _vals.reserve(nnz<<1);
+            _rows.resize(Ni); _order.resize(Ni);
+            _colDensity.assign(Nj,0);
+            for(size_t i=0; i<Ni; ++i) {
+                _order[i] = i;
+                _rows[i].offset = _cols.size();
+                for(auto const& iter: A[i]) {
+                    const Word r( toWord(iter.second) & MASK );
+                    if (r) {
+                        ++_colDensity[iter.first];
+                        _cols.push_back((Index)iter.first);
+                        _vals.push_back(r);
+                    }
+                }
+                _rows[i].size = _cols.size()-_rows[i].offset;
+            }
+            _live = _cols.size();
+            _garbage = 0;
+        }
+
+            // Write back the first upper rows with relabelled columns
+        template<class BB>
+        void store(BB& A, const size_t Ni, const std::vector<Index>& col2lab, const size_t upper) const {
+            typedef typename BB::Row Vecteur;
+            typedef typename Vecteur::value_type::second_type Elt;
+            for(size_t i=0; i<Ni; ++i) {
+                Vecteur toto;
+                if (i < upper) {
+                    const Slice& s(_rows[_order[i]]);
+                    toto.reserve(s.size);
+                    Elt x;
+                    for(size_t l=s.offset; l<s.offset+s.size; ++l)
+                        toto.emplace_back((size_t)col2lab[_cols[l]], fromWord(x, _vals[l]));
+                    std::sort(toto.begin(), toto.end(),
+                              [](const typename Vecteur::value_type& a,
+                                 const typename Vecteur::value_type& b) {
+                                  return a.first < b.first; });
+                }
+                A[i] = toto;
+            }
+        }
+
+            /* Branch-free pivot key of an entry at level v:
+             * bit 63 is set when bit v of the value is not,
+             * bit 62 is set when the column would need to be permuted
+             * and privilegiate is on; low bits are the column density.
+             */
+        inline uint64_t key(const Word& val, const Index col, const size_t level,
+                            const uint64_t samecol, const std::vector<Index>& col2lab, const size_t rank) const {
+            const uint64_t invalid( (uint64_t)(~(val >> level)) & 1U );
+            const uint64_t moved( samecol & (uint64_t)(col2lab[col] != rank) );
+            return (invalid << 63) | (moved << 62) | (uint64_t)_colDensity[col];
+        }
+
+        bool findPivot(size_t& prow, size_t& ppos, const size_t rank, const size_t level,
+                       const bool privilegiate, const std::vector<Index>& col2lab) const {
+            static const uint64_t INVALID( uint64_t(1U)<<63 );
+            static const uint64_t MOVED( uint64_t(1U)<<62 );
+            const uint64_t samecol(privilegiate);
+            bool found(false), bestmoved(true);
+            size_t bestsize(std::numeric_limits<size_t>::max());
+            const size_t Ni(_order.size());
+            for(size_t t=rank; t<Ni; ++t) {
+                const Slice& s(_rows[_order[t]]);
+                if (! s.size) continue;
+                    // A row not smaller can only win by avoiding a column permutation
+                if ( (s.size >= bestsize) && ! (bestmoved && samecol) ) continue;
+                uint64_t rkey(~uint64_t(0U)); size_t rpos(0);
+                for(size_t l=0; l<s.size; ++l) {
+                    const uint64_t k( key(_vals[s.offset+l], _cols[s.offset+l], level, samecol, col2lab, rank) );
+                    const bool better(k < rkey);
+                    rkey = better ? k : rkey;
+                    rpos = better ? l : rpos;
+                }
+                if (rkey & INVALID) continue;
+                const bool rmoved( rkey & MOVED );
+                if ( (! found) || (rmoved < bestmoved)
+                     || ( (rmoved == bestmoved) && (s.size < bestsize) ) ) {
+                    found = true; bestmoved = rmoved; bestsize = s.size;
+                    prow = t; ppos = rpos;
+                    if ( (! rmoved) && (s.size == 1) ) break;
+                }
+            }
+            return found;
+        }
+
+        static inline size_t locate(const Index* cols, const size_t n, const Index col) {
+            return (size_t)(std::lower_bound(cols, cols+n, col)-cols);
+        }
+
+            // Append an empty row at the arena tail, compacting beforehand if needed
+        void reserveTail(const size_t extra) {
+            if ( (_garbage > (_cols.size()>>1)) && (_cols.size()+extra > _cols.capacity()) )
+                compact();
+        }
+
+        void compact() {
+            std::vector<size_t> byoffset(_rows.size());
+            for(size_t i=0; i<_rows.size(); ++i) byoffset[i] = i;
+            std::sort(byoffset.begin(), byoffset.end(), [this](size_t a, size_t b) {
+                    return _rows[a].offset < _rows[b].offset; });
+            size_t w(0);
+            for(auto const& i: byoffset) {
+                Slice& s(_rows[i]);
+                if (s.offset != w) {
+                    std::copy(_cols.begin()+s.offset, _cols.begin()+s.offset+s.size, _cols.begin()+w);
+                    std::copy(_vals.begin()+s.offset, _vals.begin()+s.offset+s.size, _vals.begin()+w);
+                }
+                s.offset = w;
+                w += s.size;
+            }
+            _cols.resize(w); _vals.resize(w);
+            _garbage = 0;
+        }
+
+            /* Row operations for pivot row pr at column pcol:
+             * first collect every active row with a non-zero in pcol
+             * with its head coefficient, then merge them one after the
+             * other into the arena tail.
+             */
+        void eliminate(const size_t start, const size_t pr, const Index pcol, const Word& invpiv,
+                       const size_t level, const Word& MASK) {
+            std::vector<std::pair<size_t,Word> > batch;
+            size_t remaining(_colDensity[pcol]);
+            const size_t Ni(_order.size());
+            for(size_t t=start; (t<Ni) && remaining; ++t) {
+                const Slice& s(_rows[_order[t]]);
+                if (! s.size) continue; // its offset may be the arena end
+                const size_t pos( locate(&_cols[s.offset], s.size, pcol) );
+                if ( (pos < s.size) && (_cols[s.offset+pos] == pcol) ) {
+                    batch.emplace_back(_order[t], ((_vals[s.offset+pos] >> level) * invpiv) & MASK);
+                    --remaining;
+                }
+            }
+
+            for(auto const& target: batch) {
+                const size_t npiv(_rows[pr].size);
+                const size_t ncur(_rows[target.first].size);
+                reserveTail(npiv+ncur);
+                    // after a possible compaction
+                const Slice piv(_rows[pr]), cur(_rows[target.first]);
+                const Word headcoeff(target.second);
+                const size_t newoffset(_cols.size());
+                size_t m(0), l(0);
+                while ( (m < cur.size) || (l < piv.size) ) {
+                    const Index cm( m<cur.size ? _cols[cur.offset+m] : std::numeric_limits<Index>::max() );
+                    const Index cl( l<piv.size ? _cols[piv.offset+l] : std::numeric_limits<Index>::max() );
+                    if (cm < cl) {
+                        const Word a(_vals[cur.offset+m]);
+                        _cols.push_back(cm); _vals.push_back(a);
+                        ++m;
+                    } else {
+                        const Word a( cm == cl ? _vals[cur.offset+m] : Word(0U) );
+                        const Word r( (a - headcoeff * _vals[piv.offset+l]) & MASK );
+                        if (cm == cl) ++m;
+                        if (r) {
+                            _cols.push_back(cl); _vals.push_back(r);
+                            if (a == 0U) ++_colDensity[cl];
+                        } else if (a != 0U)
+                            --_colDensity[cl];
+                        ++l;
+                    }
+                }
+                _rows[target.first].offset = newoffset;
+                _rows[target.first].size = _cols.size()-newoffset;
+                _live += _rows[target.first].size;
+                _live -= cur.size;
+                _garbage += cur.size;
+            }
+        }
+    };
+
+} // end of LinBox namespace
+
+#endif  //__LINBOX_pp_gauss_poweroftwo_packed_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
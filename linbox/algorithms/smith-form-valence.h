@@ -219,6 +219,7 @@ std::vector<size_t>& PRank(std::vector<size_t>& ranks, size_t& effective_exponen
 
 #include <linbox/field/gf2.h>
 #include <linbox/algorithms/smith-form-sparseelim-poweroftwo.h>
+#include <linbox/algorithms/smith-form-sparseelim-poweroftwo-packed.h>
 
 namespace LinBox {
 
@@ -228,14 +229,14 @@ std::vector<size_t>& PRankPowerOfTwo(std::vector<size_t>& ranks, size_t& effecti
     std::ostringstream logreport;
 #endif
 	effective_exponent = e;
-	if (e > 63) {
+	if (e > 64) {
 #if __LB_VALENCE_REPORTING__
 		{
             logreport << "Power rank power of two might need extra large composite (2^" << e << ")." << std::endl;
-            logreport << "First trying: 63, without further warning this will be sufficient)." << std::endl;
+            logreport << "First trying: 64, without further warning this will be sufficient)." << std::endl;
         }
 #endif
-		effective_exponent = 63;
+		effective_exponent = 64;
 	}
 
 
@@ -245,7 +246,7 @@ std::vector<size_t>& PRankPowerOfTwo(std::vector<size_t>& ranks, size_t& effecti
 	MatrixStream<Ring> ms( F, input );
 	SparseMatrix<Ring,SparseMatrixFormat::SparseSeq > A (ms);
 	input.close();
-	PowerGaussDomainPowerOfTwo< uint64_t > PGD;
+	PowerGaussDomainPowerOfTwoPacked< uint64_t > PGD;
     GF2 F2;
     Permutation<GF2> Q(F2,A.coldim());
 
@@ -292,6 +293,35 @@ std::vector<size_t>& PRankInteger(std::vector<size_t>& ranks, const char * filen
 
 std::vector<size_t>& PRankIntegerPowerOfTwo(std::vector<size_t>& ranks, const char * filename, size_t e, size_t intr)
 {
+#ifdef __SIZEOF_INT128__
+	if (e <= PowerGaussDomainPowerOfTwoPacked< unsigned __int128 >::maxExponent()) {
+            // Still native words: 128-bit wrap-around arithmetic,
+            // entries are read as integers and reduced modulo 2^128
+		typedef Givaro::ZRing<Givaro::Integer> Ring;
+		Ring F;
+		std::ifstream input(filename);
+		MatrixStream<Ring> ms( F, input );
+		SparseMatrix<Ring,SparseMatrixFormat::SparseSeq > A (ms);
+		input.close();
+		PowerGaussDomainPowerOfTwoPacked< unsigned __int128 > PGD;
+		GF2 F2;
+		Permutation<GF2> Q(F2,A.coldim());
+
+		Timer tim; tim.clear(); tim.start();
+		PGD.prime_power_rankin( e, ranks, A, Q, A.rowdim(), A.coldim(), std::vector<size_t>());
+		tim.stop();
+#if __LB_VALENCE_REPORTING__
+		{
+			std::ostringstream logreport;
+			F.write(logreport << "Ranks over ") << " modulo 2^" << e << " are " ;
+			for(auto const& rit: ranks) logreport << rit << ' ';
+			logreport << ' ' << tim << std::endl;
+			std::clog << logreport.str();
+		}
+#endif
+		return ranks;
+	}
+#endif
 	typedef Givaro::ZRing<Givaro::Integer> Ring;
 	Ring ZZ;
 	std::ifstream input(filename);
@@ -88,6 +88,12 @@ namespace LinBox
 	 * somehow be converted to dense vectors before this matrix may
 	 * be applied to them.
 	 *
+	 * The switches are applied through a schedule built once: they are
+	 * regrouped in stages of disjoint pairs, stored contiguously as runs of
+	 * pairs at a constant stride. The leading stages which only mix entries
+	 * within blocks of ScheduleBlock rows are done block by block, while the
+	 * block is in cache, and the other stages are whole passes.
+	 *
 	 * @param Vector LinBox dense vector type
 	 * @param Switch switch object type
 	 \ingroup blackbox
@@ -159,6 +165,19 @@ namespace LinBox
 		template<class OutVector, class InVector>
 		OutVector& applyTranspose (OutVector& y, const InVector& x) const;
 
+		/** Block application, <code>Y = A*X</code>, on dense matrices.
+		 * Each switch mixes two rows of Y (vectorized by FFLAS for
+		 * CekstvSwitch).
+		 */
+		template<class Matrix>
+		Matrix& applyLeft (Matrix& Y, const Matrix& X) const;
+
+		/** Block application, <code>Y = X*A</code>, on dense matrices.
+		 * Each switch transpose mixes two columns of Y.
+		 */
+		template<class Matrix>
+		Matrix& applyRight (Matrix& Y, const Matrix& X) const;
+
 		template<typename _Tp1, typename _Sw1 = typename Switch::template rebind<_Tp1>::other>
 		struct rebind {
 			typedef Butterfly<_Tp1, _Sw1> other;
@@ -176,6 +195,7 @@ namespace LinBox
 					typename Switch::template rebind<_Tp1>() (newsw, *sit, Ap.field(), A.field());
 					Ap.switches().push_back( newsw );
 				}
+				Ap.buildSchedule();
 				//             Ap = new other(LAp);
 			}
 		};
@@ -225,6 +245,12 @@ namespace LinBox
 		{ return this->_switches.end(); }
 		std::vector<Switch>& switches() { return _switches; }
 
+		/// Rebuilds the schedule from indices() and switches()
+		void buildSchedule ();
+
+		/// Rows of the blocks in which the leading stages are fused
+		static const size_t ScheduleBlock = 4096;
+
 
 	private:
 
@@ -251,6 +277,22 @@ namespace LinBox
 		// Build the vector of indices
 		void buildIndices ();
 
+		// Switches _ordered[offset + k] on the pairs
+		// (first + k*stride, second + k*stride), for k < length
+		struct Run {
+			size_t first, second, stride, length, offset;
+		};
+
+		// The switches in the order of the schedule, and its runs:
+		// first those of the fused stages, block by block, then the others.
+		std::vector<Switch> _ordered;
+		std::vector<Run> _runs;
+
+		// Mixes of rows or columns x and y, of len elements with increment inc
+		template<class Sw>
+		void mix (const Sw& s, Element* x, Element* y, size_t len, size_t inc, bool transposed) const;
+		void mix (const CekstvSwitch<Field>& s, Element* x, Element* y, size_t len, size_t inc, bool transposed) const;
+
 	}; // template <class Field, class Vector> class Butterfly
 
 	/** A function used with Butterfly Blackbox Matrices.
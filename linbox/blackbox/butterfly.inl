@@ -47,10 +47,13 @@
 #ifndef __LINBOX_butterfly_INL
 #define __LINBOX_butterfly_INL
 
+#include <algorithm>
 #include <vector>
+#include "fflas-ffpack/fflas/fflas.h"
 #include "linbox/blackbox/blackbox-interface.h"
 #include "linbox/vector/vector-domain.h"
 #include "linbox/field/hom.h"
+#include "linbox/util/debug.h"
 
 /** @file blackbox/butterfly.inl
  *
@@ -70,19 +73,21 @@ namespace LinBox
 
 		for (unsigned int i = 0; i < _indices.size (); ++i)
 			_switches.push_back (factory.makeSwitch ());
+
+		buildSchedule ();
 	}
 
 	template <class Field, class Switch>
 	template<class OutVector, class InVector>
 	inline OutVector& Butterfly<Field, Switch>::apply (OutVector& y, const InVector& x) const
 	{
-		std::vector< std::pair<size_t, size_t> >::const_iterator idx_iter = _indices.begin ();
-		typename std::vector<Switch>::const_iterator switch_iter = _switches.begin ();
-
 		_VD.copy (y, x);
 
-		for (; idx_iter != _indices.end (); ++idx_iter, ++switch_iter)
-			switch_iter->apply (field(), y[idx_iter->first], y[idx_iter->second]);
+		for (const Run& r : _runs) {
+			const Switch* s = _ordered.data () + r.offset;
+			for (size_t k = 0, i = r.first, j = r.second; k < r.length; ++k, i += r.stride, j += r.stride)
+				s[k].apply (field(), y[i], y[j]);
+		}
 
 		return y;
 	}
@@ -91,17 +96,143 @@ namespace LinBox
 	template <class OutVector, class InVector>
 	inline OutVector& Butterfly<Field, Switch>::applyTranspose (OutVector& y, const InVector& x) const
 	{
-		std::vector< std::pair<size_t, size_t> >::const_reverse_iterator idx_iter = _indices.rbegin ();
-		typename std::vector<Switch>::const_reverse_iterator switch_iter = _switches.rbegin ();
-
 		_VD.copy (y, x);
 
-		for (; idx_iter != _indices.rend (); ++idx_iter, ++switch_iter)
-			switch_iter->applyTranspose (field(), y[idx_iter->first], y[idx_iter->second]);
+		// Reverse order of the stages; the pairs of a stage are disjoint
+		for (auto rit = _runs.rbegin (); rit != _runs.rend (); ++rit) {
+			const Switch* s = _ordered.data () + rit->offset;
+			for (size_t k = 0, i = rit->first, j = rit->second; k < rit->length; ++k, i += rit->stride, j += rit->stride)
+				s[k].applyTranspose (field(), y[i], y[j]);
+		}
 
 		return y;
 	}
 
+	template <class Field, class Switch>
+	template <class Matrix>
+	inline Matrix& Butterfly<Field, Switch>::applyLeft (Matrix& Y, const Matrix& X) const
+	{
+		linbox_check (X.rowdim () == _n && Y.rowdim () == _n && X.coldim () == Y.coldim ());
+		const size_t b = X.coldim (), ld = Y.getStride ();
+		FFLAS::fassign (field(), _n, b, X.getPointer (), X.getStride (), Y.getPointer (), ld);
+
+		Element* p = Y.getPointer ();
+		for (const Run& r : _runs) {
+			const Switch* s = _ordered.data () + r.offset;
+			for (size_t k = 0, i = r.first, j = r.second; k < r.length; ++k, i += r.stride, j += r.stride)
+				mix (s[k], p + i*ld, p + j*ld, b, 1, false);
+		}
+
+		return Y;
+	}
+
+	template <class Field, class Switch>
+	template <class Matrix>
+	inline Matrix& Butterfly<Field, Switch>::applyRight (Matrix& Y, const Matrix& X) const
+	{
+		linbox_check (X.coldim () == _n && Y.coldim () == _n && X.rowdim () == Y.rowdim ());
+		const size_t b = X.rowdim (), ld = Y.getStride ();
+		FFLAS::fassign (field(), b, _n, X.getPointer (), X.getStride (), Y.getPointer (), ld);
+
+		// Each row of Y is transformed by the transpose
+		Element* p = Y.getPointer ();
+		for (auto rit = _runs.rbegin (); rit != _runs.rend (); ++rit) {
+			const Switch* s = _ordered.data () + rit->offset;
+			for (size_t k = 0, i = rit->first, j = rit->second; k < rit->length; ++k, i += rit->stride, j += rit->stride)
+				mix (s[k], p + i, p + j, b, ld, true);
+		}
+
+		return Y;
+	}
+
+	template <class Field, class Switch>
+	template <class Sw>
+	inline void Butterfly<Field, Switch>::mix (const Sw& s, Element* x, Element* y,
+						   size_t len, size_t inc, bool transposed) const
+	{
+		for (size_t k = 0; k < len*inc; k += inc)
+			if (transposed)
+				s.applyTranspose (field(), x[k], y[k]);
+			else
+				s.apply (field(), x[k], y[k]);
+	}
+
+	// x += a y, y += x, or transposed x += y, y += a x, on whole rows or columns
+	template <class Field, class Switch>
+	inline void Butterfly<Field, Switch>::mix (const CekstvSwitch<Field>& s, Element* x, Element* y,
+						   size_t len, size_t inc, bool transposed) const
+	{
+		if (transposed) {
+			FFLAS::faddin (field(), len, y, inc, x, inc);
+			FFLAS::faxpy (field(), len, s.getData (), x, inc, y, inc);
+		}
+		else {
+			FFLAS::faxpy (field(), len, s.getData (), y, inc, x, inc);
+			FFLAS::faddin (field(), len, x, inc, y, inc);
+		}
+	}
+
+	/* Each switch goes in the stage following the last one touching either
+	 * of its indices, so that the pairs of a stage are disjoint and the
+	 * stages keep the order of the switches acting on a same entry.
+	 * The leading stages whose pairs all lie in a same block of
+	 * ScheduleBlock rows are fused: their runs come block by block.
+	 */
+	template <class Field, class Switch>
+	void Butterfly<Field, Switch>::buildSchedule ()
+	{
+		linbox_check (_indices.size () == _switches.size ());
+		const size_t s = _indices.size ();
+
+		std::vector<size_t> stage (s), last (_n, 0);
+		size_t stages = 0;
+		for (size_t k = 0; k < s; ++k) {
+			const size_t i = _indices[k].first, j = _indices[k].second;
+			stage[k] = std::max (last[i], last[j]);
+			last[i] = last[j] = stage[k] + 1;
+			stages = std::max (stages, stage[k] + 1);
+		}
+
+		std::vector<bool> local (stages, true);
+		for (size_t k = 0; k < s; ++k)
+			if (_indices[k].first / ScheduleBlock != _indices[k].second / ScheduleBlock)
+				local[stage[k]] = false;
+		size_t fused = 0;
+		while (fused < stages && local[fused]) ++fused;
+
+		// Sort key: (block, stage) for the fused stages, then the stage
+		const size_t blocks = (_n + ScheduleBlock - 1) / ScheduleBlock;
+		auto key = [&] (size_t k) -> size_t {
+			return (stage[k] < fused)
+				? (_indices[k].first / ScheduleBlock) * fused + stage[k]
+				: blocks * fused + stage[k] - fused;
+		};
+		std::vector<size_t> order (s);
+		for (size_t k = 0; k < s; ++k) order[k] = k;
+		std::stable_sort (order.begin (), order.end (), [&] (size_t a, size_t b) { return key (a) < key (b); });
+
+		_ordered.clear ();
+		_ordered.reserve (s);
+		_runs.clear ();
+		for (size_t t = 0; t < s; ++t) {
+			const size_t k = order[t];
+			const size_t i = _indices[k].first, j = _indices[k].second;
+			_ordered.push_back (_switches[k]);
+
+			if (! _runs.empty () && key (order[t-1]) == key (k)) {
+				Run& r = _runs.back ();
+				const size_t li = r.first + (r.length - 1) * r.stride;
+				const size_t lj = r.second + (r.length - 1) * r.stride;
+				if (i > li && j > lj && i - li == j - lj && (r.length == 1 || i - li == r.stride)) {
+					r.stride = i - li;
+					++r.length;
+					continue;
+				}
+			}
+			_runs.push_back (Run{ i, j, 1, 1, t });
+		}
+	}
+
 	template <class Field, class Switch>
 	void Butterfly<Field, Switch>::buildIndices ()
 	{
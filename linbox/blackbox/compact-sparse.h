@@ -0,0 +1,300 @@
+/* linbox/blackbox/compact-sparse.h
+ * Copyright (C) LinBox
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file blackbox/compact-sparse.h
+ * @ingroup blackbox
+ * @brief Compressed sparse rows with 32-bit indices and narrow values.
+ */
+
+#ifndef __LINBOX_blackbox_compact_sparse_H
+#define __LINBOX_blackbox_compact_sparse_H
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include <cstdint>
+#include <cmath>
+
+#include "linbox/integer.h"
+#include "linbox/util/debug.h"
+#include "linbox/util/error.h"
+#include "linbox/util/field-axpy.h"
+#include "linbox/field/hom.h"
+#include "linbox/blackbox/blackbox-interface.h"
+
+namespace LinBox
+{
+
+	/** \brief Bandwidth-lean sparse blackbox for word-size modular fields.
+	 *
+	 * Rows are stored CSR-like with 32-bit column ids, or, when
+	 * \p deltaEncoded, as LEB128 varints of the gaps between consecutive
+	 * column ids.  Values are the field representatives narrowed to
+	 * \p _Value (e.g. int16_t for p < 2^15 with Modular<double> or
+	 * ModularBalanced<double>); apply widens them back on the fly and
+	 * accumulates with FieldAXPY, so a non-zero costs
+	 * sizeof(_Value)+4 bytes, or sizeof(_Value)+1 for dense enough rows.
+	 *
+	 * \tparam _Field a field whose Element is an arithmetic type
+	 * \tparam _Value an integral type holding every representative
+	 * \ingroup blackbox
+	 */
+	template<class _Field, class _Value = int16_t>
+	class CompactSparseMatrix : public BlackboxInterface {
+	public:
+		typedef _Field                            Field;
+		typedef typename Field::Element           Element;
+		typedef _Value                            Value;
+		typedef uint32_t                          Index;
+		typedef CompactSparseMatrix<_Field,_Value> Self_t;
+
+		static_assert(std::is_arithmetic<Element>::value, "CompactSparseMatrix needs machine word elements");
+		static_assert(std::is_integral<Value>::value, "CompactSparseMatrix stores integral values");
+
+		/** Compress any matrix providing IndexedBegin()/IndexedEnd().
+		 * @param A source matrix, over the same field
+		 * @param deltaEncoded varint-encode the column gaps
+		 */
+		template<class _Matrix>
+		CompactSparseMatrix (const _Matrix& A, bool deltaEncoded = false) :
+			_field(&A.field()), _rowdim(A.rowdim()), _coldim(A.coldim()),
+			_delta(deltaEncoded)
+		{
+			std::vector<Triple> T;
+			for(auto it = A.IndexedBegin(); it != A.IndexedEnd(); ++it)
+				if (! field().isZero(it.value()))
+					T.emplace_back(it.rowIndex(), it.colIndex(), it.value());
+			build(T);
+		}
+
+		/// Same matrix over another field, for CRA loops
+		template<class _Tp1, class _V1>
+		CompactSparseMatrix (const CompactSparseMatrix<_Tp1,_V1>& A, const Field& F) :
+			_field(&F), _rowdim(A.rowdim()), _coldim(A.coldim()),
+			_delta(A.isDeltaEncoded())
+		{
+			Hom<_Tp1, Field> hom(A.field(), F);
+			std::vector<Triple> T;
+			T.reserve(A.nnz());
+			Element e;
+			A.forEach([&](size_t i, size_t j, const typename _Tp1::Element& a) {
+					hom.image(e, a);
+					if (! F.isZero(e)) T.emplace_back(i, j, e);
+				});
+			build(T);
+		}
+
+		template<typename _Tp1, typename _V1 = _Value>
+		struct rebind {
+			typedef CompactSparseMatrix<_Tp1, _V1> other;
+			void operator() (other & Ap, const Self_t& A)
+			{
+				Ap = other(A, Ap.field());
+			}
+		};
+
+		/// y <- A x
+		template<class OutVector, class InVector>
+		OutVector& apply (OutVector& y, const InVector& x) const
+		{
+			linbox_check(y.size() >= _rowdim);
+			linbox_check(x.size() >= _coldim);
+			FieldAXPY<Field> acc(field());
+			for(size_t i=0; i<_rowdim; ++i) {
+				acc.reset();
+				if (_delta) {
+					const uint8_t* p = _bytes.data() + _start[i];
+					Index j(0);
+					for(size_t k=_valstart[i]; k<_valstart[i+1]; ++k) {
+						j += readVarint(p);
+						acc.mulacc(static_cast<Element>(_vals[k]), x[j]);
+					}
+				}
+				else {
+					for(size_t k=_valstart[i]; k<_valstart[i+1]; ++k)
+						acc.mulacc(static_cast<Element>(_vals[k]), x[_colid[k]]);
+				}
+				acc.get(y[i]);
+			}
+			return y;
+		}
+
+		/** y <- A^T x.
+		 * The column accumulators are local to the call, so applies of one
+		 * matrix may run in several threads at once.
+		 */
+		template<class OutVector, class InVector>
+		OutVector& applyTranspose (OutVector& y, const InVector& x) const
+		{
+			linbox_check(y.size() >= _coldim);
+			linbox_check(x.size() >= _rowdim);
+			std::vector<FieldAXPY<Field> > acc(_coldim, FieldAXPY<Field>(field()));
+			forEachValue([&](size_t i, size_t j, const Value& v) {
+					acc[j].mulacc(static_cast<Element>(v), x[i]);
+				});
+			for(size_t j=0; j<_coldim; ++j) acc[j].get(y[j]);
+			return y;
+		}
+
+		/// Calls f(i,j,a) on every non-zero, row by row
+		template<class Func>
+		void forEach (Func f) const
+		{
+			forEachValue([&](size_t i, size_t j, const Value& v) {
+					f(i, j, static_cast<Element>(v));
+				});
+		}
+
+		size_t rowdim () const { return _rowdim; }
+		size_t coldim () const { return _coldim; }
+		size_t nnz () const { return _vals.size(); }
+		bool isDeltaEncoded () const { return _delta; }
+		const Field& field () const { return *_field; }
+
+		/// Bytes used by the index and value arrays
+		size_t bytes () const
+		{
+			return _vals.size()*sizeof(Value) + _colid.size()*sizeof(Index)
+				+ _bytes.size() + (_start.size()+_valstart.size())*sizeof(size_t);
+		}
+
+		std::ostream& write (std::ostream& os) const
+		{
+			os << _rowdim << ' ' << _coldim << " M" << std::endl;
+			forEach([&](size_t i, size_t j, const Element& a) {
+					field().write(os << i+1 << ' ' << j+1 << ' ', a) << std::endl;
+				});
+			return os << "0 0 0" << std::endl;
+		}
+
+	protected:
+		struct Triple {
+			size_t i, j; Element a;
+			Triple (size_t r, size_t c, const Element& e) : i(r), j(c), a(e) {}
+			bool operator< (const Triple& t) const { return (i < t.i) || ( (i == t.i) && (j < t.j) ); }
+		};
+
+		void build (std::vector<Triple>& T)
+		{
+			if (_coldim > (size_t)std::numeric_limits<Index>::max())
+				throw LinboxError("CompactSparseMatrix: too many columns for 32-bit column ids");
+			std::sort(T.begin(), T.end());
+			_vals.resize(0); _vals.reserve(T.size());
+			_colid.resize(0); _bytes.resize(0);
+			if (! _delta) _colid.reserve(T.size());
+			_valstart.assign(_rowdim+1, 0);
+			_start.assign(_delta ? _rowdim+1 : 0, 0);
+
+			auto t = T.begin();
+			for(size_t i=0; i<_rowdim; ++i) {
+				if (_delta) _start[i] = _bytes.size();
+				Index prev(0);
+				for( ; (t != T.end()) && (t->i == i); ++t) {
+					if (! fits(t->a, std::is_floating_point<Element>()))
+						throw LinboxError("CompactSparseMatrix: representative does not fit the value type");
+					_vals.push_back(static_cast<Value>(t->a));
+					if (_delta) {
+						writeVarint((Index)t->j - prev);
+						prev = (Index)t->j;
+					}
+					else
+						_colid.push_back((Index)t->j);
+				}
+				_valstart[i+1] = _vals.size();
+			}
+			if (_delta) _start[_rowdim] = _bytes.size();
+		}
+
+		// a is a representable integer, checked before any conversion to Value
+		static bool fits (const Element& a, std::true_type)
+		{
+			return (a == std::floor(a))
+				&& (a >= static_cast<Element>(std::numeric_limits<Value>::min()))
+				&& (a < std::ldexp(Element(1), std::numeric_limits<Value>::digits));
+		}
+
+		static bool fits (const Element& a, std::false_type)
+		{
+			if (a < Element(0))
+				return std::is_signed<Value>::value
+					&& (static_cast<intmax_t>(a) >= static_cast<intmax_t>(std::numeric_limits<Value>::min()));
+			return static_cast<uintmax_t>(a) <= static_cast<uintmax_t>(std::numeric_limits<Value>::max());
+		}
+
+		template<class Func>
+		void forEachValue (Func f) const
+		{
+			for(size_t i=0; i<_rowdim; ++i) {
+				if (_delta) {
+					const uint8_t* p = _bytes.data() + _start[i];
+					Index j(0);
+					for(size_t k=_valstart[i]; k<_valstart[i+1]; ++k) {
+						j += readVarint(p);
+						f(i, j, _vals[k]);
+					}
+				}
+				else
+					for(size_t k=_valstart[i]; k<_valstart[i+1]; ++k)
+						f(i, _colid[k], _vals[k]);
+			}
+		}
+
+		void writeVarint (Index d)
+		{
+			while (d >= 0x80) {
+				_bytes.push_back( uint8_t(d | 0x80) );
+				d >>= 7;
+			}
+			_bytes.push_back( uint8_t(d) );
+		}
+
+		static inline Index readVarint (const uint8_t*& p)
+		{
+			Index d( *p & 0x7F );
+			for(unsigned s=7; *p++ & 0x80; s+=7)
+				d |= Index(*p & 0x7F) << s;
+			return d;
+		}
+
+		const Field*          _field;
+		size_t                _rowdim;
+		size_t                _coldim;
+		bool                  _delta;
+		std::vector<Value>    _vals;     //!< narrowed representatives
+		std::vector<Index>    _colid;    //!< column ids (plain rows)
+		std::vector<uint8_t>  _bytes;    //!< varint column gaps (delta rows)
+		std::vector<size_t>   _start;    //!< row starts in _bytes
+		std::vector<size_t>   _valstart; //!< row starts in _vals
+	};
+
+} // LinBox
+
+#endif // __LINBOX_blackbox_compact_sparse_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
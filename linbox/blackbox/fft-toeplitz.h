@@ -0,0 +1,510 @@
+/* linbox/blackbox/fft-toeplitz.h
+ * Copyright (C) LinBox
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file blackbox/fft-toeplitz.h
+ * @ingroup blackbox
+ * @brief Toeplitz, Hankel and block Hankel blackboxes applied through the \ref FFT of the field.
+ *
+ * Unlike Toeplitz<Field,PRing>, these need no polynomial ring (and no NTL):
+ * the transform of the symbol is computed once at construction, and an apply
+ * is a forward transform, a pointwise product and an inverse transform.
+ * The fields are those of FFT<Field,Simd> (Givaro::Modular over word size
+ * elements). When p-1 has no large enough power of two, the same products are
+ * done naively.
+ */
+
+#ifndef __LINBOX_bb_fft_toeplitz_H
+#define __LINBOX_bb_fft_toeplitz_H
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "linbox/linbox-config.h"
+#include "linbox/integer.h"
+#include "linbox/util/debug.h"
+#include "linbox/blackbox/blackbox-interface.h"
+#include "linbox/matrix/dense-matrix.h"
+#include "linbox/algorithms/polynomial-matrix/fft.h"
+
+namespace LinBox
+{
+	namespace Protected {
+
+		/* Middle products y_i = sum_j h[nin-1+i-j] x_j, for 0 <= i < nout, with
+		 * h of length nin+nout-1. With the FFT, a cyclic convolution of length
+		 * N >= nin+nout-1 gives them exactly; the symbols are stored transformed
+		 * and scaled by 1/N, so that the inverse transform needs no scaling.
+		 * Without it, the symbols are stored as is and mulacc is quadratic.
+		 * The input and the result are at the same place in a buffer:
+		 * y_i is acc[nin-1+i] after unload.
+		 */
+		template <class Field, class Simd>
+		class ToeplitzKernel {
+		public:
+			typedef typename Field::Element Element;
+			typedef typename Simd::aligned_vector Buffer;
+			typedef FFT<Field, Simd> Transform;
+
+			ToeplitzKernel (const Field& F, size_t len) :
+				_field(&F), _len(len), _size(len)
+			{
+				size_t lpts = 0, pts = 1;
+				while (pts < std::max<size_t>(len, 4 * Simd::vect_size)) { pts <<= 1; ++lpts; }
+				integer p;
+				F.characteristic(p);
+				if (((p - 1) % integer(pts)) != 0) return;
+
+				auto fwd = std::make_shared<const Transform>(F, lpts);
+				_inv = std::make_shared<const Transform>(F, lpts, fwd->invroot());
+				_fwd = fwd;
+				_size = pts;
+			}
+
+			bool usesFFT () const { return (bool)_fwd; }
+
+			const Field& field () const { return *_field; }
+
+			Buffer buffer () const { return Buffer(_size, field().zero); }
+
+			/// Symbol of h (_len elements), reversed if asked
+			void symbol (Buffer& hat, const std::vector<Element>& h, bool reversed) const
+			{
+				linbox_check(h.size() == _len);
+				hat = buffer();
+				for (size_t k = 0; k < _len; ++k)
+					field().assign(hat[k], h[reversed ? _len - 1 - k : k]);
+				if (! usesFFT()) return;
+
+				Element scale;
+				field().init(scale, (uint64_t)_size);
+				field().invin(scale);
+				for (size_t k = 0; k < _len; ++k)
+					field().mulin(hat[k], scale);
+				_fwd->FFT_direct(hat.data());
+			}
+
+			/// The nin entries x(j) of an input
+			template <class In>
+			void load (Buffer& buf, const In& x, size_t nin) const
+			{
+				std::fill(buf.begin(), buf.end(), field().zero);
+				for (size_t j = 0; j < nin; ++j)
+					field().assign(buf[j], x(j));
+				if (usesFFT())
+					_fwd->FFT_direct(buf.data());
+			}
+
+			/// acc += (symbol hat) * (loaded input x)
+			void mulacc (Buffer& acc, const Buffer& hat, const Buffer& x, size_t nin, size_t nout) const
+			{
+				if (usesFFT()) {
+					for (size_t k = 0; k < _size; ++k)
+						field().axpyin(acc[k], hat[k], x[k]);
+					return;
+				}
+				for (size_t i = 0; i < nout; ++i)
+					for (size_t j = 0; j < nin; ++j)
+						field().axpyin(acc[nin - 1 + i], hat[nin - 1 + i - j], x[j]);
+			}
+
+			/// Back from the transformed domain
+			void unload (Buffer& acc) const
+			{
+				if (usesFFT())
+					_inv->FFT_inverse(acc.data());
+			}
+
+		protected:
+			const Field* _field;
+			size_t _len;
+			size_t _size;
+			std::shared_ptr<const Transform> _fwd, _inv;
+		};
+	}
+
+	/** \brief Toeplitz blackbox applied through the FFT of the field.
+	 *
+	 * \ingroup blackbox
+	 * The m x n matrix T[i][j] = v[n-1+i-j] is given by the m+n-1 entries of v,
+	 * as for Toeplitz<Field,PRing>: v[0] is the top right entry, v[n-1] the
+	 * diagonal and v[m+n-2] the bottom left one.
+	 * The transforms of v and of its reverse (for the transpose) are cached.
+	 * The block applies run one transform per column, in parallel under
+	 * OpenMP unless setParallel(false).
+	 */
+	template <class _Field, class _Simd = Simd<typename _Field::Element> >
+	class FFTToeplitz : public BlackboxInterface {
+	public:
+		typedef _Field Field;
+		typedef typename Field::Element Element;
+		typedef Protected::ToeplitzKernel<Field, _Simd> Kernel;
+		typedef typename Kernel::Buffer Buffer;
+
+		FFTToeplitz (const Field& F, const std::vector<Element>& v, size_t m, size_t n = 0) :
+			_rowdim(m), _coldim(n ? n : m), _kernel(F, v.size()), _v(v), _parallel(true)
+		{
+			linbox_check(v.size() == _rowdim + _coldim - 1);
+			_kernel.symbol(_hat, _v, false);
+			_kernel.symbol(_hatT, _v, true);
+		}
+
+		//! Square matrix from its 2n-1 entries
+		FFTToeplitz (const Field& F, const BlasVector<Field>& v) :
+			FFTToeplitz(F, v.getRep(), (v.size() + 1) / 2)
+		{}
+
+		size_t rowdim () const { return _rowdim; }
+		size_t coldim () const { return _coldim; }
+		const Field& field () const { return _kernel.field(); }
+
+		//! Whether the applies go through the FFT (or are naive, for lack of roots of unity)
+		bool usesFFT () const { return _kernel.usesFFT(); }
+
+		void setParallel (bool parallel = true) { _parallel = parallel; }
+		bool isParallel () const { return _parallel; }
+
+		//! The m+n-1 entries, as given
+		const std::vector<Element>& symbol () const { return _v; }
+
+		template <class OutVector, class InVector>
+		OutVector& apply (OutVector& y, const InVector& x) const
+		{
+			linbox_check(y.size() == rowdim() && x.size() == coldim());
+			Buffer buf = _kernel.buffer(), acc = _kernel.buffer();
+			product(buf, acc, [&x](size_t j) -> Element { return x[j]; }, coldim(),
+				[&y](size_t i, const Element& e) { y[i] = e; }, rowdim(), false);
+			return y;
+		}
+
+		template <class OutVector, class InVector>
+		OutVector& applyTranspose (OutVector& y, const InVector& x) const
+		{
+			linbox_check(y.size() == coldim() && x.size() == rowdim());
+			Buffer buf = _kernel.buffer(), acc = _kernel.buffer();
+			product(buf, acc, [&x](size_t j) -> Element { return x[j]; }, rowdim(),
+				[&y](size_t i, const Element& e) { y[i] = e; }, coldim(), true);
+			return y;
+		}
+
+		//! Y = A X
+		template <class Matrix>
+		Matrix& applyLeft (Matrix& Y, const Matrix& X) const
+		{
+			linbox_check(Y.rowdim() == rowdim() && X.rowdim() == coldim() && X.coldim() == Y.coldim());
+			const long b = (long)X.coldim();
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(dynamic,1) if(_parallel && b > 1)
+#endif
+			for (long c = 0; c < b; ++c) {
+				Buffer buf = _kernel.buffer(), acc = _kernel.buffer();
+				product(buf, acc, [&X, c](size_t j) -> Element { return X.getEntry(j, (size_t)c); }, coldim(),
+					[&Y, c](size_t i, const Element& e) { Y.setEntry(i, (size_t)c, e); }, rowdim(), false);
+			}
+			return Y;
+		}
+
+		//! Y = X A
+		template <class Matrix>
+		Matrix& applyRight (Matrix& Y, const Matrix& X) const
+		{
+			linbox_check(Y.coldim() == coldim() && X.coldim() == rowdim() && X.rowdim() == Y.rowdim());
+			const long b = (long)X.rowdim();
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(dynamic,1) if(_parallel && b > 1)
+#endif
+			for (long r = 0; r < b; ++r) {
+				Buffer buf = _kernel.buffer(), acc = _kernel.buffer();
+				product(buf, acc, [&X, r](size_t j) -> Element { return X.getEntry((size_t)r, j); }, rowdim(),
+					[&Y, r](size_t i, const Element& e) { Y.setEntry((size_t)r, i, e); }, coldim(), true);
+			}
+			return Y;
+		}
+
+		std::ostream& write (std::ostream& os) const
+		{
+			os << rowdim() << " " << coldim() << " FFTToeplitz" << std::endl << "[";
+			for (size_t k = _v.size(); k-- > 0; )
+				field().write(os, _v[k]) << (k ? " " : "");
+			return os << "]" << std::endl;
+		}
+
+	protected:
+		// out(i, T x) or out(i, T^T x), i < nout, for the nin entries in(j)
+		template <class In, class Out>
+		void product (Buffer& buf, Buffer& acc, const In& in, size_t nin, const Out& out, size_t nout, bool transposed) const
+		{
+			_kernel.load(buf, in, nin);
+			std::fill(acc.begin(), acc.end(), field().zero);
+			_kernel.mulacc(acc, transposed ? _hatT : _hat, buf, nin, nout);
+			_kernel.unload(acc);
+			for (size_t i = 0; i < nout; ++i)
+				out(i, acc[nin - 1 + i]);
+		}
+
+		size_t _rowdim, _coldim;
+		Kernel _kernel;
+		std::vector<Element> _v;
+		Buffer _hat, _hatT;
+		bool _parallel;
+	};
+
+	/** \brief Hankel blackbox applied through the FFT of the field.
+	 *
+	 * \ingroup blackbox
+	 * The m x n matrix H[i][j] = h[i+j] is given by the m+n-1 entries of h:
+	 * h[0] is the top left entry and h[m+n-2] the bottom right one.
+	 * H is the Toeplitz matrix of the same entries with its columns reversed.
+	 */
+	template <class _Field, class _Simd = Simd<typename _Field::Element> >
+	class FFTHankel : public FFTToeplitz<_Field, _Simd> {
+		typedef FFTToeplitz<_Field, _Simd> Father_t;
+		using typename Father_t::Buffer;
+	public:
+		typedef typename Father_t::Field Field;
+		typedef typename Father_t::Element Element;
+
+		FFTHankel (const Field& F, const std::vector<Element>& h, size_t m, size_t n = 0) :
+			Father_t(F, h, m, n)
+		{}
+
+		using Father_t::rowdim;
+		using Father_t::coldim;
+		using Father_t::field;
+
+		template <class OutVector, class InVector>
+		OutVector& apply (OutVector& y, const InVector& x) const
+		{
+			linbox_check(y.size() == rowdim() && x.size() == coldim());
+			const size_t n = coldim();
+			Buffer buf = this->_kernel.buffer(), acc = this->_kernel.buffer();
+			this->product(buf, acc, [&x, n](size_t j) -> Element { return x[n - 1 - j]; }, n,
+				      [&y](size_t i, const Element& e) { y[i] = e; }, rowdim(), false);
+			return y;
+		}
+
+		// H^T = J T^T
+		template <class OutVector, class InVector>
+		OutVector& applyTranspose (OutVector& y, const InVector& x) const
+		{
+			linbox_check(y.size() == coldim() && x.size() == rowdim());
+			const size_t n = coldim();
+			Buffer buf = this->_kernel.buffer(), acc = this->_kernel.buffer();
+			this->product(buf, acc, [&x](size_t j) -> Element { return x[j]; }, rowdim(),
+				      [&y, n](size_t i, const Element& e) { y[n - 1 - i] = e; }, n, true);
+			return y;
+		}
+
+		//! Y = A X
+		template <class Matrix>
+		Matrix& applyLeft (Matrix& Y, const Matrix& X) const
+		{
+			linbox_check(Y.rowdim() == rowdim() && X.rowdim() == coldim() && X.coldim() == Y.coldim());
+			const long b = (long)X.coldim();
+			const size_t n = coldim();
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(dynamic,1) if(this->_parallel && b > 1)
+#endif
+			for (long c = 0; c < b; ++c) {
+				Buffer buf = this->_kernel.buffer(), acc = this->_kernel.buffer();
+				this->product(buf, acc, [&X, c, n](size_t j) -> Element { return X.getEntry(n - 1 - j, (size_t)c); }, n,
+					      [&Y, c](size_t i, const Element& e) { Y.setEntry(i, (size_t)c, e); }, rowdim(), false);
+			}
+			return Y;
+		}
+
+		//! Y = X A
+		template <class Matrix>
+		Matrix& applyRight (Matrix& Y, const Matrix& X) const
+		{
+			linbox_check(Y.coldim() == coldim() && X.coldim() == rowdim() && X.rowdim() == Y.rowdim());
+			const long b = (long)X.rowdim();
+			const size_t n = coldim();
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(dynamic,1) if(this->_parallel && b > 1)
+#endif
+			for (long r = 0; r < b; ++r) {
+				Buffer buf = this->_kernel.buffer(), acc = this->_kernel.buffer();
+				this->product(buf, acc, [&X, r](size_t j) -> Element { return X.getEntry((size_t)r, j); }, rowdim(),
+					      [&Y, r, n](size_t i, const Element& e) { Y.setEntry((size_t)r, n - 1 - i, e); }, n, true);
+			}
+			return Y;
+		}
+	};
+
+	/** \brief Block Hankel blackbox applied through the FFT of the field.
+	 *
+	 * \ingroup blackbox
+	 * The (r p) x (c q) matrix of p x q blocks H[i+j], 0 <= i < r, 0 <= j < c,
+	 * is given by the r+c-1 blocks H[k] (c = r by default, then their number
+	 * is odd). Entry (s,t) of the blocks is a scalar Hankel sequence: the p q
+	 * transforms of these sequences are cached, and an apply costs q forward
+	 * transforms, p q pointwise products and p inverse transforms. The p
+	 * inverse transforms of an apply, and the columns of a block apply, run
+	 * in parallel under OpenMP unless setParallel(false).
+	 *
+	 * This is the layout of BlockHankel with BlockHankelTag::plain, with the
+	 * blocks taken in the natural order.
+	 */
+	template <class _Field, class _Simd = Simd<typename _Field::Element> >
+	class FFTBlockHankel : public BlackboxInterface {
+	public:
+		typedef _Field Field;
+		typedef typename Field::Element Element;
+		typedef Protected::ToeplitzKernel<Field, _Simd> Kernel;
+		typedef typename Kernel::Buffer Buffer;
+
+		FFTBlockHankel (const Field& F, const std::vector<BlasMatrix<Field> >& H, size_t rowblocks = 0) :
+			_rowblocks(rowblocks ? rowblocks : (H.size() + 1) / 2),
+			_colblocks(H.size() + 1 - _rowblocks),
+			_p(H.front().rowdim()), _q(H.front().coldim()),
+			_kernel(F, H.size()), _hat(_p * _q), _hatT(_p * _q), _parallel(true)
+		{
+			linbox_check(rowblocks != 0 || (H.size() & 1));
+			linbox_check(_rowblocks <= H.size());
+			std::vector<Element> h(H.size());
+			for (size_t s = 0; s < _p; ++s)
+				for (size_t t = 0; t < _q; ++t) {
+					for (size_t k = 0; k < H.size(); ++k)
+						F.assign(h[k], H[k].getEntry(s, t));
+					_kernel.symbol(_hat[s * _q + t], h, false);
+					_kernel.symbol(_hatT[s * _q + t], h, true);
+				}
+		}
+
+		size_t rowdim () const { return _rowblocks * _p; }
+		size_t coldim () const { return _colblocks * _q; }
+		size_t rowblocks () const { return _rowblocks; }
+		size_t colblocks () const { return _colblocks; }
+		const Field& field () const { return _kernel.field(); }
+
+		bool usesFFT () const { return _kernel.usesFFT(); }
+
+		void setParallel (bool parallel = true) { _parallel = parallel; }
+		bool isParallel () const { return _parallel; }
+
+		template <class OutVector, class InVector>
+		OutVector& apply (OutVector& y, const InVector& x) const
+		{
+			linbox_check(y.size() == rowdim() && x.size() == coldim());
+			product([&x](size_t k) -> Element { return x[k]; },
+				[&y](size_t k, const Element& e) { y[k] = e; }, false, _parallel);
+			return y;
+		}
+
+		template <class OutVector, class InVector>
+		OutVector& applyTranspose (OutVector& y, const InVector& x) const
+		{
+			linbox_check(y.size() == coldim() && x.size() == rowdim());
+			product([&x](size_t k) -> Element { return x[k]; },
+				[&y](size_t k, const Element& e) { y[k] = e; }, true, _parallel);
+			return y;
+		}
+
+		//! Y = A X
+		template <class Matrix>
+		Matrix& applyLeft (Matrix& Y, const Matrix& X) const
+		{
+			linbox_check(Y.rowdim() == rowdim() && X.rowdim() == coldim() && X.coldim() == Y.coldim());
+			const long b = (long)X.coldim();
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(dynamic,1) if(_parallel && b > 1)
+#endif
+			for (long c = 0; c < b; ++c)
+				product([&X, c](size_t k) -> Element { return X.getEntry(k, (size_t)c); },
+					[&Y, c](size_t k, const Element& e) { Y.setEntry(k, (size_t)c, e); }, false, false);
+			return Y;
+		}
+
+		//! Y = X A
+		template <class Matrix>
+		Matrix& applyRight (Matrix& Y, const Matrix& X) const
+		{
+			linbox_check(Y.coldim() == coldim() && X.coldim() == rowdim() && X.rowdim() == Y.rowdim());
+			const long b = (long)X.rowdim();
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(dynamic,1) if(_parallel && b > 1)
+#endif
+			for (long r = 0; r < b; ++r)
+				product([&X, r](size_t k) -> Element { return X.getEntry((size_t)r, k); },
+					[&Y, r](size_t k, const Element& e) { Y.setEntry((size_t)r, k, e); }, true, false);
+			return Y;
+		}
+
+	protected:
+		/* y_i[s] = sum_{j,t} H[i+j][s][t] x_j[t]: a Hankel product per (s,t),
+		 * on the reversed input. Transposed, H^T = J T^T blockwise, with the
+		 * reversed sequences (as FFTHankel).
+		 */
+		template <class In, class Out>
+		void product (const In& in, const Out& out, bool transposed, bool parallel) const
+		{
+			const size_t nin = transposed ? _rowblocks : _colblocks;
+			const size_t nout = transposed ? _colblocks : _rowblocks;
+			const size_t win = transposed ? _p : _q;   // components of an input block
+			const size_t wout = transposed ? _q : _p;  // components of an output block
+
+			std::vector<Buffer> xhat(win, _kernel.buffer());
+			for (size_t t = 0; t < win; ++t) {
+				if (transposed)
+					_kernel.load(xhat[t], [&in, win, t](size_t j) -> Element { return in(j * win + t); }, nin);
+				else
+					_kernel.load(xhat[t], [&in, win, t, nin](size_t j) -> Element { return in((nin - 1 - j) * win + t); }, nin);
+			}
+
+			const long w = (long)wout;
+			(void)parallel;
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(dynamic,1) if(parallel && w > 1)
+#endif
+			for (long sl = 0; sl < w; ++sl) {
+				const size_t s = (size_t)sl;
+				Buffer acc = _kernel.buffer();
+				for (size_t t = 0; t < win; ++t) {
+					const size_t idx = transposed ? t * _q + s : s * _q + t;
+					_kernel.mulacc(acc, transposed ? _hatT[idx] : _hat[idx], xhat[t], nin, nout);
+				}
+				_kernel.unload(acc);
+				for (size_t i = 0; i < nout; ++i)
+					out((transposed ? nout - 1 - i : i) * wout + s, acc[nin - 1 + i]);
+			}
+		}
+
+		size_t _rowblocks, _colblocks;
+		size_t _p, _q;
+		Kernel _kernel;
+		std::vector<Buffer> _hat, _hatT;
+		bool _parallel;
+	};
+
+} // namespace LinBox
+
+#endif //__LINBOX_bb_fft_toeplitz_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
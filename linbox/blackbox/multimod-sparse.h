@@ -0,0 +1,278 @@
+/* linbox/blackbox/multimod-sparse.h
+ * Copyright (C) LinBox
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file blackbox/multimod-sparse.h
+ * @ingroup blackbox
+ * @brief One small integer sparse matrix applied modulo several primes at once.
+ */
+
+#ifndef __LINBOX_blackbox_multimod_sparse_H
+#define __LINBOX_blackbox_multimod_sparse_H
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#include "linbox/integer.h"
+#include "linbox/util/debug.h"
+#include "linbox/util/error.h"
+#include "linbox/field/multimod-field.h"
+#include "linbox/field/multimod-lanes.h"
+#include "linbox/blackbox/blackbox-interface.h"
+
+namespace LinBox
+{
+
+	/** \brief Integer sparse matrix applied modulo k primes in one sweep.
+	 *
+	 * CRA loops usually rebind the integer matrix once per prime and
+	 * traverse every copy separately.  Here the integer entries are
+	 * stored once, as exact doubles, and applied to residue vectors of
+	 * the MultiModDouble field laid out interleaved: residue l of entry
+	 * j sits at position j*k+l of a flat vector.  Each non-zero is thus
+	 * read once for the k primes, and the inner loop over the primes is
+	 * contiguous, hence vectorizable.
+	 *
+	 * Products are accumulated in double precision, and reduced only
+	 * every maxDelay() terms, so that no intermediate sum exceeds 2^53.
+	 * The transposed structure is stored as well, to keep
+	 * applyTranspose a row sweep.
+	 * \ingroup blackbox
+	 */
+	class MultiModSparseMatrix : public BlackboxInterface {
+	public:
+		typedef MultiModDouble         Field;
+		typedef Field::Element         Element;
+		typedef uint32_t               Index;
+		typedef std::vector<double>    InterleavedVector;
+
+		/** Stores A once for all the primes of F.
+		 * @param A integer matrix providing IndexedBegin()/IndexedEnd()
+		 * @param F the primes; every product |a|(p-1) must stay well below 2^53
+		 */
+		template<class _Matrix>
+		MultiModSparseMatrix (const _Matrix& A, const Field& F) :
+			_field(F), _rowdim(A.rowdim()), _coldim(A.coldim()), _maxabs(0.)
+		{
+			linbox_check(std::max(_rowdim,_coldim) <= (size_t)std::numeric_limits<Index>::max());
+			std::vector<Triple> T;
+			const integer bound(integer(1) << 52);
+			for(auto it = A.IndexedBegin(); it != A.IndexedEnd(); ++it) {
+				integer a(it.value());
+				if (a == 0) continue;
+				if (abs(a) >= bound)
+					throw LinboxError("MultiModSparseMatrix: entry too large");
+				const double d = (double)a;
+				_maxabs = std::max(_maxabs, std::fabs(d));
+				T.emplace_back((Index)it.rowIndex(), (Index)it.colIndex(), d);
+			}
+			_primes.resize(F.size());
+			for(size_t l=0; l<F.size(); ++l)
+				_primes[l] = (double)F.getModulo(l);
+			setDelay();
+
+			buildRows(_rows, T, _rowdim);
+			for(auto & t: T) std::swap(t.i, t.j);
+			buildRows(_cols, T, _coldim);
+		}
+
+		/// y <- A x, both interleaved with stride nprimes()
+		InterleavedVector& applyInterleaved (InterleavedVector& y, const InterleavedVector& x) const
+		{
+			linbox_check(x.size() >= _coldim*nprimes());
+			y.resize(_rowdim*nprimes());
+			sweep(y.data(), x.data(), _rows);
+			return y;
+		}
+
+		/// y <- A^T x, both interleaved with stride nprimes()
+		InterleavedVector& applyTransposeInterleaved (InterleavedVector& y, const InterleavedVector& x) const
+		{
+			linbox_check(x.size() >= _rowdim*nprimes());
+			y.resize(_coldim*nprimes());
+			sweep(y.data(), x.data(), _cols);
+			return y;
+		}
+
+		/** y <- A x over MultiModLanes<K>, with K = nprimes().
+		 * A vector of DoubleLanes<K> already is the interleaved layout:
+		 * no copy.
+		 */
+		template<size_t K>
+		std::vector<DoubleLanes<K> >& applyLanes (std::vector<DoubleLanes<K> >& y, const std::vector<DoubleLanes<K> >& x) const
+		{
+			linbox_check(K == nprimes() && x.size() >= _coldim);
+			y.resize(_rowdim);
+			sweep(reinterpret_cast<double*>(y.data()), reinterpret_cast<const double*>(x.data()), _rows);
+			return y;
+		}
+
+		/// y <- A^T x over MultiModLanes<K>, with K = nprimes()
+		template<size_t K>
+		std::vector<DoubleLanes<K> >& applyTransposeLanes (std::vector<DoubleLanes<K> >& y, const std::vector<DoubleLanes<K> >& x) const
+		{
+			linbox_check(K == nprimes() && x.size() >= _rowdim);
+			y.resize(_coldim);
+			sweep(reinterpret_cast<double*>(y.data()), reinterpret_cast<const double*>(x.data()), _cols);
+			return y;
+		}
+
+		/// Blackbox apply over MultiModDouble, through interleaved buffers
+		template<class OutVector, class InVector>
+		OutVector& apply (OutVector& y, const InVector& x) const
+		{
+			InterleavedVector xi, yi;
+			interleave(xi, x);
+			applyInterleaved(yi, xi);
+			return deinterleave(y, yi);
+		}
+
+		/// Blackbox applyTranspose over MultiModDouble, through interleaved buffers
+		template<class OutVector, class InVector>
+		OutVector& applyTranspose (OutVector& y, const InVector& x) const
+		{
+			InterleavedVector xi, yi;
+			interleave(xi, x);
+			applyTransposeInterleaved(yi, xi);
+			return deinterleave(y, yi);
+		}
+
+		/// Packs a vector of MultiModDouble elements
+		template<class Vector>
+		InterleavedVector& interleave (InterleavedVector& xi, const Vector& x) const
+		{
+			const size_t k = nprimes();
+			xi.resize(x.size()*k);
+			for(size_t j=0; j<x.size(); ++j)
+				std::copy(x[j].begin(), x[j].begin()+k, xi.begin()+j*k);
+			return xi;
+		}
+
+		/// Unpacks into a vector of MultiModDouble elements
+		template<class Vector>
+		Vector& deinterleave (Vector& x, const InterleavedVector& xi) const
+		{
+			const size_t k = nprimes();
+			for(size_t j=0; j<x.size(); ++j)
+				x[j].assign(xi.begin()+j*k, xi.begin()+(j+1)*k);
+			return x;
+		}
+
+		size_t rowdim () const { return _rowdim; }
+		size_t coldim () const { return _coldim; }
+		size_t nnz () const { return _rows.vals.size(); }
+		size_t nprimes () const { return _primes.size(); }
+		const Field& field () const { return _field; }
+
+		/// Number of products accumulated between two reductions
+		size_t maxDelay () const { return _delay; }
+
+	protected:
+		struct Triple {
+			Index i, j; double a;
+			Triple (Index r, Index c, double e) : i(r), j(c), a(e) {}
+		};
+
+		struct Rows {
+			std::vector<Index>  colid;
+			std::vector<double> vals;
+			std::vector<size_t> start;
+		};
+
+		// Counting sort of the triples by row
+		static void buildRows (Rows& R, const std::vector<Triple>& T, size_t dim)
+		{
+			R.start.assign(dim+1, 0);
+			for(auto const& t: T) ++R.start[t.i+1];
+			for(size_t i=0; i<dim; ++i) R.start[i+1] += R.start[i];
+			R.colid.resize(T.size());
+			R.vals.resize(T.size());
+			std::vector<size_t> pos(R.start.begin(), R.start.end()-1);
+			for(auto const& t: T) {
+				R.colid[pos[t.i]] = t.j;
+				R.vals[pos[t.i]++] = t.a;
+			}
+		}
+
+		void setDelay ()
+		{
+			double pmax(0.);
+			for(auto const& p: _primes) pmax = std::max(pmax, p);
+			// |sum| <= delay*maxabs*(p-1) + (p-1) < 2^53
+			const double room = 9007199254740992.0 - pmax;
+			const double term = std::max(_maxabs, 1.) * (pmax-1.);
+			if (term >= room)
+				throw LinboxError("MultiModSparseMatrix: primes too large for the entries");
+			_delay = (size_t)std::min(room/std::max(term,1.), 1e15);
+		}
+
+		// y and x interleaved with stride nprimes()
+		void sweep (double* y, const double* x, const Rows& R) const
+		{
+			const size_t k = nprimes();
+			const double* p = _primes.data();
+			std::vector<double> acc(k);
+			for(size_t i=0; i+1<R.start.size(); ++i) {
+				std::fill(acc.begin(), acc.end(), 0.);
+				size_t left = _delay;
+				for(size_t t=R.start[i]; t<R.start[i+1]; ++t) {
+					const double a = R.vals[t];
+					const double* xp = x + (size_t)R.colid[t]*k;
+					for(size_t l=0; l<k; ++l)
+						acc[l] += a*xp[l];
+					if (--left == 0) {
+						for(size_t l=0; l<k; ++l)
+							acc[l] = std::fmod(acc[l], p[l]);
+						left = _delay;
+					}
+				}
+				double* yp = y + i*k;
+				for(size_t l=0; l<k; ++l) {
+					yp[l] = std::fmod(acc[l], p[l]);
+					if (yp[l] < 0.) yp[l] += p[l];
+				}
+			}
+		}
+
+		Field               _field;
+		size_t              _rowdim;
+		size_t              _coldim;
+		double              _maxabs;
+		size_t              _delay;
+		std::vector<double> _primes;
+		Rows                _rows;  //!< A by rows
+		Rows                _cols;  //!< A by columns
+	};
+
+} // LinBox
+
+#endif // __LINBOX_blackbox_multimod_sparse_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
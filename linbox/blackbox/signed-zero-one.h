@@ -0,0 +1,339 @@
+/* linbox/blackbox/signed-zero-one.h
+ * Copyright (C) LinBox
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file blackbox/signed-zero-one.h
+ * @ingroup blackbox
+ * @brief Sparse {0,1,-1}-matrices applied with additions and subtractions only.
+ */
+
+#ifndef __LINBOX_blackbox_signed_zero_one_H
+#define __LINBOX_blackbox_signed_zero_one_H
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <sstream>
+#include <iostream>
+#include <cstdint>
+#include <limits>
+
+#include "linbox/integer.h"
+#include "linbox/util/debug.h"
+#include "linbox/util/error.h"
+#include "linbox/util/field-axpy.h"
+#include "linbox/blackbox/blackbox-interface.h"
+
+#ifdef __LINBOX_USE_OPENMP
+#include <omp.h>
+#endif
+
+namespace LinBox
+{
+
+	/// Compressed rows: +1 column ids in [start[i],split[i]), -1 ones in [split[i],start[i+1])
+	struct SignedZeroOnePattern {
+		std::vector<uint32_t> index;
+		std::vector<size_t>   start;
+		std::vector<size_t>   split;
+	};
+
+	/** \brief Sparse {0,1,-1}-matrices, e.g. incidence and boundary matrices.
+	 *
+	 * No value is stored: every row keeps the column ids of its +1's,
+	 * followed by those of its -1's, with 32-bit indices.
+	 * apply, applyTranspose, applyLeft and applyRight only add and
+	 * subtract entries of the input, accumulating the positive and the
+	 * negative parts with FieldAXPY (delayed modular reduction), and
+	 * subtracting once per output entry.
+	 * The transposed pattern is kept as well, so that both directions
+	 * are row-oriented and can be run in parallel with OpenMP, see
+	 * setParallel().
+	 *
+	 * As the pattern does not depend on the field, rebind is a mere copy
+	 * of indices, which makes this blackbox cheap in CRA loops
+	 * (rank, valence, Smith form).
+	 * \ingroup blackbox
+	 */
+	template<class _Field>
+	class SignedZeroOne : public BlackboxInterface {
+	public:
+		typedef _Field                      Field;
+		typedef typename Field::Element     Element;
+		typedef uint32_t                    Index;
+		typedef SignedZeroOne<_Field>       Self_t;
+		typedef SignedZeroOnePattern        Pattern;
+
+		/// Empty matrix, to be read
+		SignedZeroOne (const Field& F) :
+			_field(&F), _rowdim(0), _coldim(0), _parallel(false)
+		{}
+
+		/** From coordinate lists.
+		 * @param F field
+		 * @param rowP,colP row and column indices of the non-zero entries
+		 * @param neg sign of the entry: true for -1
+		 * @param m,n dimensions
+		 * @param nnz number of non-zero entries
+		 */
+		SignedZeroOne (const Field& F, const size_t* rowP, const size_t* colP, const bool* neg,
+			       size_t m, size_t n, size_t nnz) :
+			_field(&F), _rowdim(m), _coldim(n), _parallel(false)
+		{
+			std::vector<Entry> T; T.reserve(nnz);
+			for(size_t k=0; k<nnz; ++k)
+				T.emplace_back(rowP[k], colP[k], neg[k]);
+			init(T);
+		}
+
+		/** From any matrix providing IndexedBegin()/IndexedEnd().
+		 * Its non-zero entries must be 1 or -1.
+		 */
+		template<class _Matrix>
+		SignedZeroOne (const _Matrix& A) :
+			_field(&A.field()), _rowdim(A.rowdim()), _coldim(A.coldim()), _parallel(false)
+		{
+			std::vector<Entry> T;
+			for(auto it = A.IndexedBegin(); it != A.IndexedEnd(); ++it) {
+				if (field().isZero(it.value())) continue;
+				if (field().isOne(it.value()))
+					T.emplace_back(it.rowIndex(), it.colIndex(), false);
+				else if (field().isMOne(it.value()))
+					T.emplace_back(it.rowIndex(), it.colIndex(), true);
+				else
+					throw LinboxError("SignedZeroOne: entry is neither 0, 1 nor -1");
+			}
+			init(T);
+		}
+
+		/// Same pattern over another field
+		template<class _Tp1>
+		SignedZeroOne (const SignedZeroOne<_Tp1>& A, const Field& F) :
+			_field(&F), _rowdim(A.rowdim()), _coldim(A.coldim()), _parallel(A.isParallel()),
+			_rows(A.rowPattern()), _cols(A.colPattern())
+		{}
+
+		template<typename _Tp1>
+		struct rebind {
+			typedef SignedZeroOne<_Tp1> other;
+			void operator() (other & Ap, const Self_t& A)
+			{
+				Ap = other(A, Ap.field());
+			}
+		};
+
+		/// y <- A x
+		template<class OutVector, class InVector>
+		OutVector& apply (OutVector& y, const InVector& x) const
+		{
+			linbox_check(y.size() >= _rowdim);
+			linbox_check(x.size() >= _coldim);
+			return applyPattern(y, x, _rows);
+		}
+
+		/// y <- A^T x
+		template<class OutVector, class InVector>
+		OutVector& applyTranspose (OutVector& y, const InVector& x) const
+		{
+			linbox_check(y.size() >= _coldim);
+			linbox_check(x.size() >= _rowdim);
+			return applyPattern(y, x, _cols);
+		}
+
+		/** Y <- A X, for dense X and Y (BlasMatrix, BlasSubmatrix).
+		 * Rows of X are added to, or subtracted from, one row of
+		 * accumulators per output row.
+		 */
+		template<class Mat1, class Mat2>
+		Mat1& applyLeft (Mat1& Y, const Mat2& X) const
+		{
+			linbox_check(Y.rowdim() == _rowdim);
+			linbox_check(X.rowdim() == _coldim);
+			linbox_check(X.coldim() == Y.coldim());
+			const long m = (long)_rowdim;
+			const size_t k = X.coldim();
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel if(_parallel)
+#endif
+			{
+				std::vector<FieldAXPY<Field> > pos(k, FieldAXPY<Field>(field())), neg(pos);
+				Element p, n;
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp for schedule(dynamic,64)
+#endif
+				for(long i=0; i<m; ++i) {
+					for(size_t c=0; c<k; ++c) { pos[c].reset(); neg[c].reset(); }
+					for(size_t l=_rows.start[i]; l<_rows.split[i]; ++l) {
+						auto x = X[_rows.index[l]].begin();
+						for(size_t c=0; c<k; ++c, ++x) pos[c].accumulate(*x);
+					}
+					for(size_t l=_rows.split[i]; l<_rows.start[i+1]; ++l) {
+						auto x = X[_rows.index[l]].begin();
+						for(size_t c=0; c<k; ++c, ++x) neg[c].accumulate(*x);
+					}
+					auto y = Y[(size_t)i].begin();
+					for(size_t c=0; c<k; ++c, ++y) {
+						pos[c].get(p); neg[c].get(n);
+						field().sub(*y, p, n);
+					}
+				}
+			}
+			return Y;
+		}
+
+		/** Y <- X A, for dense X and Y (BlasMatrix, BlasSubmatrix).
+		 * Row r of Y is A^T applied to row r of X, with the column pattern.
+		 */
+		template<class Mat1, class Mat2>
+		Mat1& applyRight (Mat1& Y, const Mat2& X) const
+		{
+			linbox_check(Y.coldim() == _coldim);
+			linbox_check(X.coldim() == _rowdim);
+			linbox_check(X.rowdim() == Y.rowdim());
+			for(size_t r=0; r<X.rowdim(); ++r) {
+				auto y = Y[r];
+				applyPattern(y, X[r], _cols);
+			}
+			return Y;
+		}
+
+		/// Row-parallel applies (only effective when compiled with OpenMP)
+		void setParallel (bool parallel = true) { _parallel = parallel; }
+		bool isParallel () const { return _parallel; }
+
+		size_t rowdim () const { return _rowdim; }
+		size_t coldim () const { return _coldim; }
+		size_t nnz () const { return _rows.index.size(); }
+		const Field& field () const { return *_field; }
+
+		/** Read the matrix from a stream in the SMS format.
+		 * Entries other than 1 and -1 are rejected.
+		 */
+		std::istream& read (std::istream& is)
+		{
+			char buf[80]; buf[0]=0;
+			is.getline(buf, 80);
+			std::istringstream str(buf);
+			str >> _rowdim >> _coldim;
+
+			std::vector<Entry> T;
+			size_t i, j; long v;
+			while (is >> i >> j >> v) {
+				if (i == 0 || i == (size_t) -1) break;
+				if (v == 0) continue;
+				if ( (v != 1) && (v != -1) )
+					throw LinboxError("SignedZeroOne: entry is neither 0, 1 nor -1");
+				T.emplace_back(i-1, j-1, v < 0);
+			}
+			init(T);
+			return is;
+		}
+
+		/// Write the matrix in the SMS format
+		std::ostream& write (std::ostream& os) const
+		{
+			os << _rowdim << ' ' << _coldim << " M" << std::endl;
+			for(size_t i=0; i<_rowdim; ++i) {
+				std::vector<std::pair<Index,int> > row;
+				for(size_t k=_rows.start[i]; k<_rows.start[i+1]; ++k)
+					row.emplace_back(_rows.index[k], (k<_rows.split[i]) ? 1 : -1);
+				std::sort(row.begin(), row.end());
+				for(auto const& e: row)
+					os << i+1 << ' ' << e.first+1 << ' ' << e.second << std::endl;
+			}
+			return os << "0 0 0" << std::endl;
+		}
+
+		const Pattern& rowPattern () const { return _rows; }
+		const Pattern& colPattern () const { return _cols; }
+
+	protected:
+		struct Entry {
+			size_t i, j; bool neg;
+			Entry (size_t r, size_t c, bool s) : i(r), j(c), neg(s) {}
+		};
+
+		void init (std::vector<Entry>& T)
+		{
+			linbox_check(std::max(_rowdim,_coldim) <= (size_t)std::numeric_limits<Index>::max());
+			buildPattern(_rows, T, _rowdim, false);
+			buildPattern(_cols, T, _coldim, true);
+		}
+
+		// Counting sort of the entries by row (or column), positives first
+		static void buildPattern (Pattern& P, const std::vector<Entry>& T, size_t dim, bool transposed)
+		{
+			std::vector<size_t> npos(dim,0), nneg(dim,0);
+			for(auto const& e: T)
+				++( e.neg ? nneg : npos )[transposed ? e.j : e.i];
+			P.start.assign(dim+1, 0);
+			P.split.assign(dim, 0);
+			for(size_t i=0; i<dim; ++i) {
+				P.split[i] = P.start[i] + npos[i];
+				P.start[i+1] = P.split[i] + nneg[i];
+			}
+			P.index.resize(T.size());
+			std::vector<size_t> pp(P.start.begin(), P.start.end()-1), np(P.split);
+			for(auto const& e: T) {
+				const size_t i = transposed ? e.j : e.i;
+				P.index[ e.neg ? np[i]++ : pp[i]++ ] = (Index)(transposed ? e.i : e.j);
+			}
+		}
+
+		template<class OutVector, class InVector>
+		OutVector& applyPattern (OutVector& y, const InVector& x, const Pattern& P) const
+		{
+			const long m = (long)P.split.size();
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(dynamic,256) if(_parallel)
+#endif
+			for(long i=0; i<m; ++i) {
+				FieldAXPY<Field> pos(field()), neg(field());
+				for(size_t k=P.start[i]; k<P.split[i]; ++k)
+					pos.accumulate(x[P.index[k]]);
+				for(size_t k=P.split[i]; k<P.start[i+1]; ++k)
+					neg.accumulate(x[P.index[k]]);
+				Element n;
+				pos.get(y[i]); neg.get(n);
+				field().subin(y[i], n);
+			}
+			return y;
+		}
+
+		const Field* _field;
+		size_t       _rowdim;
+		size_t       _coldim;
+		bool         _parallel;
+		Pattern      _rows;   //!< row-wise pattern, for apply and applyLeft
+		Pattern      _cols;   //!< column-wise pattern, for applyTranspose and applyRight
+	};
+
+} // LinBox
+
+#endif // __LINBOX_blackbox_signed_zero_one_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
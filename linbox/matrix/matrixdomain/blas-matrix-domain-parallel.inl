@@ -0,0 +1,185 @@
+/* linbox/matrix/matrixdomain/blas-matrix-domain-parallel.inl
+ * Copyright (C) LinBox
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file matrix/matrixdomain/blas-matrix-domain-parallel.inl
+ * @ingroup matrixdomain
+ * @brief Shared memory kernels of BlasMatrixDomain (FFLAS parallel helpers).
+ */
+
+#ifndef __LINBOX_matrix_matrixdomain_blas_matrix_domain_parallel_INL
+#define __LINBOX_matrix_matrixdomain_blas_matrix_domain_parallel_INL
+
+#include <vector>
+#include <type_traits>
+
+#include "linbox/linbox-config.h"
+#include "linbox/util/parallel-policy.h"
+#include "fflas-ffpack/fflas/fflas.h"
+#include "fflas-ffpack/ffpack/ffpack.h"
+#include "fflas-ffpack/paladin/parallel.h"
+
+namespace LinBox
+{
+	namespace Protected {
+		/// Dense operands without any structure tag (triangular, permutation, ...)
+		template<class T>
+		struct IsPlainBlas : std::false_type {};
+		template<class F, class R>
+		struct IsPlainBlas<BlasMatrix<F,R> > : std::true_type {};
+		template<class M>
+		struct IsPlainBlas<BlasSubmatrix<M> > : std::true_type {};
+
+		template<class... T>
+		struct AllPlainBlas : std::true_type {};
+		template<class T, class... U>
+		struct AllPlainBlas<T, U...> :
+			std::integral_constant<bool, IsPlainBlas<T>::value && AllPlainBlas<U...>::value> {};
+
+		template<class T>
+		struct IsTriangularBlas : std::false_type {};
+		template<class M>
+		struct IsTriangularBlas<TriangularBlasMatrix<M> > : std::true_type {};
+	}
+
+	/*! @internal
+	 * Parallel versions of the FFLAS/FFPACK entry points used by
+	 * BlasMatrixDomain, following a ParallelPolicy.
+	 * Only meant to be called when the policy is worth it.
+	 */
+	template<class Field>
+	struct BlasMatrixDomainParallel {
+		typedef typename Field::Element           Element;
+		typedef typename Field::Element_ptr       Element_ptr;
+		typedef typename Field::ConstElement_ptr  ConstElement_ptr;
+
+		//! C <- beta C + alpha op(A) op(B)
+		static void fgemm (const Field& F, FFLAS::FFLAS_TRANSPOSE ta, FFLAS::FFLAS_TRANSPOSE tb,
+				   size_t m, size_t n, size_t k,
+				   const Element& alpha, ConstElement_ptr A, size_t lda, ConstElement_ptr B, size_t ldb,
+				   const Element& beta, Element_ptr C, size_t ldc,
+				   const ParallelPolicy& policy)
+		{
+			const size_t nt = policy.threads();
+			if (policy.split == ParallelPolicy::Split::Recursive) {
+				FFLAS::ParSeqHelper::Parallel<FFLAS::CuttingStrategy::Recursive,
+							      FFLAS::StrategyParameter::TwoDAdaptive> par(nt);
+				PAR_BLOCK { FFLAS::fgemm(F, ta, tb, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc, par); }
+			}
+			else {
+				FFLAS::ParSeqHelper::Parallel<FFLAS::CuttingStrategy::Block,
+							      FFLAS::StrategyParameter::Threads> par(nt);
+				PAR_BLOCK { FFLAS::fgemm(F, ta, tb, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc, par); }
+			}
+		}
+
+		//! B <- alpha op(A)^{-1} B or alpha B op(A)^{-1}, A triangular
+		static void ftrsm (const Field& F, FFLAS::FFLAS_SIDE side, FFLAS::FFLAS_UPLO uplo,
+				   FFLAS::FFLAS_TRANSPOSE ta, FFLAS::FFLAS_DIAG diag, size_t m, size_t n,
+				   const Element& alpha, ConstElement_ptr A, size_t lda, Element_ptr B, size_t ldb,
+				   const ParallelPolicy& policy)
+		{
+			FFLAS::ParSeqHelper::Parallel<FFLAS::CuttingStrategy::Block,
+						      FFLAS::StrategyParameter::Threads> par(policy.threads());
+			PAR_BLOCK { FFLAS::ftrsm(F, side, uplo, ta, diag, m, n, alpha, A, lda, B, ldb, par); }
+		}
+
+		//! In place A = P L U Q, L unit; returns the rank
+		static size_t pluq (const Field& F, size_t m, size_t n, Element_ptr A, size_t lda,
+				    size_t* P, size_t* Q, const ParallelPolicy& policy)
+		{
+			size_t r(0);
+			const int nt = (int)policy.threads();
+			PAR_BLOCK { r = FFPACK::pPLUQ(F, FFLAS::FflasNonUnit, m, n, A, lda, P, Q, nt); }
+			return r;
+		}
+
+		//! A is overwritten
+		static size_t rank (const Field& F, size_t m, size_t n, Element_ptr A, size_t lda,
+				    const ParallelPolicy& policy)
+		{
+			std::vector<size_t> P(m), Q(n);
+			return pluq(F, m, n, A, lda, P.data(), Q.data(), policy);
+		}
+
+		//! A is overwritten
+		static Element& det (const Field& F, Element& d, size_t n, Element_ptr A, size_t lda,
+				     const ParallelPolicy& policy)
+		{
+			std::vector<size_t> P(n), Q(n);
+			if (pluq(F, n, n, A, lda, P.data(), Q.data(), policy) < n)
+				return F.assign(d, F.zero);
+			bool odd(false);
+			F.assign(d, F.one);
+			for(size_t i=0; i<n; ++i) {
+				F.mulin(d, A[i*(lda+1)]);
+				odd ^= (P[i] != i);
+				odd ^= (Q[i] != i);
+			}
+			if (odd) F.negin(d);
+			return d;
+		}
+
+		//! Ainv <- A^{-1}, A is overwritten; returns the nullity
+		static int inv (const Field& F, size_t n, Element_ptr A, size_t lda,
+				Element_ptr Ainv, size_t ldi, const ParallelPolicy& policy)
+		{
+			std::vector<size_t> P(n), Q(n);
+			const size_t r = pluq(F, n, n, A, lda, P.data(), Q.data(), policy);
+			if (r < n) return (int)(n-r);
+			// A^{-1} = Q^T U^{-1} L^{-1} P^T
+			FFLAS::fidentity(F, n, n, Ainv, ldi);
+			FFPACK::applyP(F, FFLAS::FflasLeft, FFLAS::FflasNoTrans, n, 0, (int)n, Ainv, ldi, P.data());
+			ftrsm(F, FFLAS::FflasLeft, FFLAS::FflasLower, FFLAS::FflasNoTrans, FFLAS::FflasUnit,
+			      n, n, F.one, A, lda, Ainv, ldi, policy);
+			ftrsm(F, FFLAS::FflasLeft, FFLAS::FflasUpper, FFLAS::FflasNoTrans, FFLAS::FflasNonUnit,
+			      n, n, F.one, A, lda, Ainv, ldi, policy);
+			FFPACK::applyP(F, FFLAS::FflasLeft, FFLAS::FflasTrans, n, 0, (int)n, Ainv, ldi, Q.data());
+			return 0;
+		}
+
+		//! x <- A^{-1} x, A is overwritten; returns false, x being garbage, when A is singular
+		static bool solve (const Field& F, size_t n, Element_ptr A, size_t lda, Element_ptr x,
+				   const ParallelPolicy& policy)
+		{
+			std::vector<size_t> P(n), Q(n);
+			if (pluq(F, n, n, A, lda, P.data(), Q.data(), policy) < n)
+				return false;
+			// the factorization is the cubic part, the vector solves stay sequential
+			FFPACK::applyP(F, FFLAS::FflasLeft, FFLAS::FflasNoTrans, 1, 0, (int)n, x, 1, P.data());
+			FFLAS::ftrsv(F, FFLAS::FflasLower, FFLAS::FflasNoTrans, FFLAS::FflasUnit, n, A, lda, x, 1);
+			FFLAS::ftrsv(F, FFLAS::FflasUpper, FFLAS::FflasNoTrans, FFLAS::FflasNonUnit, n, A, lda, x, 1);
+			FFPACK::applyP(F, FFLAS::FflasLeft, FFLAS::FflasTrans, 1, 0, (int)n, x, 1, Q.data());
+			return true;
+		}
+	};
+
+} // LinBox
+
+#endif // __LINBOX_matrix_matrixdomain_blas_matrix_domain_parallel_INL
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
@@ -53,6 +53,8 @@
 #include "linbox/matrix/dense-matrix.h"
 #include "linbox/matrix/permutation-matrix.h"
 #include "linbox/matrix/factorized-matrix.h"
+#include "linbox/util/parallel-policy.h"
+#include "linbox/matrix/matrixdomain/blas-matrix-domain-parallel.inl"
 
 
 
@@ -306,6 +308,11 @@ namespace LinBox
 	 *  @internal
 	 *  Done through specialization of all
 	 *  classes defined above.
+	 *
+	 *  Products, rank, determinant, inversion and triangular solves of
+	 *  plain dense operands go through the FFLAS parallel kernels when
+	 *  the ParallelPolicy of the domain allows it (see
+	 *  setParallelPolicy()); charpoly and minpoly remain sequential.
 	 */
 	template <class Field_>
 	class BlasMatrixDomain {
@@ -321,22 +328,28 @@ namespace LinBox
 	protected:
 
 		const Field  * _field;
+		ParallelPolicy _policy;
 
 	public:
 
 		//! Constructor of BlasDomain.
 		BlasMatrixDomain () {}
 		BlasMatrixDomain (const Field& F ) { init(F); }
+		BlasMatrixDomain (const Field& F, const ParallelPolicy& policy) : _policy(policy) { init(F); }
 
 		void init(const Field& F ){_field = &F;}
 
 		//! Copy constructor
-		BlasMatrixDomain (const BlasMatrixDomain<Field> & BMD): _field(BMD._field) {}
+		BlasMatrixDomain (const BlasMatrixDomain<Field> & BMD): _field(BMD._field), _policy(BMD._policy) {}
 
 
 		//! Field accessor
 		const Field& field() const { return *_field; }
 
+		//! Threads used by the dense kernels
+		const ParallelPolicy& parallelPolicy() const { return _policy; }
+		void setParallelPolicy(const ParallelPolicy& policy) { _policy = policy; }
+
 		/*
 		 * Basics operation available matrix respecting BlasMatrix interface
 		 */
@@ -346,6 +359,8 @@ namespace LinBox
 		template <class Operand1, class Operand2, class Operand3>
 		Operand1& mul(Operand1& C, const Operand2& A, const Operand3& B) const
 		{
+			if (parallelMulAdd(field().zero, C, field().one, A, B))
+				return C;
 			return BlasMatrixDomainMul<Operand1,Operand2,Operand3>()(C,A,B);
 		}
 
@@ -473,6 +488,8 @@ namespace LinBox
 		Operand1& muladd(Operand1& D, const Element& beta, const Operand2& C,
                          const Element& alpha, const Operand3& A, const Operand4& B) const
 		{
+			if (parallelMulAdd(D, beta, C, alpha, A, B, PlainTag<Operand1,Operand2,Operand3,Operand4>()))
+				return D;
 			return BlasMatrixDomainMulAdd<Operand1,Operand2,Operand3,Operand4>()(D,beta,C,alpha,A,B);
 		}
 
@@ -482,6 +499,8 @@ namespace LinBox
 		Operand1& muladdin(const Element& beta, Operand1& C,
                            const Element& alpha, const Operand2& A, const Operand3& B) const
 		{
+			if (parallelMulAdd(beta, C, alpha, A, B))
+				return C;
 			return BlasMatrixDomainMulAdd<Operand1,Operand1,Operand2,Operand3>()(beta,C,alpha,A,B);
 		}
 
@@ -495,16 +514,16 @@ namespace LinBox
 		template <class Matrix1, class Matrix2>
 		Matrix1& inv( Matrix1 &Ainv, const Matrix2 &A) const
 		{
-			BlasMatrixDomainInv<Matrix1,Matrix2>()(Ainv,A);
-			return Ainv;
+			int nullity;
+			return inv(Ainv, A, nullity);
 		}
 
 		//! Inversion (in place)
 		template <class Matrix>
 		Matrix& invin( Matrix &Ainv, Matrix &A) const
 		{
-			BlasMatrixDomainInv<Matrix,Matrix>()(Ainv,A);
-			return Ainv;
+			int nullity;
+			return invin(Ainv, A, nullity);
 		}
 
 		//! Inversion (the matrix A is modified)
@@ -546,6 +565,8 @@ namespace LinBox
 		template <class Matrix1, class Matrix2>
 		Matrix1& inv( Matrix1 &Ainv, const Matrix2 &A, int& nullity) const
 		{
+			if (parallelInv(Ainv, A, nullity, PlainTag<Matrix1,Matrix2>()))
+				return Ainv;
 			nullity = BlasMatrixDomainInv<Matrix1,Matrix2>()(Ainv,A);
 			return Ainv;
 		}
@@ -555,6 +576,8 @@ namespace LinBox
 		template <class Matrix1, class Matrix2>
 		Matrix1& invin( Matrix1 &Ainv, Matrix2 &A, int& nullity) const
 		{
+			if (parallelInv(Ainv, A, nullity, PlainTag<Matrix1,Matrix2>()))
+				return Ainv;
 			nullity = BlasMatrixDomainInv<Matrix1,Matrix2>()(Ainv,A);
 			return Ainv;
 		}
@@ -563,6 +586,9 @@ namespace LinBox
 		template <class Matrix>
 		unsigned int rank(const Matrix &A) const
 		{
+			size_t r;
+			if (parallelRank(r, A, PlainTag<Matrix>()))
+				return (unsigned int)r;
 			return BlasMatrixDomainRank<Matrix>()(A);
 		}
 
@@ -570,6 +596,9 @@ namespace LinBox
 		template <class Matrix>
 		unsigned int rankInPlace(Matrix &A) const
 		{
+			size_t r;
+			if (parallelRank(r, A, PlainTag<Matrix>()))
+				return (unsigned int)r;
 			return BlasMatrixDomainRank<Matrix>()(A);
 		}
 
@@ -577,6 +606,9 @@ namespace LinBox
 		template <class Matrix>
 		Element det(const Matrix &A) const
 		{
+			Element d;
+			if (parallelDet(d, A, PlainTag<Matrix>()))
+				return d;
 			return BlasMatrixDomainDet<Matrix>()(A);
 		}
 
@@ -584,7 +616,9 @@ namespace LinBox
 		template <class Matrix>
 		Element detInPlace(Matrix &A) const
 		{
-
+			Element d;
+			if (parallelDet(d, A, PlainTag<Matrix>()))
+				return d;
 			return BlasMatrixDomainDet<Matrix>()(A);
 		}
 		//@}
@@ -608,6 +642,8 @@ namespace LinBox
 		template <class Operand,class Matrix>
 		Operand& left_solve (const Matrix& A, Operand& B) const
 		{
+			if (parallelTriangularSolve(FFLAS::FflasLeft, A, B))
+				return B;
 			return BlasMatrixDomainLeftSolve<Operand,Matrix,Operand>()(A,B);
 		}
 
@@ -625,6 +661,8 @@ namespace LinBox
 		template <class Operand, class Matrix>
 		Operand& right_solve (const Matrix& A, Operand& B) const
 		{
+			if (parallelTriangularSolve(FFLAS::FflasRight, A, B))
+				return B;
 			return BlasMatrixDomainRightSolve<Operand,Matrix,Operand>()(A,B);
 		}
 
@@ -806,6 +844,158 @@ namespace LinBox
 		}
 #endif
 
+	protected:
+
+		/*! @internal
+		 * Dispatch to BlasMatrixDomainParallel: only for plain dense
+		 * operands (no triangular or permutation tag), and only when the
+		 * policy finds the dimensions worth it.
+		 */
+		template <class... Operands>
+		using PlainTag = std::integral_constant<bool, Protected::AllPlainBlas<Operands...>::value>;
+
+		template <class Operand1, class Operand2, class Operand3>
+		bool parallelMulAddWorthIt(const Operand1& C, const Operand2& A, const Operand3& B) const
+		{
+			return PlainTag<Operand1,Operand2,Operand3>::value
+				&& _policy.worthIt(C.rowdim(), C.coldim(), A.coldim());
+		}
+
+		template <class Matrix>
+		bool parallelRank(size_t&, const Matrix&, std::false_type) const { return false; }
+		template <class Matrix>
+		bool parallelDet(Element&, const Matrix&, std::false_type) const { return false; }
+		template <class Matrix1, class Matrix2>
+		bool parallelInv(Matrix1&, const Matrix2&, int&, std::false_type) const { return false; }
+
+		template <class Matrix>
+		bool parallelRank(size_t& r, Matrix& A, std::true_type) const
+		{
+			if (! _policy.worthIt(A.rowdim(), A.coldim())) return false;
+			r = BlasMatrixDomainParallel<Field>::rank(field(), A.rowdim(), A.coldim(),
+								  A.getPointer(), A.getStride(), _policy);
+			return true;
+		}
+
+		template <class Matrix>
+		bool parallelRank(size_t& r, const Matrix& A, std::true_type) const
+		{
+			if (! _policy.worthIt(A.rowdim(), A.coldim())) return false;
+			typename Matrix::matrixType Acopy(A);
+			return parallelRank(r, Acopy, std::true_type());
+		}
+
+		template <class Matrix>
+		bool parallelDet(Element& d, Matrix& A, std::true_type) const
+		{
+			if ((A.rowdim() != A.coldim()) || ! _policy.worthIt(A.rowdim(), A.coldim())) return false;
+			BlasMatrixDomainParallel<Field>::det(field(), d, A.rowdim(), A.getPointer(), A.getStride(), _policy);
+			return true;
+		}
+
+		template <class Matrix>
+		bool parallelDet(Element& d, const Matrix& A, std::true_type) const
+		{
+			if ((A.rowdim() != A.coldim()) || ! _policy.worthIt(A.rowdim(), A.coldim())) return false;
+			typename Matrix::matrixType Acopy(A);
+			return parallelDet(d, Acopy, std::true_type());
+		}
+
+		template <class Matrix1, class Matrix2>
+		bool parallelInv(Matrix1& Ainv, Matrix2& A, int& nullity, std::true_type) const
+		{
+			if ((A.rowdim() != A.coldim()) || ! _policy.worthIt(A.rowdim(), A.coldim())) return false;
+			linbox_check( A.rowdim() == Ainv.rowdim());
+			linbox_check( A.coldim() == Ainv.coldim());
+			nullity = BlasMatrixDomainParallel<Field>::inv(field(), A.rowdim(), A.getPointer(), A.getStride(),
+								       Ainv.getPointer(), Ainv.getStride(), _policy);
+			return true;
+		}
+
+		template <class Matrix1, class Matrix2>
+		bool parallelInv(Matrix1& Ainv, const Matrix2& A, int& nullity, std::true_type) const
+		{
+			if ((A.rowdim() != A.coldim()) || ! _policy.worthIt(A.rowdim(), A.coldim())) return false;
+			typename Matrix2::matrixType Acopy(A);
+			return parallelInv(Ainv, Acopy, nullity, std::true_type());
+		}
+
+		//! C <- beta C + alpha A B, if parallel; returns false otherwise
+		template <class Operand1, class Operand2, class Operand3>
+		bool parallelMulAdd(const Element& beta, Operand1& C,
+				    const Element& alpha, const Operand2& A, const Operand3& B) const
+		{
+			return parallelMulAdd(beta, C, alpha, A, B, PlainTag<Operand1,Operand2,Operand3>());
+		}
+
+		template <class Operand1, class Operand2, class Operand3>
+		bool parallelMulAdd(const Element& , Operand1& , const Element& , const Operand2& , const Operand3& ,
+				    std::false_type) const
+		{
+			return false;
+		}
+
+		template <class Operand1, class Operand2, class Operand3>
+		bool parallelMulAdd(const Element& beta, Operand1& C,
+				    const Element& alpha, const Operand2& A, const Operand3& B,
+				    std::true_type) const
+		{
+			if (! parallelMulAddWorthIt(C, A, B)) return false;
+			linbox_check( A.coldim() == B.rowdim()); linbox_check( C.rowdim() == A.rowdim());
+			linbox_check( C.coldim() == B.coldim());
+			BlasMatrixDomainParallel<Field>::fgemm(field(), FFLAS::FflasNoTrans, FFLAS::FflasNoTrans,
+							       C.rowdim(), C.coldim(), A.coldim(),
+							       alpha, A.getPointer(), A.getStride(), B.getPointer(), B.getStride(),
+							       beta, C.getPointer(), C.getStride(), _policy);
+			return true;
+		}
+
+		//! D <- beta C + alpha A B, if parallel; returns false otherwise
+		template <class Operand1, class Operand2, class Operand3, class Operand4>
+		bool parallelMulAdd(Operand1& , const Element& , const Operand2& ,
+				    const Element& , const Operand3& , const Operand4& , std::false_type) const
+		{
+			return false;
+		}
+
+		template <class Operand1, class Operand2, class Operand3, class Operand4>
+		bool parallelMulAdd(Operand1& D, const Element& beta, const Operand2& C,
+				    const Element& alpha, const Operand3& A, const Operand4& B, std::true_type) const
+		{
+			if (! parallelMulAddWorthIt(D, A, B)) return false;
+			linbox_check( D.rowdim() == C.rowdim());
+			linbox_check( D.coldim() == C.coldim());
+			D.copy(C);
+			return parallelMulAdd(beta, D, alpha, A, B, std::true_type());
+		}
+
+		//! B <- A^{-1} B or B A^{-1} for a triangular A, if parallel; returns false otherwise
+		template <class Matrix, class Operand>
+		bool parallelTriangularSolve(FFLAS::FFLAS_SIDE side, const Matrix& A, Operand& B) const
+		{
+			return parallelTriangularSolve(side, A, B,
+						       std::integral_constant<bool, Protected::IsTriangularBlas<Matrix>::value
+						       && Protected::IsPlainBlas<Operand>::value>());
+		}
+
+		template <class Matrix, class Operand>
+		bool parallelTriangularSolve(FFLAS::FFLAS_SIDE , const Matrix& , Operand& , std::false_type) const
+		{
+			return false;
+		}
+
+		template <class Matrix, class Operand>
+		bool parallelTriangularSolve(FFLAS::FFLAS_SIDE side, const Matrix& A, Operand& B, std::true_type) const
+		{
+			if (! _policy.worthIt(B.rowdim(), B.coldim())) return false;
+			linbox_check( A.rowdim() == A.coldim());
+			linbox_check( (side == FFLAS::FflasLeft) ? (A.coldim() == B.rowdim()) : (A.rowdim() == B.coldim()) );
+			BlasMatrixDomainParallel<Field>::ftrsm(field(), side, (FFLAS::FFLAS_UPLO) A.getUpLo(), FFLAS::FflasNoTrans,
+							       (FFLAS::FFLAS_DIAG) A.getDiag(), B.rowdim(), B.coldim(), field().one,
+							       A.getPointer(), A.getStride(), B.getPointer(), B.getStride(), _policy);
+			return true;
+		}
+
 	public:
 
 		/** Print matrix.
@@ -0,0 +1,583 @@
+/* linbox/matrix/sliced3/packed-gf3.h
+ * Copyright (C) LinBox
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file matrix/sliced3/packed-gf3.h
+ * @ingroup matrix
+ * @brief Bitsliced dense matrices over GF(3) with vector word kernels.
+ *
+ * Each row holds two bit-planes, as in SlicedBase: plane 0 marks the
+ * nonzero entries, plane 1 the entries equal to 2.  The planes are
+ * padded to 512 bits, so that the row operations run on AVX-512 or
+ * AVX2 words when the compiler targets them, on 64-bit words otherwise.
+ * Multiplication uses Four-Russians tables over column blocks,
+ * elimination the same tables over batches of pivots (M4RI style).
+ * A matrix may live in a file mapped in memory.
+ */
+
+#ifndef __LINBOX_matrix_sliced3_packed_gf3_H
+#define __LINBOX_matrix_sliced3_packed_gf3_H
+
+#include "linbox/linbox-config.h"
+#include "linbox/integer.h"
+#include "linbox/util/error.h"
+#include "linbox/util/parallel-policy.h"
+#include "linbox/matrix/dense-matrix.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#if defined(__LINBOX_HAVE_AVX2_INSTRUCTIONS) || defined(__LINBOX_HAVE_AVX512F_INSTRUCTIONS)
+#include <immintrin.h>
+#endif
+
+namespace LinBox
+{
+
+	namespace Protected {
+
+		// Bitwise operations on one word of each plane
+		struct GF3Word64 {
+			typedef uint64_t V;
+			static const size_t lanes = 1;
+			static V load (const uint64_t* p) { return *p; }
+			static void store (uint64_t* p, V v) { *p = v; }
+			static V bxor (V a, V b) { return a ^ b; }
+			static V band (V a, V b) { return a & b; }
+			static V bor (V a, V b) { return a | b; }
+		};
+
+#if defined(__LINBOX_HAVE_AVX512F_INSTRUCTIONS)
+		struct GF3WordVec {
+			typedef __m512i V;
+			static const size_t lanes = 8;
+			static V load (const uint64_t* p) { return _mm512_loadu_si512((const void*)p); }
+			static void store (uint64_t* p, V v) { _mm512_storeu_si512((void*)p, v); }
+			static V bxor (V a, V b) { return _mm512_xor_si512(a, b); }
+			static V band (V a, V b) { return _mm512_and_si512(a, b); }
+			static V bor (V a, V b) { return _mm512_or_si512(a, b); }
+		};
+#elif defined(__LINBOX_HAVE_AVX2_INSTRUCTIONS)
+		struct GF3WordVec {
+			typedef __m256i V;
+			static const size_t lanes = 4;
+			static V load (const uint64_t* p) { return _mm256_loadu_si256((const __m256i*)p); }
+			static void store (uint64_t* p, V v) { _mm256_storeu_si256((__m256i*)p, v); }
+			static V bxor (V a, V b) { return _mm256_xor_si256(a, b); }
+			static V band (V a, V b) { return _mm256_and_si256(a, b); }
+			static V bor (V a, V b) { return _mm256_or_si256(a, b); }
+		};
+#else
+		typedef GF3Word64 GF3WordVec;
+#endif
+
+		// (x0, x1) + (y0, y1), or - when Negate: the addition of SlicedBase
+		template <class W, bool Negate>
+		inline void gf3Add (typename W::V& x0, typename W::V& x1, typename W::V y0, typename W::V y1)
+		{
+			if (Negate) y1 = W::bxor(y1, y0);
+			typename W::V a = W::bxor(x0, y1), b = W::bxor(x1, y0);
+			typename W::V s = W::bxor(a, x1), t = W::bxor(b, y1);
+			x1 = W::band(a, b);
+			x0 = W::bor(s, t);
+		}
+
+		// z = x + y, or x - y when Negate, on the planes of words words; z may be x
+		template <bool Negate>
+		inline void gf3RowAdd (uint64_t* z0, uint64_t* z1,
+				       const uint64_t* x0, const uint64_t* x1,
+				       const uint64_t* y0, const uint64_t* y1, size_t words)
+		{
+			typedef GF3WordVec W;
+			size_t k = 0;
+			for (; k + W::lanes <= words; k += W::lanes) {
+				typename W::V a0 = W::load(x0 + k), a1 = W::load(x1 + k);
+				gf3Add<W, Negate>(a0, a1, W::load(y0 + k), W::load(y1 + k));
+				W::store(z0 + k, a0);
+				W::store(z1 + k, a1);
+			}
+			for (; k < words; ++k) {
+				uint64_t a0 = x0[k], a1 = x1[k];
+				gf3Add<GF3Word64, Negate>(a0, a1, y0[k], y1[k]);
+				z0[k] = a0;
+				z1[k] = a1;
+			}
+		}
+
+		// nbits (<= 8) bits of a plane from column c
+		inline unsigned gf3Bits (const uint64_t* p, size_t c, size_t nbits)
+		{
+			const size_t w = c / 64, o = c % 64;
+			uint64_t v = p[w] >> o;
+			if (o + nbits > 64) v |= p[w + 1] << (64 - o);
+			return (unsigned)(v & ((uint64_t(1) << nbits) - 1));
+		}
+	}
+
+	/** \brief Dense matrix over GF(3), two bit-planes per row.
+	 *
+	 * Entries are 0, 1, 2, stored on 2 bits.  Storage is either on the
+	 * heap or in a file mapped in memory (MAP_SHARED): the file holds
+	 * the rows one after the other, plane 0 then plane 1, and can be
+	 * mapped again later with the same dimensions.
+	 */
+	class GF3PackedMatrix {
+	public:
+		typedef uint64_t Word;
+		static const size_t WordBits = 64;
+		static const size_t RowAlign = 8; //!< words, a 512 bit vector
+
+		/// Zero m x n matrix on the heap
+		GF3PackedMatrix (size_t m, size_t n) :
+			_rows(m), _cols(n), _words(paddedWords(n)), _data(nullptr), _mapped(false)
+		{
+			const size_t bytes = std::max<size_t>(byteSize(), 64);
+			void* p = nullptr;
+			if (posix_memalign(&p, 64, bytes) != 0)
+				throw LinboxError("GF3PackedMatrix: out of memory");
+			std::memset(p, 0, bytes);
+			_data = static_cast<Word*>(p);
+		}
+
+		/** m x n matrix in the file path.
+		 *
+		 * A new or empty file is created zero; an existing file must have
+		 * the size of the matrix and keeps its entries.
+		 */
+		GF3PackedMatrix (size_t m, size_t n, const std::string& path) :
+			_rows(m), _cols(n), _words(paddedWords(n)), _data(nullptr), _mapped(true)
+		{
+			const size_t bytes = std::max<size_t>(byteSize(), 64);
+			int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+			if (fd < 0)
+				throw LinboxError("GF3PackedMatrix: cannot open " + path);
+			struct stat st;
+			if (::fstat(fd, &st) != 0 || (st.st_size != 0 && (size_t)st.st_size != bytes)) {
+				::close(fd);
+				throw LinboxError("GF3PackedMatrix: " + path + " does not have the size of the matrix");
+			}
+			if (st.st_size == 0 && ::ftruncate(fd, (off_t)bytes) != 0) {
+				::close(fd);
+				throw LinboxError("GF3PackedMatrix: cannot resize " + path);
+			}
+			void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+			::close(fd);
+			if (p == MAP_FAILED)
+				throw LinboxError("GF3PackedMatrix: cannot map " + path);
+			_data = static_cast<Word*>(p);
+		}
+
+		GF3PackedMatrix (const GF3PackedMatrix&) = delete;
+		GF3PackedMatrix& operator= (const GF3PackedMatrix&) = delete;
+
+		GF3PackedMatrix (GF3PackedMatrix&& other) :
+			_rows(other._rows), _cols(other._cols), _words(other._words),
+			_data(other._data), _mapped(other._mapped)
+		{
+			other._data = nullptr;
+		}
+
+		~GF3PackedMatrix ()
+		{
+			if (_data == nullptr) return;
+			if (_mapped) ::munmap(_data, std::max<size_t>(byteSize(), 64));
+			else std::free(_data);
+		}
+
+		size_t rowdim () const { return _rows; }
+		size_t coldim () const { return _cols; }
+		/// Words of each plane of a row
+		size_t words () const { return _words; }
+		bool isMapped () const { return _mapped; }
+
+		Word* plane0 (size_t i) { return _data + 2 * _words * i; }
+		Word* plane1 (size_t i) { return _data + 2 * _words * i + _words; }
+		const Word* plane0 (size_t i) const { return _data + 2 * _words * i; }
+		const Word* plane1 (size_t i) const { return _data + 2 * _words * i + _words; }
+
+		unsigned getEntry (size_t i, size_t j) const
+		{
+			const size_t w = j / WordBits, o = j % WordBits;
+			return (unsigned)(((plane0(i)[w] >> o) & 1) + ((plane1(i)[w] >> o) & 1));
+		}
+
+		void setEntry (size_t i, size_t j, unsigned e)
+		{
+			const size_t w = j / WordBits;
+			const Word bit = Word(1) << (j % WordBits);
+			e %= 3;
+			plane0(i)[w] = (e != 0) ? (plane0(i)[w] | bit) : (plane0(i)[w] & ~bit);
+			plane1(i)[w] = (e == 2) ? (plane1(i)[w] | bit) : (plane1(i)[w] & ~bit);
+		}
+
+		/// Rows of 2 bit residues, packed word by word
+		template <class Residue>
+		void setRow (size_t i, Residue residue)
+		{
+			Word* p0 = plane0(i);
+			Word* p1 = plane1(i);
+			for (size_t w = 0; w * WordBits < _cols; ++w) {
+				Word b0 = 0, b1 = 0;
+				const size_t end = std::min(_cols - w * WordBits, WordBits);
+				for (size_t o = 0; o < end; ++o) {
+					const unsigned e = residue(w * WordBits + o);
+					b0 |= Word(e != 0) << o;
+					b1 |= Word(e == 2) << o;
+				}
+				p0[w] = b0;
+				p1[w] = b1;
+			}
+		}
+
+		void swapRows (size_t i, size_t k)
+		{
+			if (i != k) std::swap_ranges(plane0(i), plane0(i) + 2 * _words, plane0(k));
+		}
+
+		/// Row i times 2
+		void negateRow (size_t i)
+		{
+			Word* p0 = plane0(i);
+			Word* p1 = plane1(i);
+			for (size_t w = 0; w < _words; ++w) p1[w] ^= p0[w];
+		}
+
+		void zero () { std::memset(_data, 0, byteSize()); }
+
+	private:
+		static size_t paddedWords (size_t n)
+		{
+			const size_t w = (n + WordBits - 1) / WordBits;
+			return (w + RowAlign - 1) / RowAlign * RowAlign;
+		}
+
+		size_t byteSize () const { return 2 * _words * _rows * sizeof(Word); }
+
+		size_t _rows, _cols, _words;
+		Word* _data;
+		bool _mapped;
+	};
+
+	/** \brief Multiplication and elimination on GF3PackedMatrix.
+	 *
+	 * The ParallelPolicy gives the threads of the column blocks of the
+	 * multiplication and of the row updates of the elimination.
+	 */
+	class GF3PackedDomain {
+	public:
+		typedef GF3PackedMatrix::Word Word;
+
+		static const size_t TableBits = 8;    //!< rows of a Four-Russians table
+		static const size_t BlockWords = 64;  //!< words of a column block: 256 tables of 4096 columns fit L2
+
+		GF3PackedDomain (const ParallelPolicy& policy = ParallelPolicy()) : _policy(policy) {}
+
+		/// C = A B
+		GF3PackedMatrix& mul (GF3PackedMatrix& C, const GF3PackedMatrix& A, const GF3PackedMatrix& B) const
+		{
+			C.zero();
+			return axpyin(C, A, B);
+		}
+
+		/// C += A B
+		GF3PackedMatrix& axpyin (GF3PackedMatrix& C, const GF3PackedMatrix& A, const GF3PackedMatrix& B) const
+		{
+			linbox_check(A.coldim() == B.rowdim() && C.rowdim() == A.rowdim() && C.coldim() == B.coldim());
+			const size_t m = A.rowdim(), k = A.coldim(), W = B.words();
+			if (m == 0 || k == 0 || W == 0) return C;
+
+			const size_t threads = _policy.worthIt(m, B.coldim(), k) ? _policy.threads() : 1;
+			size_t bw = std::min(BlockWords, W);
+			if (threads > 1)
+				bw = std::min(bw, std::max(GF3PackedMatrix::RowAlign, (W / threads + 7) / 8 * 8));
+			const long blocks = (long)((W + bw - 1) / bw);
+
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel num_threads((int)threads) if (threads > 1)
+#endif
+			{
+				std::vector<Word> T((size_t(1) << TableBits) * 2 * bw);
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp for schedule(dynamic, 1)
+#endif
+				for (long jb = 0; jb < blocks; ++jb) {
+					const size_t w0 = (size_t)jb * bw, len = std::min(bw, W - w0);
+					for (size_t g = 0; g < k; g += TableBits) {
+						const size_t t = std::min(TableBits, k - g);
+						buildTable(T.data(), len, B, g, t, w0);
+						for (size_t i = 0; i < m; ++i) {
+							const unsigned nz = Protected::gf3Bits(A.plane0(i), g, t);
+							const unsigned two = Protected::gf3Bits(A.plane1(i), g, t);
+							addTableRows(C.plane0(i) + w0, C.plane1(i) + w0, T.data(), len, nz & ~two, two);
+						}
+					}
+				}
+			}
+			return C;
+		}
+
+		/// Rank of A, which is reduced to a row echelon form
+		size_t rankInPlace (GF3PackedMatrix& A) const
+		{
+			unsigned d;
+			return echelonInPlace(A, d);
+		}
+
+		/// Determinant (0, 1 or 2) of the square A, which is reduced to a row echelon form
+		unsigned detInPlace (GF3PackedMatrix& A) const
+		{
+			if (A.rowdim() != A.coldim())
+				throw LinboxError("LinBox ERROR: matrix must be square for determinant computation\n");
+			unsigned d;
+			return (echelonInPlace(A, d) == A.rowdim()) ? d : 0;
+		}
+
+		/** \brief Row echelon form of A, in place.
+		 *
+		 * Pivots are searched TableBits columns at a time: a candidate row
+		 * only receives the pivots of its batch when it is read.  Once the
+		 * pivots of a batch are reduced to the identity on their columns,
+		 * the remaining rows subtract them through a table of their sums.
+		 * @param d product of the pivots, times the sign of the row swaps
+		 * @return the rank
+		 */
+		size_t echelonInPlace (GF3PackedMatrix& A, unsigned& d) const
+		{
+			const size_t m = A.rowdim(), n = A.coldim();
+			std::vector<size_t> applied(m, 0);
+			std::vector<unsigned> masks(2 * m, 0);
+			std::vector<Word> T;
+			size_t r = 0, col = 0;
+			d = 1;
+
+			while (r < m && col < n) {
+				const size_t start = r;
+				size_t pivots[TableBits];
+				size_t t = 0;
+				std::fill(applied.begin() + (ptrdiff_t)start, applied.end(), size_t(0));
+
+				for (; t < TableBits && r < m && col < n; ++col) {
+					size_t piv = m;
+					for (size_t i = r; i < m; ++i) {
+						for (size_t j = applied[i]; j < t; ++j)
+							reduceRow(A, i, start + j, A.getEntry(i, pivots[j]));
+						applied[i] = t;
+						if (A.getEntry(i, col) != 0) { piv = i; break; }
+					}
+					if (piv == m) continue;
+
+					if (piv != r) {
+						A.swapRows(piv, r);
+						std::swap(applied[piv], applied[r]);
+						d = (2 * d) % 3;
+					}
+					if (A.getEntry(r, col) == 2) {
+						A.negateRow(r);
+						d = (2 * d) % 3;
+					}
+					for (size_t j = 0; j < t; ++j)
+						reduceRow(A, start + j, r, A.getEntry(start + j, col));
+					pivots[t++] = col;
+					++r;
+				}
+				if (t == 0) break;
+
+				// The rows below the batch subtract their combination of its pivots.
+				for (size_t i = r; i < m; ++i) {
+					unsigned nz = 0, two = 0;
+					for (size_t j = applied[i]; j < t; ++j) {
+						const unsigned e = A.getEntry(i, pivots[j]);
+						nz |= unsigned(e != 0) << j;
+						two |= unsigned(e == 2) << j;
+					}
+					// e P_j is subtracted: the ones with a minus, the twos with a plus
+					masks[2 * i] = nz & ~two;
+					masks[2 * i + 1] = two;
+				}
+				if (r == m) break;
+
+				const size_t wStart = pivots[0] / GF3PackedMatrix::WordBits, W = A.words() - wStart;
+				const size_t bw = std::min(BlockWords, W);
+				T.resize((size_t(1) << t) * 2 * bw);
+#ifdef __LINBOX_USE_OPENMP
+				const size_t threads = _policy.worthIt(m - r, n) ? _policy.threads() : 1;
+#endif
+				for (size_t w0 = wStart; w0 < A.words(); w0 += bw) {
+					const size_t len = std::min(bw, A.words() - w0);
+					buildTable(T.data(), len, A, start, t, w0);
+					const long rows = (long)(m - r);
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for num_threads((int)threads) schedule(dynamic, 64) if (threads > 1)
+#endif
+					for (long ii = 0; ii < rows; ++ii) {
+						const size_t i = r + (size_t)ii;
+						// subtracting the ones and adding the twos is adding the table with swapped masks
+						addTableRows(A.plane0(i) + w0, A.plane1(i) + w0, T.data(), len, masks[2 * i + 1], masks[2 * i]);
+					}
+				}
+			}
+			return r;
+		}
+
+	private:
+		// Row i -= e row p
+		static void reduceRow (GF3PackedMatrix& A, size_t i, size_t p, unsigned e)
+		{
+			const size_t W = A.words();
+			if (e == 1)
+				Protected::gf3RowAdd<true>(A.plane0(i), A.plane1(i), A.plane0(i), A.plane1(i), A.plane0(p), A.plane1(p), W);
+			else if (e == 2)
+				Protected::gf3RowAdd<false>(A.plane0(i), A.plane1(i), A.plane0(i), A.plane1(i), A.plane0(p), A.plane1(p), W);
+		}
+
+		// T[s] = sum of the rows first + j of B, j in s, on the words [w0, w0 + len)
+		static void buildTable (Word* T, size_t len, const GF3PackedMatrix& B, size_t first, size_t t, size_t w0)
+		{
+			std::fill(T, T + 2 * len, Word(0));
+			for (size_t s = 1; s < (size_t(1) << t); ++s) {
+				size_t j = 0;
+				while (((s >> j) & 1) == 0) ++j;
+				const Word* prev = T + 2 * len * (s & (s - 1));
+				Word* cur = T + 2 * len * s;
+				Protected::gf3RowAdd<false>(cur, cur + len, prev, prev + len,
+							   B.plane0(first + j) + w0, B.plane1(first + j) + w0, len);
+			}
+		}
+
+		// (c0, c1) += T[plus] - T[minus]
+		static void addTableRows (Word* c0, Word* c1, const Word* T, size_t len, unsigned plus, unsigned minus)
+		{
+			if (plus) {
+				const Word* p = T + 2 * len * plus;
+				Protected::gf3RowAdd<false>(c0, c1, c0, c1, p, p + len, len);
+			}
+			if (minus) {
+				const Word* p = T + 2 * len * minus;
+				Protected::gf3RowAdd<true>(c0, c1, c0, c1, p, p + len, len);
+			}
+		}
+
+		ParallelPolicy _policy;
+	};
+
+	namespace Protected {
+
+		/// Square dimension from which rank and det over GF(3) go to GF3PackedDomain
+		static const size_t GF3PackedThreshold = 32;
+
+		template <class Field>
+		bool useGF3Packed (const Field& F, size_t m, size_t n)
+		{
+			integer c, q;
+			F.characteristic(c);
+			F.cardinality(q);
+			return c == 3 && q == 3 && std::min(m, n) >= GF3PackedThreshold;
+		}
+
+		// Residue in {0, 1, 2} of an element of a field with 3 elements
+		template <class Field>
+		unsigned gf3Residue (const Field& F, const typename Field::Element& e)
+		{
+			return F.isZero(e) ? 0 : (F.isOne(e) ? 1 : 2);
+		}
+
+		template <class Field, class Rep>
+		void gf3Pack (GF3PackedMatrix& P, const BlasMatrix<Field, Rep>& A)
+		{
+			const Field& F = A.field();
+			for (size_t i = 0; i < A.rowdim(); ++i)
+				P.setRow(i, [&](size_t j) { return gf3Residue(F, A.getEntry(i, j)); });
+		}
+
+		// Sparse matrices: their stored entries, P being zero
+		template <class Matrix>
+		auto gf3PackEntries (GF3PackedMatrix& P, const Matrix& A, int)
+		-> decltype((void)A.IndexedBegin(), (void)A.IndexedEnd(), void())
+		{
+			const auto& F = A.field();
+			for (auto it = A.IndexedBegin(); it != A.IndexedEnd(); ++it)
+				P.setEntry(it.rowIndex(), it.colIndex(), gf3Residue(F, it.value()));
+		}
+
+		// Other blackboxes: one column per apply
+		template <class Blackbox>
+		void gf3PackEntries (GF3PackedMatrix& P, const Blackbox& A, long)
+		{
+			typedef typename Blackbox::Field Field;
+			const Field& F = A.field();
+			BlasVector<Field> e(F, A.coldim()), c(F, A.rowdim());
+			for (size_t j = 0; j < A.coldim(); ++j) {
+				F.assign(e[j], F.one);
+				A.apply(c, e);
+				F.assign(e[j], F.zero);
+				for (size_t i = 0; i < A.rowdim(); ++i)
+					P.setEntry(i, j, gf3Residue(F, c[i]));
+			}
+		}
+
+		template <class Blackbox>
+		void gf3Pack (GF3PackedMatrix& P, const Blackbox& A)
+		{
+			gf3PackEntries(P, A, 0);
+		}
+
+		/// Rank of A over GF(3) on the packed matrix
+		template <class Blackbox>
+		size_t gf3PackedRank (const Blackbox& A, const ParallelPolicy& policy)
+		{
+			GF3PackedMatrix P(A.rowdim(), A.coldim());
+			gf3Pack(P, A);
+			return GF3PackedDomain(policy).rankInPlace(P);
+		}
+
+		/// Determinant of A over GF(3) on the packed matrix
+		template <class Blackbox>
+		typename Blackbox::Field::Element& gf3PackedDet (typename Blackbox::Field::Element& d,
+								 const Blackbox& A, const ParallelPolicy& policy)
+		{
+			GF3PackedMatrix P(A.rowdim(), A.coldim());
+			gf3Pack(P, A);
+			return A.field().init(d, (long)GF3PackedDomain(policy).detInPlace(P));
+		}
+	}
+
+} // LinBox
+
+#endif // __LINBOX_matrix_sliced3_packed_gf3_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
@@ -71,6 +71,7 @@ namespace LinBox {
 		// class VMap : public ANY {} ; // vector of index to value maps.
 		// template<class Row_t>
 		class SparseSeq    /* CoP  */ : public ANY {} ;//!< vector/list of pairs (Container of Pairs). SparseSequence.
+		class SparseSeqArena /* CoP  */ : public ANY {} ;//!< SparseSeq with rows allocated in a per-matrix SparseRowArena.
 		// template<class Row_t>
 		class SparsePar /* CoM  */ : public ANY {} ;//!< vector/list of pairs (Container of Maps). SparseAssociative.
 		// template<class Row_t>
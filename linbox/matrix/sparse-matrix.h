@@ -80,6 +80,7 @@ namespace LinBox {
 // #include "linbox/matrix/sparsematrix/sparse-dia-matrix.h"
 // #include "linbox/matrix/sparsematrix/sparse-hyb-matrix.h"
 #include "linbox/matrix/sparsematrix/sparse-map-map-matrix.h"
+#include "linbox/matrix/sparsematrix/sparse-sequence-arena.h"
 
 #include "linbox/matrix/sparsematrix/sparse-tpl-matrix.h"
 #ifdef __LINBOX_USE_OPENMP
@@ -38,6 +38,7 @@
 
 #include "linbox/linbox-config.h"
 #include "linbox/util/debug.h"
+#include "linbox/util/counters.h"
 #include "linbox/field/hom.h"
 #include "sparse-domain.h"
 
@@ -726,6 +727,7 @@ namespace LinBox
 		{
 			// linbox_check(consistent());
 			prepare(field(),y,a);
+			LINBOX_COUNT_SPMV(_nbnz, _nbnz*(sizeof(Element)+2*sizeof(size_t)) + (_rownb+_colnb)*sizeof(Element));
 
 			size_t z = 0 ;
 			size_t last_i = 0 ;
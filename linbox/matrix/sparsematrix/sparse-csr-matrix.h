@@ -38,6 +38,7 @@
 
 #include "linbox/linbox-config.h"
 #include "linbox/util/debug.h"
+#include "linbox/util/counters.h"
 #include "linbox/field/hom.h"
 #include "sparse-domain.h"
 #include "givaro/zring.h"
@@ -825,6 +826,7 @@ namespace LinBox {
 		{
 			// linbox_check(consistent());
 			prepare(field(),y,a);
+			LINBOX_COUNT_SPMV(_nbnz, _nbnz*(sizeof(Element)+sizeof(index_t)) + (_rownb+_colnb)*sizeof(Element));
 
 
 			// std::cout << "apply" << std::endl;
@@ -38,6 +38,7 @@
 
 #include "linbox/linbox-config.h"
 #include "linbox/util/debug.h"
+#include "linbox/util/counters.h"
 #include "linbox/field/hom.h"
 #include "sparse-domain.h"
 
@@ -768,6 +769,8 @@ namespace LinBox
 		{
 			// linbox_check(consistent());
 			prepare(field(),y,a);
+			// padded rows are streamed up to their first zero
+			LINBOX_COUNT_SPMV(_nbnz, _rownb*_maxc*(sizeof(Element)+sizeof(size_t)) + (_rownb+_colnb)*sizeof(Element));
 
 
 			FieldAXPY<Field> accu(field());
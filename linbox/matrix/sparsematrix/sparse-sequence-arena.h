@@ -0,0 +1,160 @@
+/* linbox/matrix/sparsematrix/sparse-sequence-arena.h
+ * Copyright (C) LinBox
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ *.
+ */
+
+/** @file linbox/matrix/sparsematrix/sparse-sequence-arena.h
+ * @brief SparseSeq storage whose rows live in a SparseRowArena.
+ *
+ * Meant for sparse eliminations (GaussDomain, PowerGaussDomain): the
+ * fill-in is served by the arena free lists instead of malloc/free, and
+ * the whole row memory is given back at once with the matrix.
+ */
+
+#ifndef __LINBOX_matrix_sparsematrix_sparse_sequence_arena_H
+#define __LINBOX_matrix_sparsematrix_sparse_sequence_arena_H
+
+#include <memory>
+#include "linbox/util/sparse-row-arena.h"
+
+namespace LinBox
+{
+	namespace Protected {
+		//! Holds the arena; a base class so that it outlives the rows
+		struct SparseRowArenaHolder {
+			std::unique_ptr<SparseRowArena> _arena;
+			SparseRowArenaHolder () : _arena(new SparseRowArena) {}
+		};
+	}
+
+	template <class _Field>
+	class SparseMatrix<_Field, SparseMatrixFormat::SparseSeqArena > :
+		protected Protected::SparseRowArenaHolder,
+		public Protected::SparseMatrixGeneric<_Field, typename Vector<_Field>::SparseSeqArena, VectorCategories::SparseSequenceVectorTag>
+	{
+	public:
+		typedef VectorCategories::SparseSequenceVectorTag  myTrait ;
+		typedef _Field                                       Field ; //!< Field
+		typedef typename _Field::Element                   Element ; //!< Element
+		typedef const Element                         constElement ; //!< const Element
+		typedef typename Vector<_Field>::SparseSeqArena        Row ;
+		typedef SparseMatrixFormat::SparseSeqArena         Storage ; //!< Matrix Storage Format
+		typedef SparseMatrix<_Field,Storage>               Self_t ; //!< Self type
+		typedef Protected::SparseMatrixGeneric<_Field,Row,myTrait >         Father_t ;
+
+	public:
+		SparseMatrix(const Field & F, size_t m, size_t n) :
+			Father_t(F, m, n)
+		{ bindRows(); }
+
+		SparseMatrix(const Field & F) :
+			Father_t(F)
+		{ bindRows(); }
+
+		SparseMatrix ( MatrixStream<Field>& ms ) :
+			Father_t(ms)
+		{ bindRows(); }
+
+		SparseMatrix (const Self_t& A) :
+			Protected::SparseRowArenaHolder(),
+			Father_t(A.field(), A.rowdim(), A.coldim())
+		{
+			bindRows();
+			for(size_t i=0; i<A.rowdim(); ++i) this->_matA[i] = A._matA[i];
+		}
+
+		template<typename _Tp1, typename _Rw1>
+		SparseMatrix (const SparseMatrix<_Tp1, _Rw1> &Mat, const Field& F) :
+			Father_t(F,Mat.rowdim(),Mat.coldim())
+		{
+			bindRows();
+			typename SparseMatrix<_Tp1,_Rw1>::template rebind<Field,Storage>()(*this, Mat);
+		}
+
+		template<typename _Tp1, typename _Rw1>
+		SparseMatrix (const SparseMatrix<_Tp1, _Rw1> &Mat) :
+			Father_t(Mat.field(),Mat.rowdim(),Mat.coldim())
+		{
+			bindRows();
+			typename SparseMatrix<_Tp1,_Rw1>::template rebind<Field,Storage>()(*this, Mat);
+		}
+
+		template<typename _Tp1, typename _R1 = SparseMatrixFormat::SparseSeqArena >
+		struct rebind {
+			typedef SparseMatrix<_Tp1, _R1> other;
+
+			void operator() (other & Ap, const Self_t& A) {
+
+				typename _Tp1::Element e;
+
+				Hom<typename Self_t::Field, _Tp1> hom(A.field(), Ap.field());
+				for( auto indices = A.IndexedBegin();
+				     (indices != A.IndexedEnd()) ;
+				     ++indices ) {
+					hom. image (e, indices.value() );
+					if (!Ap.field().isZero(e))
+						Ap.setEntry (indices.rowIndex(),
+							     indices.colIndex(), e);
+				}
+			}
+
+		};
+
+		//! Arena holding the rows
+		SparseRowArena* arena() const { return this->_arena.get(); }
+
+		//! Row vectors are bound to the arena of the matrix
+		void resize( const size_t & m, const size_t & n, const size_t & nnz = 0)
+		{
+			Father_t::resize(m,n,nnz);
+			bindRows();
+		}
+
+	protected:
+		void bindRows ()
+		{
+			for(auto & row: this->_matA)
+				if (row.get_allocator().arena() != arena()) {
+					Row tmp { ArenaAllocator<typename Row::value_type>(arena()) };
+					tmp.assign(row.begin(), row.end());
+					row = std::move(tmp);
+				}
+		}
+	} ; // SparseMatrix
+
+	//! Gauss engines make the matrix arena current while eliminating
+	template<class _Field>
+	SparseRowArena* eliminationArena (const SparseMatrix<_Field, SparseMatrixFormat::SparseSeqArena>& A)
+	{
+		return A.arena();
+	}
+
+} // namespace LinBox
+
+#endif // __LINBOX_matrix_sparsematrix_sparse_sequence_arena_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
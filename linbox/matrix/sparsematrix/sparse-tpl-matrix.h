@@ -40,6 +40,7 @@
 #include "linbox/linbox-config.h"
 #include "linbox/util/debug.h"
 #include "linbox/util/field-axpy.h"
+#include "linbox/util/counters.h"
 #include "linbox/blackbox/blackbox-interface.h"
 #include "linbox/blackbox/blockbb.h"
 #include "linbox/field/hom.h"
@@ -180,6 +180,7 @@ OutVector & SparseMatrix<Field_,SparseMatrixFormat::TPL>::apply(OutVector & y, c
 {
 	linbox_check( rowdim() == y.size() );
 	linbox_check( coldim() == x.size() );
+	LINBOX_COUNT_SPMV(data_.size(), data_.size()*sizeof(Triple) + (rowdim()+coldim())*sizeof(Element));
 	for (Index i = 0; i < y.size(); ++i) field().assign(y[i], field().zero);
 	for (Index k = 0; k < data_.size(); ++k) {
 		Triple t = data_[k];
@@ -195,6 +196,7 @@ OutVector & SparseMatrix<Field_,SparseMatrixFormat::TPL>::applyTranspose(OutVect
 {
 	linbox_check( coldim() == y.size() );
 	linbox_check( rowdim() == x.size() );
+	LINBOX_COUNT_SPMV(data_.size(), data_.size()*sizeof(Triple) + (rowdim()+coldim())*sizeof(Element));
 	for (Index i = 0; i < y.size(); ++i) field().assign(y[i], field().zero);
 	for (Index k = 0; k < data_.size(); ++k) {
 		const Triple& t = data_[k];
@@ -133,6 +133,18 @@ namespace LinBox
 		}
 
         uint64_t getBits() const {return _bits;}
+
+            /** @brief Moves the iterator to a given prime.
+             *  Used to resume from a checkpoint: the deterministic
+             *  iterator then continues below \p p.
+             *  @param p a prime of at most \p bits bits.
+             *  @param bits the bit size.
+             */
+		void setPrime(const Prime_Type& p, uint64_t bits) {
+			linbox_check(bits >1);
+			_bits = bits;
+			_prime = p;
+		}
 	};
 
     template<>
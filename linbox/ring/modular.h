@@ -66,6 +66,10 @@ namespace LinBox {
 #include "linbox/ring/modular/modular-double.h"
 #include "linbox/ring/modular/modular-float.h"
 #include "linbox/ring/modular/modular-unsigned.h"
+#include "linbox/ring/modular/modular-balanced-int32.h"
+#include "linbox/ring/modular/modular-balanced-int64.h"
+#include "linbox/ring/modular/modular-balanced-double.h"
+#include "linbox/ring/modular/modular-balanced-float.h"
 
 #endif // __LINBOX_field_modular_H
 
@@ -0,0 +1,397 @@
+/* linbox/ring/modular/modular-delayed.h
+ * Copyright (C) LinBox
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file ring/modular/modular-delayed.h
+ * @ingroup ring
+ * @brief Delayed reduction of sums of products over word size Givaro fields.
+ *
+ * The products of two elements are added into a wider accumulator and
+ * reduced only when the next ones could leave its exact range.  The number
+ * of products between two reductions is computed once from the modulus and
+ * the element range (positive or balanced) of the field.  The accumulator is
+ * chosen from the element type:
+ * - \c float and \c double : \c double, exact up to \f$2^{53}\f$ ;
+ * - integers of at most 32 bits : \c int64_t or \c uint64_t ;
+ * - 64 bit integers : \c __int128 or <code>unsigned __int128</code>, when the compiler has them.
+ *
+ * Without a wider accumulator the field reduces at every product.
+ */
+
+#ifndef __LINBOX_modular_delayed_H
+#define __LINBOX_modular_delayed_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <type_traits>
+
+#include "linbox/linbox-config.h"
+#include "linbox/util/debug.h"
+#include "linbox/vector/vector-traits.h"
+
+namespace LinBox
+{
+	template <class Field>
+	class VectorDomainBase;
+	template <class Field>
+	class VectorDomain;
+
+	namespace Protected {
+
+		/*! Accumulator of the products of two \p Element.
+		 * \c Type holds sums of products exactly up to \c capacity() in
+		 * magnitude; \c Bound is an unsigned type wide enough to compute
+		 * the delay.  \c delayed is false when there is no such type.
+		 */
+		template <class Element, class Enable = void>
+		struct DelayedAccumulator {
+			typedef Element Type;
+			typedef uint64_t Bound;
+			static const bool delayed = false;
+			static Bound capacity() { return 0; }
+			static Type reduce (const Type& y, const Type& p) { return y % p; }
+		};
+
+		template <class Element>
+		struct DelayedAccumulator<Element, typename std::enable_if<std::is_floating_point<Element>::value>::type> {
+			typedef double Type;
+			typedef uint64_t Bound;
+			static const bool delayed = true;
+			static Bound capacity() { return uint64_t(1) << 53; }
+			static Type reduce (const Type& y, const Type& p) { return std::fmod(y, p); }
+		};
+
+		template <class Element>
+		struct DelayedAccumulator<Element, typename std::enable_if<std::is_integral<Element>::value && (sizeof(Element) <= 4)>::type> {
+			typedef typename std::conditional<std::is_signed<Element>::value, int64_t, uint64_t>::type Type;
+			typedef uint64_t Bound;
+			static const bool delayed = true;
+			static Bound capacity() { return (Bound) std::numeric_limits<Type>::max(); }
+			static Type reduce (const Type& y, const Type& p) { return y % p; }
+		};
+
+#ifdef __SIZEOF_INT128__
+		template <class Element>
+		struct DelayedAccumulator<Element, typename std::enable_if<std::is_integral<Element>::value && (sizeof(Element) == 8)>::type> {
+			typedef typename std::conditional<std::is_signed<Element>::value, __int128, unsigned __int128>::type Type;
+			typedef unsigned __int128 Bound;
+			static const bool delayed = true;
+			static Bound capacity()
+			{
+				return std::is_signed<Element>::value ? (~Bound(0)) >> 1 : ~Bound(0);
+			}
+			static Type reduce (const Type& y, const Type& p) { return y % p; }
+		};
+#endif
+
+	} // Protected
+
+	/*! @brief FieldAXPY with delayed reduction for the word size Givaro fields.
+	 * Works for the positive (\c Modular) and balanced (\c ModularBalanced)
+	 * representations alike: only \c minElement() and \c maxElement() of the
+	 * field are used to bound the products.
+	 */
+	template <class Field>
+	class DelayedFieldAXPY {
+	public:
+		typedef typename Field::Element Element;
+		typedef Protected::DelayedAccumulator<Element> Accumulator;
+		typedef typename Accumulator::Type Abnormal;
+
+		DelayedFieldAXPY (const Field &F) :
+			_field (&F), _y (0)
+		{
+			init ();
+		}
+
+		DelayedFieldAXPY (const DelayedFieldAXPY &faxpy) :
+			_field (faxpy._field), _y (faxpy._y), _p (faxpy._p),
+			_delay (faxpy._delay), _left (faxpy._left)
+		{}
+
+		DelayedFieldAXPY &operator = (const DelayedFieldAXPY &faxpy)
+		{
+			_field = faxpy._field;
+			_y = faxpy._y;
+			_p = faxpy._p;
+			_delay = faxpy._delay;
+			_left = faxpy._left;
+			return *this;
+		}
+
+		inline Abnormal& mulacc (const Element &a, const Element &x)
+		{
+			axpyin (_y, a, x);
+			if (--_left == 0) partialReduce ();
+			return _y;
+		}
+
+		inline Abnormal& accumulate (const Element &t)
+		{
+			if (! Accumulator::delayed) {
+				Element y = (Element) _y;
+				field().addin (y, t);
+				return _y = (Abnormal) y;
+			}
+			_y += (Abnormal) t;
+			if (--_left == 0) partialReduce ();
+			return _y;
+		}
+
+		//! As accumulate, for the zero-one blackboxes.
+		inline Abnormal& accumulate_special (const Element &t)
+		{
+			return accumulate (t);
+		}
+
+		inline Element& get (Element &y)
+		{
+			partialReduce ();
+			return y = normal (_y);
+		}
+
+		inline DelayedFieldAXPY &assign (const Element y)
+		{
+			_y = (Abnormal) y;
+			_left = _delay;
+			return *this;
+		}
+
+		inline void reset ()
+		{
+			_y = 0;
+			_left = _delay;
+		}
+
+		inline const Field & field () const { return *_field; }
+
+		//! Number of products added between two reductions.
+		size_t delay () const { return _delay; }
+
+		//! \p y += \p a * \p x, in the field when there is no wider accumulator.
+		inline void axpyin (Abnormal &y, const Element &a, const Element &x) const
+		{
+			if (Accumulator::delayed)
+				y += (Abnormal) a * (Abnormal) x;
+			else {
+				Element e = (Element) y;
+				field().axpyin (e, a, x);
+				y = (Abnormal) e;
+			}
+		}
+
+		//! Reduction of an accumulator of magnitude at most the capacity.
+		inline Abnormal reduce (const Abnormal &y) const
+		{
+			return Accumulator::delayed ? Accumulator::reduce (y, _p) : y;
+		}
+
+		/*! Element of the field equal to a reduced accumulator.
+		 * \p r is in \f$]-p, p[\f$, the field range has width \f$p\f$,
+		 * so one correction at most brings it in.
+		 */
+		inline Element normal (const Abnormal &r) const
+		{
+			Abnormal s = r;
+			if (s < (Abnormal) field().minElement ()) s += _p;
+			else if (s > (Abnormal) field().maxElement ()) s -= _p;
+			return (Element) s;
+		}
+
+	protected:
+		inline void partialReduce ()
+		{
+			_y = reduce (_y);
+			_left = _delay;
+		}
+
+		/*! After a reduction or an assignment the accumulator is less
+		 * than \f$p\f$ in magnitude, and each step adds at most \f$m^2\f$
+		 * where \f$m\f$ is the largest magnitude of an element.
+		 */
+		void init ()
+		{
+			typedef typename Accumulator::Bound Bound;
+			const Element lo = field().minElement (), hi = field().maxElement ();
+			_p = (Abnormal) hi - (Abnormal) lo + 1;
+			_delay = 1;
+			if (Accumulator::delayed) {
+				const Bound m = (Bound) std::max (lo < 0 ? -(Abnormal) lo : (Abnormal) lo, (Abnormal) hi);
+				const Bound p = (Bound) _p;
+				const Bound cap = Accumulator::capacity ();
+				if (m > 0 && cap > p) {
+					const Bound n = (cap - p) / (m * m);
+					const Bound most = (Bound) std::numeric_limits<size_t>::max ();
+					_delay = (size_t) std::max (Bound (1), std::min (n, most));
+				}
+			}
+			_left = _delay;
+		}
+
+		const Field *_field;
+		Abnormal _y;
+		Abnormal _p;
+		size_t _delay;
+		size_t _left;
+	};
+
+	/*! @brief Dot products by blocks of delay products, each block a plain
+	 * loop without test followed by one reduction.
+	 * The delay is that of the FieldAXPY of the domain, which derives
+	 * from DelayedFieldAXPY and is built once with it.
+	 */
+	template <class Field>
+	class DelayedDotProductDomain : public VectorDomainBase<Field> {
+	public:
+		typedef typename Field::Element Element;
+		typedef DelayedFieldAXPY<Field> Delayed;
+		typedef typename Delayed::Abnormal Abnormal;
+		using VectorDomainBase<Field>::field;
+
+		DelayedDotProductDomain () {}
+		DelayedDotProductDomain (const Field &F) :
+			VectorDomainBase<Field> (F)
+		{}
+
+	protected:
+		template <class Vector1, class Vector2>
+		inline Element &dotSpecializedDD (Element &res, const Vector1 &v1, const Vector2 &v2) const
+		{
+			linbox_check (v1.size () == v2.size ());
+			const Delayed& acc = this->faxpy ();
+			const size_t n = v1.size (), d = acc.delay ();
+			typename Vector1::const_iterator i = v1.begin ();
+			typename Vector2::const_iterator j = v2.begin ();
+			Abnormal y = 0;
+			for (size_t k = 0; k < n; ) {
+				const size_t end = std::min (n, k + d);
+				for (; k < end; ++k, ++i, ++j)
+					acc.axpyin (y, *i, *j);
+				y = acc.reduce (y);
+			}
+			return res = acc.normal (y);
+		}
+
+		template <class Vector1, class Vector2>
+		inline Element &dotSpecializedDSP (Element &res, const Vector1 &v1, const Vector2 &v2) const
+		{
+			const Delayed& acc = this->faxpy ();
+			const size_t n = v1.first.size (), d = acc.delay ();
+			typename Vector1::first_type::const_iterator i_idx = v1.first.begin ();
+			typename Vector1::second_type::const_iterator i_elt = v1.second.begin ();
+			Abnormal y = 0;
+			for (size_t k = 0; k < n; ) {
+				const size_t end = std::min (n, k + d);
+				for (; k < end; ++k, ++i_idx, ++i_elt)
+					acc.axpyin (y, *i_elt, v2[*i_idx]);
+				y = acc.reduce (y);
+			}
+			return res = acc.normal (y);
+		}
+	};
+
+	/*! @brief Matrix-vector products by columns, one accumulator per row.
+	 * Each column adds at most one product to each row, so all the rows
+	 * are reduced together once every delay columns, the delay of the
+	 * FieldAXPY of the vector domain.
+	 */
+	template <class Field>
+	class DelayedMVProductDomain {
+	public:
+		typedef typename Field::Element Element;
+		typedef DelayedFieldAXPY<Field> Delayed;
+		typedef typename Delayed::Abnormal Abnormal;
+
+	protected:
+		template <class Vector1, class Matrix, class Vector2>
+		inline Vector1 &mulColDense
+		(const VectorDomain<Field> &VD, Vector1 &w, const Matrix &A, const Vector2 &v) const
+		{
+			linbox_check (A.coldim () == v.size ());
+			linbox_check (A.rowdim () == w.size ());
+
+			const Delayed& acc = VD.faxpy ();
+			_tmp.assign (w.size (), Abnormal (0));
+			size_t left = acc.delay ();
+			typename Matrix::ConstColIterator i = A.colBegin ();
+			for (typename Vector2::const_iterator j = v.begin (); j != v.end (); ++j, ++i) {
+				addColumn (acc, *i, *j, typename VectorTraits<typename Matrix::Column>::VectorCategory ());
+				if (--left == 0) {
+					for (auto& t : _tmp) t = acc.reduce (t);
+					left = acc.delay ();
+				}
+			}
+
+			typename std::vector<Abnormal>::const_iterator l = _tmp.begin ();
+			for (typename Vector1::iterator w_j = w.begin (); w_j != w.end (); ++w_j, ++l)
+				*w_j = acc.normal (acc.reduce (*l));
+			return w;
+		}
+
+	private:
+		template <class Column>
+		inline void addColumn (const Delayed &acc, const Column &c, const Element &x, VectorCategories::DenseVectorTag) const
+		{
+			typename std::vector<Abnormal>::iterator l = _tmp.begin ();
+			for (typename Column::const_iterator k = c.begin (); k != c.end (); ++k, ++l)
+				acc.axpyin (*l, *k, x);
+		}
+
+		template <class Column>
+		inline void addColumn (const Delayed &acc, const Column &c, const Element &x, VectorCategories::SparseSequenceVectorTag) const
+		{
+			for (typename Column::const_iterator k = c.begin (); k != c.end (); ++k)
+				acc.axpyin (_tmp[k->first], k->second, x);
+		}
+
+		template <class Column>
+		inline void addColumn (const Delayed &acc, const Column &c, const Element &x, VectorCategories::SparseAssociativeVectorTag) const
+		{
+			for (typename Column::const_iterator k = c.begin (); k != c.end (); ++k)
+				acc.axpyin (_tmp[k->first], k->second, x);
+		}
+
+		template <class Column>
+		inline void addColumn (const Delayed &acc, const Column &c, const Element &x, VectorCategories::SparseParallelVectorTag) const
+		{
+			typename Column::first_type::const_iterator k_idx = c.first.begin ();
+			typename Column::second_type::const_iterator k_elt = c.second.begin ();
+			for (; k_idx != c.first.end (); ++k_idx, ++k_elt)
+				acc.axpyin (_tmp[*k_idx], *k_elt, x);
+		}
+
+		mutable std::vector<Abnormal> _tmp;
+	};
+
+} // LinBox
+
+#endif //__LINBOX_modular_delayed_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
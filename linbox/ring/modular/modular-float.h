@@ -51,151 +51,39 @@
 #include "linbox/util/field-axpy.h"
 #include "linbox/util/debug.h"
 #include "linbox/field/field-traits.h"
+#include "linbox/ring/modular/modular-delayed.h"
 
 // Namespace in which all LinBox code resides
 namespace LinBox
 {
 	class MultiModFloat;
 
+	/*! The products of two float elements are exact in a \c double,
+	 * where they are delayed, see modular-delayed.h.
+	 */
 	template <>
-	class FieldAXPY<Givaro::Modular<float> > {
+	class FieldAXPY<Givaro::Modular<float> > : public DelayedFieldAXPY<Givaro::Modular<float> > {
 	public:
-
-		typedef float Element;
-		typedef float Abnormal;
 		typedef Givaro::Modular<float> Field;
 
 		FieldAXPY (const Field &F) :
-			_field (&F) , //_invmod(1./field().fcharacteristic()),
-			_y(0.) , _bound( (float) ( (1_i32 << 23) - (uint32_t) (field().characteristic()*field().characteristic())))
-		{}
-
-		FieldAXPY (const FieldAXPY &faxpy) :
-			_field (faxpy._field),// _invmod(faxpy._invmod) ,
-			_y(faxpy._y), _bound(faxpy._bound)
+			DelayedFieldAXPY<Field> (F)
 		{}
-
-		inline Element& mulacc (const Element &a, const Element &x)
-		{
-			Element tmp= a*x;
-			return accumulate(tmp);
-		}
-
-		inline Element& accumulate (const Element &tmp)
-		{
-			_y += tmp;
-			if (_y > _bound)
-				return _y = fmodf (_y, field().fcharacteristic());
-			else
-				return _y;
-		}
-
-		inline Element& get (Element &y)
-		{
-			_y = fmodf (_y, field().fcharacteristic());
-			return y=_y ;
-		}
-
-		inline FieldAXPY &assign (const Element y)
-		{
-			_y = y;
-			return *this;
-		}
-
-		inline void reset()
-		{
-			_y = 0.;
-		}
-
-		inline const Field & field() const { return *_field; }
-
-	private:
-
-		const Field *_field;
-		//float _invmod;
-		float _y;
-		float _bound;
 	};
 
-
 	template <>
-	class DotProductDomain<Givaro::Modular<float> > : public VectorDomainBase<Givaro::Modular<float> > {
-	private:
-		float _bound;
-		size_t _nmax;
-		//float _invmod;
-
+	class DotProductDomain<Givaro::Modular<float> > : public DelayedDotProductDomain<Givaro::Modular<float> > {
 	public:
-		typedef float Element;
-		DotProductDomain (const Givaro::Modular<float> &F) :
-			VectorDomainBase<Givaro::Modular<float> > (F)
-			, _bound( (float) ( (1<<23) - (uint32_t) (F.characteristic()*F.characteristic())))
-			//, _invmod(1./field().fcharacteristic())
-		{
-			_nmax= (size_t)floor((double(1<<11)* double(1<<12))/ double(F.fcharacteristic() * F.fcharacteristic()));
-		}
-
-		using VectorDomainBase<Givaro::Modular<float> >::field;
-	protected:
-		template <class Vector1, class Vector2>
-		inline Element &dotSpecializedDD (Element &res, const Vector1 &v1, const Vector2 &v2) const
-		{
-
-			float y = 0.;
-			if (v1.size() < _nmax) {
-				for (size_t i = 0; i< v1.size();++i)
-					y += v1[i] * v2[i] ;
-				y = fmodf(y, field().fcharacteristic());
-			}
-			else {
-				float t = 0.;
-				size_t i=0;
-				for (;i< v1.size()- _nmax ;i=i+_nmax)
-				{
-					for (size_t j=i;j<i+_nmax;++j)
-						y += v1[j] * v2[j];
-					t+=fmodf(y, field().fcharacteristic());
-					y=0.;
-				}
-				for (;i < v1.size();++i)
-					y += v1[i] * v2[i];
-				t+=fmodf(y, field().fcharacteristic());
-				y = fmodf(t, field().fcharacteristic());
-			}
-			return res = y;
-		}
-
-		template <class Vector1, class Vector2>
-		inline Element &dotSpecializedDSP (Element &res, const Vector1 &v1, const Vector2 &v2) const
-		{
-
-			float y = 0.;
+		typedef Givaro::Modular<float> Field;
 
+		DotProductDomain () {}
+		DotProductDomain (const Field &F) :
+			DelayedDotProductDomain<Field> (F)
+		{}
+	};
 
-			if (v1.first.size() < _nmax)
-			{
-				for (size_t i=0;i<v1.first.size();++i)
-					y+= v1.second[i] * v2[v1.first[i]];
-				y = fmodf(y, field().fcharacteristic());
-			}
-			else
-			{
-				float t =0.;
-				size_t i=0;
-				for (;i< v1.first.size()- _nmax ;i=i+_nmax)
-				{
-					for (size_t j=i;j<i+_nmax;++j)
-						y += v1.second[j] * v2[v1.first[j]];
-					t+=fmodf(y, field().fcharacteristic());
-					y=0.;
-				}
-				for (;i < v1.first.size();++i)
-					y += v1.second[i] * v2[v1.first[i]];
-				t+= fmodf(y, field().fcharacteristic());
-				y = fmodf(t, field().fcharacteristic());
-			}
-			return res = y;
-		}
+	template <>
+	class MVProductDomain<Givaro::Modular<float> > : public DelayedMVProductDomain<Givaro::Modular<float> > {
 	};
 }
 
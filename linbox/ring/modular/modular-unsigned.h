@@ -40,6 +40,8 @@
 #ifndef __LINBOX_field_modular_unsigned_H
 #define __LINBOX_field_modular_unsigned_H
 
+#include "linbox/ring/modular/modular-delayed.h"
+
 //Dan Roche 7-2-04
 #ifndef __LINBOX_MIN
 #define __LINBOX_MIN(a,b) ( (a) < (b) ? (a) : (b) )
@@ -1159,192 +1161,33 @@ namespace LinBox { /*  uint64_t */
 	template<class Field>
 	class MVProductDomain;
 
-        /*! Specialization of FieldAXPY for unsigned short modular field */
-
+	/*! Products of two elements may need 128 bits when p > 2^32, and the
+	 * 2^64 wrap correction then overflows too: they are delayed in an
+	 * <code>unsigned __int128</code>, see modular-delayed.h.
+	 */
 	template<typename Compute_t>
-	class FieldAXPY<Givaro::Modular<uint64_t,Compute_t> > {
+	class FieldAXPY<Givaro::Modular<uint64_t,Compute_t> > : public DelayedFieldAXPY<Givaro::Modular<uint64_t,Compute_t> > {
 	public:
-
-		typedef uint64_t Element;
 		typedef Givaro::Modular<uint64_t,Compute_t> Field;
 
 		FieldAXPY (const Field &F) :
-                _field (&F), _y(0)
-            {
-                _two_64 = (uint64_t(1) << 32) % uint64_t(F.characteristic());
-                _two_64 = (_two_64 * _two_64) % uint64_t(F.characteristic());
-            }
-
-		FieldAXPY (const FieldAXPY &faxpy) :
-                _two_64 (faxpy._two_64), _field (faxpy._field), _y (0)
-            {}
-
-		FieldAXPY<Field > &operator = (const FieldAXPY &faxpy)
-            {
-                _field = faxpy._field;
-                _y = faxpy._y;
-                return *this;
-            }
-
-		inline uint64_t& mulacc (const Element &a, const Element &x)
-            {
-                uint64_t t = (uint64_t) a * (uint64_t) x;
-                _y += t;
-
-                if (_y < t)
-                    return _y += _two_64;
-                else
-                    return _y;
-            }
-
-		inline uint64_t& accumulate (const Element &t)
-            {
-                _y += t;
-
-                if (_y < t)
-                    return _y += _two_64;
-                else
-                    return _y;
-            }
-
-		inline uint64_t& accumulate_special (const Element &t)
-            {
-                return _y += t;
-            }
-
-		inline Element &get (Element &y) const
-            {
-                const_cast<FieldAXPY<Field>*>(this)->_y %= (uint64_t) field().characteristic();
-                    //if ((int64_t) _y < 0) const_cast<FieldAXPY<Field>*>(this)->_y += field().characteristic();
-                return y = (uint64_t) _y;
-            }
-
-		inline FieldAXPY &assign (const Element y)
-            {
-                _y = y;
-                return *this;
-            }
-
-		inline void reset() {
-			_y = 0;
-		}
-
-		inline const Field & field() const { return *_field; }
-		
-	public:
-	
-		uint64_t _two_64;
-		
-	private:
-
-		const Field *_field;
-		uint64_t _y;
+			DelayedFieldAXPY<Field> (F)
+		{}
 	};
 
-        //! Specialization of DotProductDomain for uint64_t modular field
-
 	template <typename Compute_t>
-	class DotProductDomain<Givaro::Modular<uint64_t,Compute_t>> : public VectorDomainBase<Givaro::Modular<uint64_t,Compute_t> > {
-      public:
-
-		typedef uint64_t Element;
+	class DotProductDomain<Givaro::Modular<uint64_t,Compute_t> > : public DelayedDotProductDomain<Givaro::Modular<uint64_t,Compute_t> > {
+	public:
 		typedef Givaro::Modular<uint64_t,Compute_t> Field;
 
 		DotProductDomain () {}
 		DotProductDomain (const Field &F) :
-			VectorDomainBase<Field > (F)
+			DelayedDotProductDomain<Field> (F)
 		{}
-		using VectorDomainBase<Field >::field;
-		using VectorDomainBase<Field >::faxpy;
-
-      protected:
-		template <class Vector1, class Vector2>
-            inline Element &dotSpecializedDD (Element &res, const Vector1 &v1, const Vector2 &v2) const
-        {
-
-			typename Vector1::const_iterator i;
-			typename Vector2::const_iterator j;
-
-			uint64_t y = 0;
-			uint64_t t;
-
-			for (i = v1.begin (), j = v2.begin (); i < v1.end (); ++i, ++j)
-			{
-				t = ( (uint64_t) *i ) * ( (uint64_t) *j );
-				y += t;
-
-				if (y < t)
-					y += faxpy()._two_64;
-			}
-
-			y %= (uint64_t) field().characteristic();
-			return res = (Element)y;
-
-		}
-
-		template <class Vector1, class Vector2>
-            inline Element &dotSpecializedDSP (Element &res, const Vector1 &v1, const Vector2 &v2) const
-		{
-			typename Vector1::first_type::const_iterator i_idx;
-			typename Vector1::second_type::const_iterator i_elt;
-
-			uint64_t y = 0;
-			uint64_t t;
-
-			for (i_idx = v1.first.begin (), i_elt = v1.second.begin (); i_idx != v1.first.end (); ++i_idx, ++i_elt)
-			{
-				t = ( (uint64_t) *i_elt ) * ( (uint64_t) v2[*i_idx] );
-				y += t;
-
-				if (y < t)
-					y += faxpy()._two_64;
-			}
-
-
-			y %= (uint64_t) field().characteristic();
-
-			return res = (Element) y;
-		}	
-
-        
 	};
 
-        //! Specialization of MVProductDomain for uint64_t modular field
-
 	template <typename Compute_t>
-	class MVProductDomain<Givaro::Modular<uint64_t,Compute_t> > {
-	public:
-
-		typedef uint64_t Element;
-		typedef Givaro::Modular<uint64_t,Compute_t> Field;
-
-	protected:
-		template <class Vector1, class Matrix, class Vector2>
-		inline Vector1 &mulColDense
-		(const VectorDomain<Field > &VD, Vector1 &w, const Matrix &A, const Vector2 &v) const
-            {
-                return mulColDenseSpecialized (VD, w, A, v, typename VectorTraits<typename Matrix::Column>::VectorCategory ());
-            }
-
-	private:
-		template <class Vector1, class Matrix, class Vector2>
-		Vector1 &mulColDenseSpecialized
-		(const VectorDomain<Field > &VD, Vector1 &w, const Matrix &A, const Vector2 &v,
-		 VectorCategories::DenseVectorTag) const;
-		template <class Vector1, class Matrix, class Vector2>
-		Vector1 &mulColDenseSpecialized
-		(const VectorDomain<Field > &VD, Vector1 &w, const Matrix &A, const Vector2 &v,
-		 VectorCategories::SparseSequenceVectorTag) const;
-		template <class Vector1, class Matrix, class Vector2>
-		Vector1 &mulColDenseSpecialized
-		(const VectorDomain<Field > &VD, Vector1 &w, const Matrix &A, const Vector2 &v,
-		 VectorCategories::SparseAssociativeVectorTag) const;
-		template <class Vector1, class Matrix, class Vector2>
-		Vector1 &mulColDenseSpecialized
-		(const VectorDomain<Field > &VD, Vector1 &w, const Matrix &A, const Vector2 &v,
-		 VectorCategories::SparseParallelVectorTag) const;
-
-		mutable std::vector<uint64_t> _tmp;
+	class MVProductDomain<Givaro::Modular<uint64_t,Compute_t> > : public DelayedMVProductDomain<Givaro::Modular<uint64_t,Compute_t> > {
 	};
 
 }
@@ -26,6 +26,7 @@
 #define __LINBOX_charpoly_H
 
 #include "linbox/solutions/methods.h"
+#include "linbox/solutions/method-selector.h"
 #include "linbox/util/debug.h"
 #include "linbox/field/field-traits.h"
 #include "linbox/matrix/dense-matrix.h"
@@ -193,7 +194,7 @@ namespace LinBox
 						  const Method::Auto	       & M)
 	{
 		commentator().start ("Integer Charpoly", "Icharpoly");
-		if (useBlackboxMethod(A))
+		if (useBlackboxMethod(A, M))
 			charpoly(P, A, tag, Method::Blackbox(M) );
 		else
 			charpoly(P, A, tag, Method::DenseElimination(M) );
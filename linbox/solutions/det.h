@@ -33,10 +33,12 @@
 #include "linbox/blackbox/diagonal.h"
 #include "linbox/blackbox/compose.h"
 #include "linbox/solutions/methods.h"
+#include "linbox/solutions/method-selector.h"
 #include "linbox/solutions/getentry.h"
 #include "linbox/vector/blas-vector.h"
 
 #include "linbox/matrix/dense-matrix.h"
+#include "linbox/matrix/sliced3/packed-gf3.h"
 #include "linbox/algorithms/blackbox-container.h"
 #include "linbox/algorithms/blackbox-container-symmetric.h"
 #include "linbox/algorithms/massey-domain.h"
@@ -123,11 +125,21 @@ namespace LinBox
 						const RingCategories::ModularTag	&tag,
 						const Method::Auto			&Meth)
 	{
-		if (useBlackboxMethod(A))
-			return det(d, A, tag, Method::Blackbox(Meth));
-		else
-
+		MethodSelector selector(A, Meth);
+		if (! selector.known() || selector.statistics().dense) {
+			if (useBlackboxMethod(A))
+				return det(d, A, tag, Method::Blackbox(Meth));
 			return det(d, A, tag, Method::Elimination(Meth));
+		}
+
+		switch (selector.choose({MethodChoice::SparseElimination, MethodChoice::DenseElimination, MethodChoice::Wiedemann})) {
+		case MethodChoice::Wiedemann:
+			return det(d, A, tag, Method::Blackbox(Meth));
+		case MethodChoice::DenseElimination:
+			return det(d, A, tag, Method::DenseElimination(Meth));
+		default:
+			return det(d, A, tag, Method::SparseElimination(Meth));
+		}
 	}
 	template<class Blackbox>
 	typename Blackbox::Field::Element &detInPlace (typename Blackbox::Field::Element	&d,
@@ -336,8 +348,14 @@ namespace LinBox
 
 		linbox_check (A.coldim () == A.rowdim ());
 
+		if (Protected::useGF3Packed(F, A.rowdim(), A.coldim())) {
+			// two bits per entry instead of a BlasMatrix
+			Protected::gf3PackedDet(d, A, Meth.parallelPolicy);
+			commentator().stop ("done", NULL, "blasdet");
+			return d;
+		}
 		BlasMatrix<Field> B(A);
-		BlasMatrixDomain<Field> BMD(F);
+		BlasMatrixDomain<Field> BMD(F, Meth.parallelPolicy);
 		d= BMD.detInPlace(B);
 		commentator().stop ("done", NULL, "blasdet");
 
@@ -504,6 +522,11 @@ namespace LinBox
 		commentator().start ("Determinant", "detInPlace");
 		linbox_check (A.coldim () == A.rowdim ());
 
+		if (Protected::useGF3Packed(F, A.rowdim(), A.coldim())) {
+			Protected::gf3PackedDet(d, A, ParallelPolicy());
+			commentator().stop ("done", NULL, "detInPlace");
+			return d;
+		}
 		BlasMatrixDomain<Field> BMD(F);
 		d= BMD.detInPlace(static_cast<BlasMatrix<Field>& > (A));
 		commentator().stop ("done", NULL, "detInPlace");
@@ -528,6 +551,7 @@ namespace LinBox
 #include "linbox/algorithms/cra-builder-single.h"
 #include "linbox/randiter/random-prime.h"
 #include "linbox/algorithms/matrix-hom.h"
+#include "linbox/solutions/hadamard-bound.h"
 
 namespace LinBox
 {
@@ -585,6 +609,10 @@ namespace LinBox
 		}
 #else
 		ChineseRemainder< CRABuilderEarlySingle< Field > > cra(LINBOX_DEFAULT_EARLY_TERMINATION_THRESHOLD);
+		// The bound sizes the rounds of primes, and stops the loop if reached before the early termination.
+		// That of an implicit blackbox would need a dense copy.
+		if (! std::is_same<typename MatrixTraits<Blackbox>::MatrixCategory, MatrixCategories::BlackboxTag>::value)
+			cra.schedule().logBound = HadamardBound(A);
 		cra(dd, iteration, genprime);
 		A.field().init(d, dd); // convert the result from integer to original type
         commentator().stop ("done", NULL, "idet");
@@ -596,7 +624,10 @@ namespace LinBox
 } // end of LinBox namespace
 
 //#if 0
-#ifdef __LINBOX_HAVE_NTL
+#if defined(__LINBOX_USE_OPENMP) && !defined(__LINBOX_HAVE_MPI) && !defined(__LINBOX_HAVE_KAAPI)
+# include "linbox/algorithms/hybrid-det.h"
+# define SOLUTION_CRA_DET concurrent_lif_cra_det
+#elif defined(__LINBOX_HAVE_NTL)
 # include "linbox/algorithms/hybrid-det.h"
 # define SOLUTION_CRA_DET lif_cra_det
 #else
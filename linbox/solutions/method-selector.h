@@ -0,0 +1,508 @@
+/*
+ * Copyright (C) LinBox
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/** @file linbox/solutions/method-selector.h
+ * @ingroup solutions
+ * @brief Cost model used by Method::Auto to choose between elimination, blackbox and lifting methods.
+ *
+ * The estimates use cheap statistics of the matrix (non zero entries per row,
+ * column counts, entry bit size, Hadamard bound) and a few machine constants,
+ * defaults or measured on request, see MachineConstants.
+ * Matrices without an indexed iterator keep the LINBOX_USE_BLACKBOX_THRESHOLD rule.
+ */
+
+#pragma once
+
+#include <linbox/integer.h>
+#include <linbox/field/field-traits.h>
+#include <linbox/solutions/methods.h>
+
+#include <fflas-ffpack/fflas/fflas.h>
+#include <givaro/modular.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace LinBox {
+
+    /**
+     * Machine constants of the cost model.
+     *
+     * instance() holds the defaults below, unless the environment variable
+     * LINBOX_CALIBRATION_FILE names a file: the constants are then read from
+     * it or, when it does not exist, measured by calibrate() (about a tenth
+     * of a second) and written there.
+     * A program can also measure them itself, e.g. use(calibrate()).
+     */
+    struct MachineConstants {
+        double spmvBandwidth = 4.e9; //!< Bytes per second streamed by a CSR matrix-vector product.
+        double fgemmRate = 1.e10;    //!< Modular operations per second of one thread of fgemm.
+        double scalarRate = 2.e8;    //!< Scattered modular axpy per second, as in sparse elimination.
+
+        static const MachineConstants& instance() { return current(); }
+
+        /// Makes C the constants of the following selections, not meant to race with them.
+        static void use(const MachineConstants& C) { current() = C; }
+
+        /// Cache file, empty when the disk should not be used.
+        static std::string cachePath()
+        {
+            const char* path = std::getenv("LINBOX_CALIBRATION_FILE");
+            if (path == nullptr || std::string(path) == "none") return std::string();
+            return std::string(path);
+        }
+
+        bool load(const std::string& path)
+        {
+            std::ifstream in(path);
+            if (!in) return false;
+
+            MachineConstants read(*this);
+            size_t found = 0;
+            std::string key;
+            double value;
+            while (in >> key >> value) {
+                if (!(value > 0)) return false;
+                if (key == "spmv_bandwidth") read.spmvBandwidth = value, found |= 1;
+                else if (key == "fgemm_rate") read.fgemmRate = value, found |= 2;
+                else if (key == "scalar_rate") read.scalarRate = value, found |= 4;
+            }
+            if (found != 7) return false;
+            *this = read;
+            return true;
+        }
+
+        bool save(const std::string& path) const
+        {
+            std::ofstream out(path);
+            out << "spmv_bandwidth " << spmvBandwidth << std::endl
+                << "fgemm_rate " << fgemmRate << std::endl
+                << "scalar_rate " << scalarRate << std::endl;
+            return bool(out);
+        }
+
+        /// Measures the constants on small word size kernels.
+        static MachineConstants calibrate()
+        {
+            typedef Givaro::Modular<double> Field;
+            typedef std::chrono::steady_clock Clock;
+            const double p = 65521;
+            const Field F(p);
+            std::mt19937 gen(42);
+
+            // Runs f until 20ms elapsed, returns the seconds per call.
+            auto timeOf = [](const std::function<void()>& f) {
+                size_t calls = 0;
+                Clock::time_point start = Clock::now();
+                double elapsed;
+                do {
+                    f();
+                    ++calls;
+                    elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+                } while (elapsed < 0.02);
+                return elapsed / calls;
+            };
+
+            MachineConstants C;
+
+            {   // CSR product, 8 entries per row, out of cache
+                const size_t n = 1 << 16, z = 8;
+                std::vector<uint32_t> start(n + 1), colid(n * z);
+                std::vector<double> data(n * z), x(n), y(n);
+                for (size_t i = 0; i <= n; ++i) start[i] = (uint32_t)(i * z);
+                for (size_t k = 0; k < n * z; ++k) {
+                    colid[k] = gen() % n;
+                    data[k] = gen() % (uint32_t)p;
+                }
+                for (auto& xi : x) xi = gen() % (uint32_t)p;
+
+                double t = timeOf([&]() {
+                    for (size_t i = 0; i < n; ++i) {
+                        double s = 0;
+                        for (size_t k = start[i]; k < start[i + 1]; ++k) s += data[k] * x[colid[k]];
+                        y[i] = std::fmod(s, p);
+                    }
+                });
+                double bytes = n * z * (sizeof(double) + sizeof(uint32_t)) + n * (2 * sizeof(double) + sizeof(uint32_t));
+                C.spmvBandwidth = bytes / t;
+            }
+
+            {   // Square fgemm
+                const size_t n = 256;
+                double* A = FFLAS::fflas_new(F, n, n);
+                double* B = FFLAS::fflas_new(F, n, n);
+                double* D = FFLAS::fflas_new(F, n, n);
+                for (size_t k = 0; k < n * n; ++k) {
+                    A[k] = gen() % (uint32_t)p;
+                    B[k] = gen() % (uint32_t)p;
+                }
+
+                double t = timeOf([&]() {
+                    FFLAS::fgemm(F, FFLAS::FflasNoTrans, FFLAS::FflasNoTrans, n, n, n, F.one, A, n, B, n, F.zero, D, n);
+                });
+                C.fgemmRate = 2. * n * n * n / t;
+                FFLAS::fflas_delete(A, B, D);
+            }
+
+            {   // Scattered axpy, as the row updates of GaussDomain
+                const size_t n = 1 << 20;
+                std::vector<uint32_t> idx(n);
+                std::vector<double> x(n), y(n, 0.);
+                for (auto& i : idx) i = gen() % n;
+                for (auto& xi : x) xi = gen() % (uint32_t)p;
+                const double a = 12345;
+
+                double t = timeOf([&]() {
+                    for (size_t k = 0; k < n; ++k) F.axpyin(y[idx[k]], a, x[k]);
+                });
+                C.scalarRate = n / t;
+            }
+
+            return C;
+        }
+
+    protected:
+        static MachineConstants& current()
+        {
+            static MachineConstants constants = initial();
+            return constants;
+        }
+
+        static MachineConstants initial()
+        {
+            MachineConstants C;
+            const std::string path = cachePath();
+            if (path.empty() || C.load(path)) return C;
+
+            C = calibrate();
+            C.save(path);
+            return C;
+        }
+    };
+
+    /**
+     * Statistics of a matrix, as used by the cost model.
+     *
+     * Only computed for matrices providing IndexedBegin()/IndexedEnd(),
+     * that is the sparse formats and BlasMatrix; otherwise known is false.
+     */
+    struct MatrixStatistics {
+        size_t rowdim = 0;
+        size_t coldim = 0;
+        size_t nnz = 0;
+        std::vector<size_t> columnCounts; //!< Non zero entries of each column, increasing.
+        double entryBits = 0;             //!< Bit size of the largest entry, integer rings only.
+        double logHadamard = 0;           //!< log2 of the Hadamard bound on the minors, integer rings only.
+        bool known = false;
+        bool dense = false; //!< Whether the matrix is stored dense.
+
+        double nnzPerRow() const { return rowdim ? double(nnz) / rowdim : 0.; }
+    };
+
+    namespace Protected {
+        template <class Matrix, class = void>
+        struct HasIndexedIterator : std::false_type {
+        };
+
+        template <class Matrix>
+        struct HasIndexedIterator<Matrix, decltype((void)std::declval<const Matrix&>().IndexedBegin(),
+                                                   (void)std::declval<const Matrix&>().IndexedEnd())> : std::true_type {
+        };
+
+        template <class Matrix>
+        struct IsDenseStorage : std::false_type {
+        };
+
+        template <class Field, class Rep>
+        struct IsDenseStorage<BlasMatrix<Field, Rep>> : std::true_type {
+        };
+    }
+
+    template <class Matrix>
+    typename std::enable_if<!Protected::HasIndexedIterator<Matrix>::value, MatrixStatistics>::type matrixStatistics(
+        const Matrix& A)
+    {
+        MatrixStatistics S;
+        S.rowdim = A.rowdim();
+        S.coldim = A.coldim();
+        return S;
+    }
+
+    template <class Matrix>
+    typename std::enable_if<Protected::HasIndexedIterator<Matrix>::value, MatrixStatistics>::type matrixStatistics(
+        const Matrix& A)
+    {
+        typedef typename Matrix::Field Field;
+        const bool integral = std::is_same<typename FieldTraits<Field>::categoryTag, RingCategories::IntegerTag>::value;
+        const Field& F = A.field();
+
+        MatrixStatistics S;
+        S.rowdim = A.rowdim();
+        S.coldim = A.coldim();
+        S.dense = Protected::IsDenseStorage<Matrix>::value;
+        S.known = true;
+
+        std::vector<size_t> counts(S.coldim, 0);
+        std::vector<Integer> rowNormSquared(integral ? S.rowdim : 0);
+        Integer v;
+        for (auto it = A.IndexedBegin(); it != A.IndexedEnd(); ++it) {
+            if (F.isZero(it.value())) continue;
+            ++S.nnz;
+            ++counts[it.colIndex()];
+            if (integral) {
+                F.convert(v, it.value());
+                if (v < 0) v = -v;
+                S.entryBits = std::max(S.entryBits, (double)Givaro::logtwo(v) + 1);
+                Integer::axpyin(rowNormSquared[it.rowIndex()], v, v);
+            }
+        }
+        for (const Integer& n2 : rowNormSquared)
+            if (n2 > 0) S.logHadamard += Givaro::logtwo(n2) / 2.;
+
+        std::sort(counts.begin(), counts.end());
+        S.columnCounts = std::move(counts);
+        return S;
+    }
+
+    /// Methods the selector chooses from.
+    enum class MethodChoice {
+        DenseElimination,
+        SparseElimination,
+        Wiedemann,
+        BlockWiedemann,
+        Dixon,
+        CRA,
+    };
+
+    /**
+     * Estimates, in seconds, the time of each method on one problem.
+     *
+     * Modular estimates are for the field of the matrix, integer ones
+     * (Dixon, CRA) for word size primes. The estimates are meant to be
+     * compared with each other, not to predict the actual times.
+     */
+    class MethodSelector {
+    public:
+        /// @param solving whether a solution vector is built, which costs Wiedemann another n applications.
+        template <class Matrix>
+        MethodSelector(const Matrix& A, const MethodBase& m, bool solving = false,
+                       const MachineConstants& constants = MachineConstants::instance())
+            : MethodSelector(matrixStatistics(A), m, solving, constants)
+        {
+            typedef typename Matrix::Field Field;
+            Integer c, q;
+            A.field().characteristic(c);
+            A.field().cardinality(q);
+            _integral = std::is_same<typename FieldTraits<Field>::categoryTag, RingCategories::IntegerTag>::value;
+            _fgemm = _integral || (c == q && c < BlasBound);
+            _elementBytes = _integral ? sizeof(double) : sizeof(typename Field::Element);
+        }
+
+        MethodSelector(const MatrixStatistics& statistics, const MethodBase& m, bool solving = false,
+                       const MachineConstants& constants = MachineConstants::instance())
+            : _S(statistics)
+            , _m(m)
+            , _C(constants)
+            , _solving(solving)
+        {
+        }
+
+        bool known() const { return _S.known; }
+        const MatrixStatistics& statistics() const { return _S; }
+
+        double cost(MethodChoice c) const
+        {
+            switch (c) {
+            case MethodChoice::DenseElimination: return denseElimination();
+            case MethodChoice::SparseElimination: return sparseElimination();
+            case MethodChoice::Wiedemann: return wiedemann();
+            case MethodChoice::BlockWiedemann: return blockWiedemann();
+            case MethodChoice::Dixon: return dixon();
+            case MethodChoice::CRA: return cra();
+            }
+            return std::numeric_limits<double>::infinity();
+        }
+
+        /// Dense elimination runs FFLAS, which needs a prime field below BlasBound.
+        bool available(MethodChoice c) const { return c != MethodChoice::DenseElimination || _fgemm; }
+
+        /// Cheapest of the available candidates, the first one on ties.
+        MethodChoice choose(std::initializer_list<MethodChoice> candidates) const
+        {
+            MethodChoice best = *candidates.begin();
+            double bestCost = std::numeric_limits<double>::infinity();
+            for (MethodChoice c : candidates) {
+                if (!available(c)) continue;
+                double t = cost(c);
+                if (t < bestCost || !available(best)) best = c, bestCost = t;
+            }
+            return best;
+        }
+
+        // ----- Modular methods
+
+        double denseElimination() const
+        {
+            const double m = (double)_S.rowdim, n = (double)_S.coldim, r = std::min(m, n);
+            const double ops = m * n * r - (m + n) * r * r / 2. + r * r * r / 3.;
+            const double rate = _fgemm ? _C.fgemmRate * _m.parallelPolicy.threads() : _C.scalarRate;
+            return 2. * ops / rate;
+        }
+
+        /**
+         * Mean field simulation of Markowitz pivoting: columns are eliminated
+         * by increasing count, each pivot updates the rows of its column,
+         * and an updated row gets the union of its support and the pivot row.
+         */
+        double sparseElimination() const
+        {
+            const double m = (double)_S.rowdim, n = (double)_S.coldim;
+            const size_t r = (size_t)std::min(m, n);
+            const double rho0 = std::max(_S.nnzPerRow(), 1.);
+            const double ceiling = 4. * denseElimination() * _C.scalarRate; // no need to go further
+            double rho = rho0, ops = 0.;
+
+            for (size_t k = 0; k < r && ops < ceiling; ++k) {
+                const double rows = m - k, cols = n - k;
+                if (rows <= 1. || cols <= 1.) break;
+                // The column counts grow as the rows did.
+                const double column = std::min(rows, (double)_S.columnCounts[std::min(k, _S.columnCounts.size() - 1)] * rho / rho0);
+                const double updated = std::max(column - 1., 0.);
+                ops += updated * rho;
+
+                // Both rows lose the pivot column, and share (rho-1)^2/cols others on average.
+                const double merged = std::min(2. * rho - 2. - (rho - 1.) * (rho - 1.) / cols, cols - 1.);
+                rho = std::max((rho * (rows - 1. - updated) + merged * updated) / (rows - 1.), 1.);
+            }
+            return ops / _C.scalarRate;
+        }
+
+        /// 2n applications for the minimal polynomial, n more to build a solution.
+        double wiedemann() const
+        {
+            const double n = (double)std::min(_S.rowdim, _S.coldim);
+            const double applies = (_solving ? 3. : 2.) * n;
+            return applies * apply() + 2. * n * n * _elementBytes / _C.spmvBandwidth;
+        }
+
+        /// Block of s vectors, the applications of a block run in parallel, never better on one thread.
+        double blockWiedemann() const
+        {
+            const double n = (double)std::min(_S.rowdim, _S.coldim);
+            const double s = (double)std::max<size_t>(_m.blockingFactor, 1);
+            const double threads = std::min<double>(_m.parallelPolicy.threads(), s);
+            if (threads <= 1.) return std::numeric_limits<double>::infinity();
+
+            const double applies = (_solving ? 3. : 2.) * n;
+            const double generator = s * n * n / (_C.fgemmRate * _m.parallelPolicy.threads());
+            return applies * apply() / threads + generator;
+        }
+
+        // ----- Integer methods
+
+        /// p-adic digits, or primes, for a solution: twice the Hadamard bound over word size primes.
+        double liftingSteps() const
+        {
+            const double primeBits = 23.; // FieldTraits<Givaro::Modular<double>>::bestBitSize
+            return 2. * (_S.logHadamard + _S.entryBits) / primeBits + 1.;
+        }
+
+        /// One factorization, then per digit a solve with the factors, an application and the residue update.
+        double dixon() const
+        {
+            const double n = (double)_S.coldim;
+            const double residue = n * std::max(_S.entryBits / 64., 1.) * (_S.logHadamard / 64. + 1.) / _C.scalarRate;
+            return factorization() + liftingSteps() * (triangularSolve() + apply() + residue);
+        }
+
+        /// One modular solve per prime, the primes dispatched over the threads.
+        double cra() const
+        {
+            const double threads = (_m.dispatch == Dispatch::Sequential) ? 1. : (double)_m.parallelPolicy.threads();
+            return liftingSteps() * (factorization() + triangularSolve()) / threads;
+        }
+
+    protected:
+        double factorization() const
+        {
+            return _S.dense ? denseElimination() : std::min(denseElimination(), sparseElimination());
+        }
+
+        /// Solve with the factors, bounded by streaming a dense n x n triangle twice.
+        double triangularSolve() const
+        {
+            const double n = (double)_S.coldim;
+            return n * n * _elementBytes / _C.spmvBandwidth;
+        }
+
+        /// One matrix-vector product, streaming the matrix and both vectors.
+        double apply() const
+        {
+            const double bytes = _S.nnz * (_elementBytes + sizeof(uint32_t)) + (_S.rowdim + _S.coldim) * _elementBytes;
+            return bytes / _C.spmvBandwidth;
+        }
+
+        MatrixStatistics _S;
+        MethodBase _m;
+        MachineConstants _C;
+        bool _solving;
+        bool _integral = false;
+        bool _fgemm = true;
+        double _elementBytes = sizeof(double);
+    };
+
+    /// Used by Method::Auto to decide between Method::Blackbox and Method::Elimination.
+    template <class Matrix>
+    bool useBlackboxMethod(const Matrix& A, const MethodBase& m)
+    {
+        MethodSelector selector(A, m);
+        if (!selector.known()) return useBlackboxMethod(A);
+        if (selector.statistics().dense) return false;
+        return selector.choose({MethodChoice::DenseElimination, MethodChoice::SparseElimination, MethodChoice::Wiedemann})
+               == MethodChoice::Wiedemann;
+    }
+
+    template <class Field>
+    bool useBlackboxMethod(const LinBox::DenseMatrix<Field>&, const MethodBase&)
+    {
+        return false;
+    }
+}
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
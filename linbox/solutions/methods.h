@@ -26,6 +26,7 @@
 #include <linbox/matrix/dense-matrix.h> // Only for useBlackboxMethod
 #include <linbox/solutions/constants.h>
 #include <linbox/util/mpicpp.h>
+#include <linbox/util/parallel-policy.h>
 #include <string>
 
 /**
@@ -198,6 +199,7 @@ namespace LinBox {
         MethodBase(Communicator* _pCommunicator) : pCommunicator(_pCommunicator) {}
         MethodBase(PivotStrategy _pivotStrategy) : pivotStrategy(_pivotStrategy) {}
         MethodBase(SingularSolutionType _singularSolutionType) : singularSolutionType(_singularSolutionType) {}
+        MethodBase(const ParallelPolicy& _parallelPolicy) : parallelPolicy(_parallelPolicy) {}
 
         // ----- Generic system information.
         Singularity singularity = Singularity::Unknown;
@@ -215,6 +217,7 @@ namespace LinBox {
 
         // ----- For Elimination-based methods.
         PivotStrategy pivotStrategy = PivotStrategy::Linear;
+        ParallelPolicy parallelPolicy; //!< Threads of the dense kernels (BlasMatrixDomain).
 
         // ----- For Dixon method.
         // @fixme SingularSolutionType::Deterministic fails with Dense Dixon
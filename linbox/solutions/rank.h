@@ -44,11 +44,13 @@
 #include "linbox/matrix/matrix-domain.h"
 #include "linbox/algorithms/whisart_trace.h"
 #include "linbox/matrix/dense-matrix.h"
+#include "linbox/matrix/sliced3/packed-gf3.h"
 #include "linbox/matrix/matrixdomain/blas-matrix-domain.h"
 
 #include "linbox/vector/vector-traits.h"
 #include "linbox/solutions/trace.h"
 #include "linbox/solutions/methods.h"
+#include "linbox/solutions/method-selector.h"
 
 
 #include "linbox/util/debug.h"
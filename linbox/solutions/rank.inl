@@ -47,12 +47,20 @@ namespace LinBox
 				    const Method::Auto             &m)
 	{
 		// we need a BB/Blas hybrid in the style of Duran/Saunders/Wan.
-		//! @bug choose (benchmark) better cuttoff (size, nbnz, sparse rep)
-		if (useBlackboxMethod(A)) {
-			return rank(r, A, tag, Method::Blackbox(m ));
+		MethodSelector selector(A, m);
+		if (! selector.known() || selector.statistics().dense) {
+			if (useBlackboxMethod(A))
+				return rank(r, A, tag, Method::Blackbox(m));
+			return rank(r, A, tag, Method::Elimination(m));
 		}
-		else {
-			return rank(r, A, tag, Method::Elimination( m ));
+
+		switch (selector.choose({MethodChoice::SparseElimination, MethodChoice::DenseElimination, MethodChoice::Wiedemann})) {
+		case MethodChoice::Wiedemann:
+			return rank(r, A, tag, Method::Blackbox(m));
+		case MethodChoice::DenseElimination:
+			return rank(r, A, tag, Method::DenseElimination(m));
+		default:
+			return rank(r, A, tag, Method::SparseElimination(m));
 		}
 	}
 
@@ -422,8 +430,14 @@ namespace LinBox
 		integer a, b; F.characteristic(a); F.cardinality(b);
 		linbox_check( a == b );
 		linbox_check( a < LinBox::BlasBound);
+		if (Protected::useGF3Packed(F, A.rowdim(), A.coldim())) {
+			// two bits per entry instead of a BlasMatrix
+			r = Protected::gf3PackedRank(A, M.parallelPolicy);
+			commentator().stop ("done", NULL, "blasrank");
+			return r;
+		}
 		BlasMatrix<Field> B(A);
-		BlasMatrixDomain<Field> D(F);
+		BlasMatrixDomain<Field> D(F, M.parallelPolicy);
 		r = D.rankInPlace(B);
 		commentator().stop ("done", NULL, "blasrank");
 		return r;
@@ -616,7 +630,12 @@ namespace LinBox { /*  rankInPlace */
 
 		commentator().start ("BlasBB Rank", "blasbbrank");
 		const Field F = A.field();
-		BlasMatrixDomain<Field> D(F);
+		if (Protected::useGF3Packed(F, A.rowdim(), A.coldim())) {
+			r = Protected::gf3PackedRank(A, M.parallelPolicy);
+			commentator().stop ("done", NULL, "blasbbrank");
+			return r;
+		}
+		BlasMatrixDomain<Field> D(F, M.parallelPolicy);
 		r = D.rankInPlace(static_cast< BlasMatrix<Field>& >(A));
 		commentator().stop ("done", NULL, "blasbbrank");
 		return r;
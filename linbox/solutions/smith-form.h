@@ -211,7 +211,7 @@ namespace LinBox
 	{
 		Givaro::ZRing<Integer> Z;
 		BlasVector<Givaro::ZRing<Integer> > v (Z,A.rowdim() < A.coldim() ? A.rowdim() : A.coldim());
-		SmithFormAdaptive::smithForm(v, A);
+		SmithFormAdaptive::smithForm(v, A, M.parallelPolicy);
 		//distinct(v.begin(), v.end(), S);
 		return compressedSmith(S,v);
 	}
@@ -222,7 +222,7 @@ namespace LinBox
 		  const Method::Auto			& M)
 	{
 		Givaro::ZRing<Integer> Z;
-		SmithFormAdaptive::smithForm(V, A);
+		SmithFormAdaptive::smithForm(V, A, M.parallelPolicy);
 		return V;
 	}
 
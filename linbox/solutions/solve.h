@@ -52,7 +52,9 @@ namespace LinBox {
      *
      * - Method::Auto
      *      - DenseMatrix   > Method::DenseElimination
-     *      - SparseMatrix  > Method::SparseElimination
+     *      - SparseMatrix  > cheapest of Method::SparseElimination, Method::DenseElimination, Method::Wiedemann
+     *      |                 (and Method::BlockWiedemann if known non singular), see MethodSelector
+     *      - IntegerTag    > Method::Dixon, or Method::CRA if known non singular and estimated cheaper
      *      - Otherwise
      *      |   - Row or column dimension < LINBOX_USE_BLACKBOX_THRESHOLD > Method::Elimination
      *      |   - Otherwise                                               > Method::Blackbox
@@ -110,6 +112,9 @@ namespace LinBox {
      *      - IntegerTag > `DixonSolver<..., Method::SymbolicNumericNorm>`
      *      - Otherwise  > Error
      *
+     * Many independent small systems are better solved in one `solveBatch` call
+     * (see solve/solve-batch.h), which shares the setup between them.
+     *
      * @param [out] x solution, can be a rational solution (vector of numerators and one denominator)
      * @param [in]  A matrix
      * @param [in]  b target
@@ -339,6 +344,9 @@ namespace LinBox {
 #include "./solve/solve-dixon.h"
 #include "./solve/solve-numeric-symbolic.h"
 
+// Batches of small systems
+#include "./solve/solve-batch.h"
+
 // Blackbox
 #include "./solve/solve-blackbox.h"
 #include "./solve/solve-lanczos.h"
@@ -25,6 +25,7 @@
 #include <linbox/matrix/dense-matrix.h>
 #include <linbox/matrix/sparse-matrix.h>
 #include <linbox/solutions/methods.h>
+#include <linbox/solutions/method-selector.h>
 
 namespace LinBox {
     //
@@ -37,7 +38,7 @@ namespace LinBox {
     template <class ResultVector, class Matrix, class Vector, class CategoryTag>
     ResultVector& solve(ResultVector& x, const Matrix& A, const Vector& b, const CategoryTag& tag, const Method::Auto& m)
     {
-        if (useBlackboxMethod(A)) {
+        if (useBlackboxMethod(A, m)) {
             return solve(x, A, b, tag, reinterpret_cast<const Method::Blackbox&>(m));
         }
         else {
@@ -57,21 +58,48 @@ namespace LinBox {
 
     /**
      * \brief Solve specialisation for Auto with SparseMatrix and ModularTag.
+     *
+     * The cost model chooses between sparse elimination, dense elimination and Wiedemann,
+     * and block Wiedemann when the system is known to be non singular and threads are available.
      */
     template <class ResultVector, class... MatrixArgs, class Vector>
     ResultVector& solve(ResultVector& x, const SparseMatrix<MatrixArgs...>& A, const Vector& b,
                         const RingCategories::ModularTag& tag, const Method::Auto& m)
     {
-        return solve(x, A, b, tag, reinterpret_cast<const Method::SparseElimination&>(m));
+        MethodSelector selector(A, m, true);
+        MethodChoice choice = (m.singularity == Singularity::NonSingular)
+                                  ? selector.choose({MethodChoice::SparseElimination, MethodChoice::DenseElimination,
+                                                     MethodChoice::Wiedemann, MethodChoice::BlockWiedemann})
+                                  : selector.choose({MethodChoice::SparseElimination, MethodChoice::DenseElimination,
+                                                     MethodChoice::Wiedemann});
+
+        switch (choice) {
+        case MethodChoice::DenseElimination:
+            return solve(x, A, b, tag, reinterpret_cast<const Method::DenseElimination&>(m));
+        case MethodChoice::Wiedemann:
+            return solve(x, A, b, tag, reinterpret_cast<const Method::Wiedemann&>(m));
+        case MethodChoice::BlockWiedemann:
+            return solve(x, A, b, tag, reinterpret_cast<const Method::BlockWiedemann&>(m));
+        default:
+            return solve(x, A, b, tag, reinterpret_cast<const Method::SparseElimination&>(m));
+        }
     }
 
     /**
      * \brief Solve specialisation for Auto and IntegerTag.
+     *
+     * Dixon lifting, unless the system is known non singular and the primes of a CRA
+     * spread over the threads are estimated cheaper.
      */
     template <class ResultVector, class Matrix, class Vector>
     ResultVector& solve(ResultVector& x, const Matrix& A, const Vector& b, const RingCategories::IntegerTag& tag,
                         const Method::Auto& m)
     {
+        MethodSelector selector(A, m, true);
+        if (m.singularity == Singularity::NonSingular && selector.known()
+            && selector.choose({MethodChoice::Dixon, MethodChoice::CRA}) == MethodChoice::CRA) {
+            return solve(x, A, b, tag, Method::CRAAuto(m));
+        }
         return solve(x, A, b, tag, reinterpret_cast<const Method::Dixon&>(m));
     }
 
@@ -96,6 +124,12 @@ namespace LinBox {
     inline void solve(IntVector& xNum, typename IntVector::Element& xDen, const Matrix& A, const Vector& b,
                       const RingCategories::IntegerTag& tag, const Method::Auto& m)
     {
+        MethodSelector selector(A, m, true);
+        if (m.singularity == Singularity::NonSingular && selector.known()
+            && selector.choose({MethodChoice::Dixon, MethodChoice::CRA}) == MethodChoice::CRA) {
+            solve(xNum, xDen, A, b, tag, Method::CRAAuto(m));
+            return;
+        }
         solve(xNum, xDen, A, b, tag, reinterpret_cast<const Method::Dixon&>(m));
     }
 
@@ -109,7 +143,7 @@ namespace LinBox {
     template <class ResultVector, class Matrix, class Vector, class CategoryTag>
     ResultVector& solveInPlace(ResultVector& x, Matrix& A, const Vector& b, const CategoryTag& tag, const Method::Auto& m)
     {
-        if (useBlackboxMethod(A)) {
+        if (useBlackboxMethod(A, m)) {
             return solve(x, A, b, tag, reinterpret_cast<const Method::Blackbox&>(m));
         }
         else {
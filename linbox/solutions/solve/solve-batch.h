@@ -0,0 +1,402 @@
+/*
+ * Copyright(C) LinBox
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+#pragma once
+
+#include <fflas-ffpack/ffpack/ffpack.h>
+#include <linbox/algorithms/rational-solver.h>
+#include <linbox/matrix/dense-matrix.h>
+#include <linbox/solutions/methods.h>
+#include <linbox/vector/blas-vector.h>
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#ifdef __LINBOX_USE_OPENMP
+#include <omp.h>
+#endif
+
+namespace LinBox {
+    /**
+     * \brief Outcome of one system of a batch.
+     */
+    enum class BatchSolveStatus : uint8_t {
+        Ok,       //!< the solution is written
+        Singular, //!< the matrix is singular (modulo all the primes tried, over Z)
+        Failed,   //!< the solver threw or ran out of primes
+    };
+
+    /**
+     * \brief Storage of a batch of square systems in contiguous arrays.
+     *
+     * System k has its n x n row-major matrix at `A + k * strideA` with
+     * row stride lda, its right-hand side at `b + k * strideB` and its
+     * solution at `x + k * strideX`.  The defaults pack everything.
+     */
+    struct BatchLayout {
+        size_t count;
+        size_t n;
+        size_t lda;
+        size_t strideA;
+        size_t strideB;
+        size_t strideX;
+
+        BatchLayout(size_t systems, size_t dim)
+            : count(systems)
+            , n(dim)
+            , lda(dim)
+            , strideA(dim * dim)
+            , strideB(dim)
+            , strideX(dim)
+        {
+        }
+    };
+
+    namespace Protected {
+        /// Up to this size, systems go through the unrolled kernels.
+        static const size_t BatchTinySize = 8;
+
+        /*
+         * Runs body(workspace, k) for each system k, with one workspace per
+         * thread built by make().  A throwing system is reported as failed.
+         */
+        template <class MakeWorkspace, class Body>
+        void batchFor(std::vector<BatchSolveStatus>& status, const ParallelPolicy& policy, size_t chunk,
+                      const MakeWorkspace& make, const Body& body)
+        {
+            const size_t count = status.size();
+#ifdef __LINBOX_USE_OPENMP
+            const int threads = (int)std::max<size_t>(std::min(policy.threads(), count / chunk), 1);
+#pragma omp parallel num_threads(threads) if (threads > 1)
+            {
+                auto workspace = make();
+#pragma omp for schedule(dynamic, chunk)
+                for (long k = 0; k < (long)count; ++k) {
+                    try {
+                        status[k] = body(workspace, (size_t)k);
+                    } catch (...) {
+                        status[k] = BatchSolveStatus::Failed;
+                    }
+                }
+            }
+#else
+            auto workspace = make();
+            for (size_t k = 0; k < count; ++k) {
+                try {
+                    status[k] = body(workspace, k);
+                } catch (...) {
+                    status[k] = BatchSolveStatus::Failed;
+                }
+            }
+#endif
+        }
+
+        /*
+         * Gaussian elimination with the size known at compile time:
+         * the loops unroll and the system stays on the stack.
+         */
+        template <size_t N, class Field>
+        bool solveTiny(const Field& F, typename Field::Element* x, const typename Field::Element* A, size_t lda,
+                       const typename Field::Element* b)
+        {
+            using Element = typename Field::Element;
+            Element a[N][N], y[N], inv[N], f;
+
+            for (size_t i = 0; i < N; ++i) {
+                for (size_t j = 0; j < N; ++j) F.assign(a[i][j], A[i * lda + j]);
+                F.assign(y[i], b[i]);
+            }
+
+            for (size_t k = 0; k < N; ++k) {
+                size_t p = k;
+                while (p < N && F.isZero(a[p][k])) ++p;
+                if (p == N) return false;
+                if (p != k) {
+                    for (size_t j = k; j < N; ++j) std::swap(a[p][j], a[k][j]);
+                    std::swap(y[p], y[k]);
+                }
+
+                F.inv(inv[k], a[k][k]);
+                for (size_t i = k + 1; i < N; ++i) {
+                    if (F.isZero(a[i][k])) continue;
+                    F.mul(f, a[i][k], inv[k]);
+                    for (size_t j = k + 1; j < N; ++j) F.maxpyin(a[i][j], f, a[k][j]);
+                    F.maxpyin(y[i], f, y[k]);
+                }
+            }
+
+            for (size_t i = N; i-- > 0;) {
+                for (size_t j = i + 1; j < N; ++j) F.maxpyin(y[i], a[i][j], x[j]);
+                F.mul(x[i], y[i], inv[i]);
+            }
+            return true;
+        }
+
+        template <class Field>
+        bool solveTiny(const Field& F, size_t n, typename Field::Element* x, const typename Field::Element* A,
+                       size_t lda, const typename Field::Element* b)
+        {
+            switch (n) {
+            case 1: return solveTiny<1>(F, x, A, lda, b);
+            case 2: return solveTiny<2>(F, x, A, lda, b);
+            case 3: return solveTiny<3>(F, x, A, lda, b);
+            case 4: return solveTiny<4>(F, x, A, lda, b);
+            case 5: return solveTiny<5>(F, x, A, lda, b);
+            case 6: return solveTiny<6>(F, x, A, lda, b);
+            case 7: return solveTiny<7>(F, x, A, lda, b);
+            case 8: return solveTiny<8>(F, x, A, lda, b);
+            }
+            throw LinBoxError("solveTiny: size above BatchTinySize.");
+        }
+
+        // PLUQ factorization space, reused by all the systems of a thread.
+        template <class Field>
+        struct BatchEliminationWorkspace {
+            std::vector<typename Field::Element> LU;
+            std::vector<size_t> P, Q;
+
+            explicit BatchEliminationWorkspace(size_t n)
+                : LU(n * n)
+                , P(n)
+                , Q(n)
+            {
+            }
+        };
+
+        // Dixon solver and the ring copies of one system, reused by all the systems of a thread.
+        template <class Ring>
+        struct BatchDixonWorkspace {
+            using Field = Givaro::Modular<double>;
+            using PrimeGenerator = PrimeIterator<IteratorCategories::HeuristicTag>;
+            using Solver = DixonSolver<Ring, Field, PrimeGenerator, Method::DenseElimination>;
+
+            Solver solver;
+            DenseMatrix<Ring> A;
+            BlasVector<Ring> b, x;
+
+            BatchDixonWorkspace(const Ring& R, size_t n)
+                : solver(R, PrimeGenerator(FieldTraits<Field>::bestBitSize(n)))
+                , A(R, n, n)
+                , b(R, n)
+                , x(R, n)
+            {
+            }
+        };
+    }
+
+    /**
+     * \brief Solve a batch of independent nonsingular systems over a finite field.
+     *
+     * Each system is solved on its own, the batch only shares the setup:
+     * systems of size at most 8 go through elimination kernels unrolled
+     * for their size, the larger ones through FFPACK::PLUQ in a workspace
+     * allocated once per thread.  The systems are distributed over the
+     * threads of `m.parallelPolicy` (OpenMP), whatever their size.
+     *
+     * No exception is thrown for a singular system: its status says so
+     * and its solution is left untouched.
+     *
+     * @param [in]  F  field of the entries
+     * @param [out] x  solutions, see BatchLayout
+     * @param [in]  A  matrices, see BatchLayout
+     * @param [in]  b  right-hand sides, see BatchLayout
+     * @param [in]  L  layout of the batch
+     * @param [in]  m  method, only its parallel policy is used
+     * @return the status of each system
+     */
+    template <class Field>
+    std::vector<BatchSolveStatus> solveBatch(const Field& F, typename Field::Element* x, const typename Field::Element* A,
+                                             const typename Field::Element* b, const BatchLayout& L,
+                                             const Method::DenseElimination& m = Method::DenseElimination())
+    {
+        using Element = typename Field::Element;
+        std::vector<BatchSolveStatus> status(L.count, BatchSolveStatus::Failed);
+        const size_t n = L.n;
+        if (n == 0) {
+            std::fill(status.begin(), status.end(), BatchSolveStatus::Ok);
+            return status;
+        }
+
+        if (n <= Protected::BatchTinySize) {
+            Protected::batchFor(status, m.parallelPolicy, 64, [] { return 0; }, [&](int, size_t k) {
+                return Protected::solveTiny(F, n, x + k * L.strideX, A + k * L.strideA, L.lda, b + k * L.strideB)
+                           ? BatchSolveStatus::Ok
+                           : BatchSolveStatus::Singular;
+            });
+            return status;
+        }
+
+        using Workspace = Protected::BatchEliminationWorkspace<Field>;
+        Protected::batchFor(status, m.parallelPolicy, 1, [n] { return Workspace(n); }, [&](Workspace& W, size_t k) {
+            Element* LU = W.LU.data();
+            FFLAS::fassign(F, n, n, A + k * L.strideA, L.lda, LU, n);
+            size_t r = FFPACK::PLUQ(F, FFLAS::FflasNonUnit, n, n, LU, n, W.P.data(), W.Q.data());
+            if (r < n) return BatchSolveStatus::Singular;
+
+            int info = 0;
+            Element* xk = x + k * L.strideX;
+            FFLAS::fassign(F, n, b + k * L.strideB, 1, xk, 1);
+            FFPACK::fgetrs(F, FFLAS::FflasLeft, n, 1, r, LU, n, W.P.data(), W.Q.data(), xk, 1, &info);
+            return (info > 0) ? BatchSolveStatus::Failed : BatchSolveStatus::Ok;
+        });
+        return status;
+    }
+
+    /**
+     * \brief Solve a batch of independent nonsingular integer systems by Dixon lifting.
+     *
+     * System k gets the rational solution `xNum_k / xDen[k]`.  Each thread
+     * of `m.parallelPolicy` builds one DixonSolver and one copy of a system,
+     * and goes through its share of the batch with them.  Singular systems
+     * are reported, not solved: see `solve` for their solutions.
+     *
+     * @param [in]  R     ring of the entries
+     * @param [out] xNum  numerators of the solutions, see BatchLayout
+     * @param [out] xDen  denominators of the solutions, one per system
+     * @param [in]  A     matrices, see BatchLayout
+     * @param [in]  b     right-hand sides, see BatchLayout
+     * @param [in]  L     layout of the batch
+     * @param [in]  m     method, for its parallel policy and trialsBeforeFailure
+     * @return the status of each system
+     */
+    template <class Ring>
+    std::vector<BatchSolveStatus> solveBatch(const Ring& R, typename Ring::Element* xNum, typename Ring::Element* xDen,
+                                             const typename Ring::Element* A, const typename Ring::Element* b,
+                                             const BatchLayout& L, const Method::Dixon& m = Method::Dixon())
+    {
+        std::vector<BatchSolveStatus> status(L.count, BatchSolveStatus::Failed);
+        const size_t n = L.n;
+        const int maxTrials = (int)m.trialsBeforeFailure;
+
+        using Workspace = Protected::BatchDixonWorkspace<Ring>;
+        Protected::batchFor(status, m.parallelPolicy, 1, [&R, n] { return Workspace(R, n); }, [&](Workspace& W, size_t k) {
+            const auto* Ak = A + k * L.strideA;
+            const auto* bk = b + k * L.strideB;
+            for (size_t i = 0; i < n; ++i) {
+                for (size_t j = 0; j < n; ++j) W.A.setEntry(i, j, Ak[i * L.lda + j]);
+                W.b[i] = bk[i];
+            }
+
+            SolverReturnStatus s = W.solver.solveNonsingular(W.x, xDen[k], W.A, W.b, false, maxTrials);
+            if (s == SS_SINGULAR) return BatchSolveStatus::Singular;
+            if (s != SS_OK) return BatchSolveStatus::Failed;
+
+            std::copy(W.x.begin(), W.x.end(), xNum + k * L.strideX);
+            return BatchSolveStatus::Ok;
+        });
+        return status;
+    }
+
+    namespace Protected {
+        /*
+         * Groups the systems by size, packs each group into a contiguous
+         * batch, and unpacks the solutions after solve(layout, A, b, x) ran.
+         */
+        template <class Field, class SolveGroup>
+        std::vector<BatchSolveStatus> solveBatchBySize(std::vector<BlasVector<Field>>& x,
+                                                       const std::vector<DenseMatrix<Field>>& A,
+                                                       const std::vector<BlasVector<Field>>& b, const SolveGroup& solve)
+        {
+            using Element = typename Field::Element;
+            linbox_check(A.size() == b.size());
+
+            std::map<size_t, std::vector<size_t>> groups;
+            for (size_t k = 0; k < A.size(); ++k) {
+                linbox_check(A[k].rowdim() == A[k].coldim() && A[k].rowdim() == b[k].size());
+                groups[A[k].rowdim()].push_back(k);
+            }
+
+            std::vector<BatchSolveStatus> status(A.size(), BatchSolveStatus::Failed);
+            x.resize(A.size(), BlasVector<Field>(A.empty() ? Field() : A[0].field()));
+            for (const auto& group : groups) {
+                const std::vector<size_t>& members = group.second;
+                const BatchLayout L(members.size(), group.first);
+                const size_t n = L.n;
+
+                std::vector<Element> PA(L.count * L.strideA), Pb(L.count * L.strideB), Px(L.count * L.strideX);
+                for (size_t g = 0; g < L.count; ++g) {
+                    const DenseMatrix<Field>& Ak = A[members[g]];
+                    for (size_t i = 0; i < n; ++i)
+                        std::copy(Ak.getPointer() + i * Ak.getStride(), Ak.getPointer() + i * Ak.getStride() + n,
+                                  PA.begin() + g * L.strideA + i * n);
+                    std::copy(b[members[g]].begin(), b[members[g]].end(), Pb.begin() + g * L.strideB);
+                }
+
+                std::vector<BatchSolveStatus> groupStatus = solve(L, PA.data(), Pb.data(), Px.data(), members);
+
+                for (size_t g = 0; g < L.count; ++g) {
+                    const size_t k = members[g];
+                    status[k] = groupStatus[g];
+                    x[k].resize(n);
+                    if (status[k] == BatchSolveStatus::Ok)
+                        std::copy(Px.begin() + g * L.strideX, Px.begin() + (g + 1) * L.strideX, x[k].begin());
+                }
+            }
+            return status;
+        }
+    }
+
+    /**
+     * \brief Solve a batch of independent nonsingular systems of any sizes over a finite field.
+     *
+     * The systems are grouped by size and each group goes through the
+     * contiguous `solveBatch` above.
+     */
+    template <class Field>
+    std::vector<BatchSolveStatus> solveBatch(std::vector<BlasVector<Field>>& x, const std::vector<DenseMatrix<Field>>& A,
+                                             const std::vector<BlasVector<Field>>& b,
+                                             const Method::DenseElimination& m = Method::DenseElimination())
+    {
+        using Element = typename Field::Element;
+        if (A.empty()) return {};
+        const Field& F = A[0].field();
+
+        return Protected::solveBatchBySize(x, A, b, [&](const BatchLayout& L, const Element* PA, const Element* Pb, Element* Px,
+                                                        const std::vector<size_t>&) { return solveBatch(F, Px, PA, Pb, L, m); });
+    }
+
+    /**
+     * \brief Solve a batch of independent nonsingular integer systems of any sizes by Dixon lifting.
+     *
+     * The systems are grouped by size and each group goes through the
+     * contiguous `solveBatch` above.
+     */
+    template <class Ring>
+    std::vector<BatchSolveStatus> solveBatch(std::vector<BlasVector<Ring>>& xNum, std::vector<typename Ring::Element>& xDen,
+                                             const std::vector<DenseMatrix<Ring>>& A, const std::vector<BlasVector<Ring>>& b,
+                                             const Method::Dixon& m = Method::Dixon())
+    {
+        using Element = typename Ring::Element;
+        xDen.resize(A.size());
+        if (A.empty()) return {};
+        const Ring& R = A[0].field();
+
+        return Protected::solveBatchBySize(xNum, A, b, [&](const BatchLayout& L, const Element* PA, const Element* Pb,
+                                                           Element* Px, const std::vector<size_t>& members) {
+            std::vector<Element> den(L.count);
+            std::vector<BatchSolveStatus> status = solveBatch(R, Px, den.data(), PA, Pb, L, m);
+            for (size_t g = 0; g < L.count; ++g) xDen[members[g]] = den[g];
+            return status;
+        });
+    }
+}
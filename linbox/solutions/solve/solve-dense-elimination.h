@@ -22,7 +22,10 @@
 
 #pragma once
 
+#include <algorithm>
+
 #include <linbox/matrix/dense-matrix.h>
+#include <linbox/matrix/matrixdomain/blas-matrix-domain.h>
 #include <linbox/matrix/sparse-matrix.h>
 #include <linbox/solutions/methods.h>
 
@@ -55,6 +58,19 @@ namespace LinBox {
 
         commentator().start("solve.dense-elimination.modular.dense");
 
+        // Square and large enough for the method's parallel policy: parallel PLUQ,
+        // the singular case falls back to the sequential consistency checking solve.
+        if ((A.rowdim() == A.coldim()) && m.parallelPolicy.worthIt(A.rowdim(), A.coldim())) {
+            DenseMatrix<Field> LU(A);
+            BlasVector<Field> y(A.field(), b);
+            if (BlasMatrixDomainParallel<Field>::solve(A.field(), A.rowdim(), LU.getPointer(), LU.getStride(),
+                                                       y.getPointer(), m.parallelPolicy)) {
+                std::copy(y.begin(), y.end(), x.begin());
+                commentator().stop("solve.dense-elimination.modular.dense");
+                return x;
+            }
+        }
+
         PLUQMatrix<Field> PLUQ(A);
         PLUQ.left_solve(x, b);
 
@@ -0,0 +1,160 @@
+/* linbox/util/checkpoint.h
+ * Copyright (C) LinBox
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/** @file linbox/util/checkpoint.h
+ * @ingroup util
+ * @brief Periodic binary checkpoints of long computations.
+ */
+
+#ifndef __LINBOX_util_checkpoint_H
+#define __LINBOX_util_checkpoint_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "linbox/util/error.h"
+#include "linbox/util/serialization.h"
+
+namespace LinBox
+{
+
+	/** \brief A checkpoint file and the policy deciding when to write it.
+	 *
+	 * save() serializes its arguments (anything with a LinBox::serialize
+	 * overload: CRA builders, prime iterators, BlackboxBlockContainer,
+	 * vectors of blocks, ...) and writes them atomically, through a
+	 * temporary file renamed over the previous checkpoint.  restore()
+	 * reads them back in the same order, if the file exists.
+	 *
+	 * File format is (by bytes count):
+	 *  0-3   magic  "LBCK"
+	 *  4-7   version
+	 *  8-15  l      Length of the payload
+	 *  16-..        Payload, the serialized arguments of save()
+	 */
+	class Checkpoint {
+	public:
+		typedef std::chrono::steady_clock Clock;
+
+		/**
+		 * @param path     checkpoint file
+		 * @param seconds  minimal time between two saves
+		 * @param stride   iterations run between two looks at the clock
+		 */
+		Checkpoint (const std::string& path, double seconds = 600., int stride = 16) :
+			_path(path), _seconds(seconds), _stride(stride > 0 ? stride : 1), _last(Clock::now())
+		{}
+
+		const std::string& path () const { return _path; }
+		int stride () const { return _stride; }
+
+		/// Whether enough time went by since the last save
+		bool due () const
+		{
+			return std::chrono::duration<double>(Clock::now() - _last).count() >= _seconds;
+		}
+
+		/// Writes the serialized values, replacing the previous checkpoint
+		template <class... T>
+		void save (const T&... values)
+		{
+			std::vector<uint8_t> payload;
+			int expand[] = { 0, ((void)serialize(payload, values), 0)... };
+			(void)expand;
+
+			std::vector<uint8_t> header(magic(), magic() + 4);
+			serialize(header, version());
+			serialize(header, static_cast<uint64_t>(payload.size()));
+
+			const std::string tmp = _path + ".tmp";
+			{
+				std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+				out.write(reinterpret_cast<const char*>(header.data()), header.size());
+				out.write(reinterpret_cast<const char*>(payload.data()), payload.size());
+				if (! out)
+					throw LinboxError("LinBox ERROR: could not write checkpoint " + tmp + "\n");
+			}
+			if (std::rename(tmp.c_str(), _path.c_str()) != 0)
+				throw LinboxError("LinBox ERROR: could not replace checkpoint " + _path + "\n");
+			_last = Clock::now();
+		}
+
+		/** Reads back values saved by save(), in the same order.
+		 * @returns false, leaving the values untouched, when there is no checkpoint
+		 */
+		template <class... T>
+		bool restore (T&... values)
+		{
+			std::ifstream in(_path, std::ios::binary);
+			if (! in) return false;
+			std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+			uint32_t fileVersion = 0;
+			uint64_t length = 0;
+			if (bytes.size() < 16 || ! std::equal(magic(), magic() + 4, bytes.begin()))
+				throw LinboxError("LinBox ERROR: " + _path + " is not a checkpoint\n");
+			unserialize(fileVersion, bytes, 4);
+			unserialize(length, bytes, 8);
+			if (fileVersion != version() || bytes.size() != 16 + length)
+				throw LinboxError("LinBox ERROR: checkpoint " + _path + " is truncated or of another version\n");
+
+			uint64_t offset = 16;
+			int expand[] = { 0, ((void)(offset += unserialize(values, bytes, offset)), 0)... };
+			(void)expand;
+			if (offset != bytes.size())
+				throw LinboxError("LinBox ERROR: checkpoint " + _path + " does not match the restored objects\n");
+			_last = Clock::now();
+			return true;
+		}
+
+		/// Removes the checkpoint, once the computation is over
+		void clear () const
+		{
+			std::remove(_path.c_str());
+		}
+
+	protected:
+		static const uint8_t* magic () { return reinterpret_cast<const uint8_t*>("LBCK"); }
+		static uint32_t version () { return 1u; }
+
+		std::string        _path;
+		double             _seconds;
+		int                _stride;
+		Clock::time_point  _last;
+	};
+
+} // LinBox
+
+#endif // __LINBOX_util_checkpoint_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
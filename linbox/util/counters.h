@@ -0,0 +1,213 @@
+/* linbox/util/counters.h
+ * Copyright (C) LinBox
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/** @file linbox/util/counters.h
+ * @ingroup util
+ * @brief Per thread event counters of the hot loops (primes, Krylov steps, fill-in, ...).
+ *
+ * The counting sites use LINBOX_COUNT(Name, n), which expands to nothing
+ * unless __LINBOX_COUNTERS is defined before the LinBox headers are
+ * included.  The Counters API itself is always available, and reads zeros
+ * when counting is off.
+ */
+
+#ifndef __LINBOX_util_counters_H
+#define __LINBOX_util_counters_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <vector>
+#include <algorithm>
+
+namespace LinBox
+{
+
+	/// Events counted by the instrumented kernels
+	enum class Counter : size_t {
+		FieldOps,                //!< multiply-adds of the sparse apply kernels
+		SpMVCalls,               //!< sparse matrix-vector products
+		SpMVBytes,               //!< bytes of matrix and vectors those products stream
+		KrylovSteps,             //!< blackbox applications of BlackboxContainer
+		MasseySteps,             //!< sequence elements consumed by MasseyDomain
+		MasseyEarlyTerminations, //!< Massey loops stopped by the early termination threshold
+		CRAPrimes,               //!< residues computed by the CRA loops
+		CRABadPrimes,            //!< residues the CRA loops skipped or discarded
+		CRARestarts,             //!< restarts of the CRA loops
+		GaussRowUpdates,         //!< row eliminations of GaussDomain
+		GaussFillIn,             //!< non-zero entries created by GaussDomain
+		DixonSteps,              //!< p-adic digits computed by DixonLiftingContainer
+		Size
+	};
+
+	/// Values of all the counters, summed over the threads
+	struct CounterSnapshot {
+		static const size_t Size = (size_t)Counter::Size;
+		std::array<uint64_t, Size> values;
+
+		CounterSnapshot() { values.fill(0); }
+
+		uint64_t  operator[] (Counter c) const { return values[(size_t)c]; }
+		uint64_t& operator[] (Counter c) { return values[(size_t)c]; }
+
+		/// Counts between two snapshots
+		CounterSnapshot operator- (const CounterSnapshot& before) const
+		{
+			CounterSnapshot d;
+			for (size_t i = 0; i < Size; ++i) d.values[i] = values[i] - before.values[i];
+			return d;
+		}
+
+		static const char* name (Counter c)
+		{
+			static const char* names[Size] = {
+				"field ops", "spmv calls", "spmv bytes", "krylov steps", "massey steps",
+				"massey early terminations", "cra primes", "cra bad primes", "cra restarts",
+				"gauss row updates", "gauss fill-in", "dixon steps" };
+			return names[(size_t)c];
+		}
+
+		/// One "name, value" line per non zero counter, as in the benchmark csv metadata
+		std::ostream& write (std::ostream& os) const
+		{
+			for (size_t i = 0; i < Size; ++i)
+				if (values[i]) os << name((Counter)i) << ", " << values[i] << std::endl;
+			return os;
+		}
+	};
+
+	/** \brief Registry of the per thread counters.
+	 *
+	 * Each thread increments its own block, without synchronisation;
+	 * snapshot() sums the blocks of the live threads and the counts left
+	 * by the finished ones.  Typical use, around one call:
+	 * \code
+	 * CounterSnapshot before = Counters::snapshot();
+	 * det(d, A);
+	 * (Counters::snapshot() - before).write(std::clog);
+	 * \endcode
+	 * reset() should only be called when no counted computation runs.
+	 */
+	class Counters {
+	public:
+		/// Whether the library was compiled with the counting sites
+		static constexpr bool enabled ()
+		{
+#ifdef __LINBOX_COUNTERS
+			return true;
+#else
+			return false;
+#endif
+		}
+
+		static void add (Counter c, uint64_t n = 1)
+		{
+			std::atomic<uint64_t>& v = local().values[(size_t)c];
+			v.store(v.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+		}
+
+		static CounterSnapshot snapshot ()
+		{
+			Registry& R = registry();
+			std::lock_guard<std::mutex> lock(R.mutex);
+			CounterSnapshot s(R.retired);
+			for (const Block* b : R.live)
+				for (size_t i = 0; i < CounterSnapshot::Size; ++i)
+					s.values[i] += b->values[i].load(std::memory_order_relaxed);
+			return s;
+		}
+
+		static void reset ()
+		{
+			Registry& R = registry();
+			std::lock_guard<std::mutex> lock(R.mutex);
+			R.retired = CounterSnapshot();
+			for (Block* b : R.live)
+				for (auto& v : b->values) v.store(0, std::memory_order_relaxed);
+		}
+
+	protected:
+		struct Block;
+
+		struct Registry {
+			std::mutex          mutex;
+			std::vector<Block*> live;
+			CounterSnapshot     retired;
+		};
+
+		struct Block {
+			std::array<std::atomic<uint64_t>, CounterSnapshot::Size> values;
+
+			Block ()
+			{
+				for (auto& v : values) v.store(0, std::memory_order_relaxed);
+				Registry& R = registry();
+				std::lock_guard<std::mutex> lock(R.mutex);
+				R.live.push_back(this);
+			}
+
+			~Block ()
+			{
+				Registry& R = registry();
+				std::lock_guard<std::mutex> lock(R.mutex);
+				for (size_t i = 0; i < CounterSnapshot::Size; ++i)
+					R.retired.values[i] += values[i].load(std::memory_order_relaxed);
+				R.live.erase(std::find(R.live.begin(), R.live.end(), this));
+			}
+		};
+
+		static Registry& registry ()
+		{
+			static Registry R;
+			return R;
+		}
+
+		static Block& local ()
+		{
+			static thread_local Block b;
+			return b;
+		}
+	};
+
+} // LinBox
+
+#ifdef __LINBOX_COUNTERS
+#define LINBOX_COUNT(name, n) LinBox::Counters::add(LinBox::Counter::name, (n))
+#else
+#define LINBOX_COUNT(name, n) ((void)0)
+#endif
+
+//! One sparse matrix-vector product with nnz products, streaming bytes
+#define LINBOX_COUNT_SPMV(nnz, bytes) \
+	do { LINBOX_COUNT(SpMVCalls, 1); LINBOX_COUNT(FieldOps, (nnz)); LINBOX_COUNT(SpMVBytes, (bytes)); } while (0)
+
+#endif // __LINBOX_util_counters_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
@@ -0,0 +1,109 @@
+/* linbox/util/parallel-policy.h
+ * Copyright (C) LinBox
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/** @file linbox/util/parallel-policy.h
+ * @ingroup util
+ * @brief Thread count and splitting strategy for shared memory dense kernels.
+ */
+
+#ifndef __LINBOX_util_parallel_policy_H
+#define __LINBOX_util_parallel_policy_H
+
+#include <cstddef>
+#include <algorithm>
+
+#include "linbox/linbox-config.h"
+
+#ifdef __LINBOX_USE_OPENMP
+#include <omp.h>
+#endif
+
+namespace LinBox
+{
+
+	/** \brief How many threads a dense kernel may use, and how to split the work.
+	 *
+	 * Carried by MethodBase and by BlasMatrixDomain.  The default policy
+	 * is sequential.  Without OpenMP support (__LINBOX_USE_OPENMP),
+	 * every policy is sequential.
+	 */
+	struct ParallelPolicy {
+		/// Splitting of the FFLAS parallel kernels
+		enum class Split {
+			Recursive, //!< recursive two-dimensional adaptive split
+			Iterative, //!< one block per thread
+		};
+
+		static const size_t DefaultGrain = 256;
+
+		size_t numThreads = 1;         //!< 0 means all the threads of the runtime
+		size_t grain = DefaultGrain;   //!< no parallel run when a dimension is smaller
+		Split split = Split::Recursive;
+		size_t memory = 0;             //!< bytes that concurrent tasks may hold together, 0 for no limit
+
+		ParallelPolicy() = default;
+		ParallelPolicy(size_t threads, Split s = Split::Recursive, size_t g = DefaultGrain) :
+			numThreads(threads), grain(g), split(s)
+		{}
+
+		static ParallelPolicy sequential() { return ParallelPolicy(); }
+		static ParallelPolicy allThreads() { return ParallelPolicy(0); }
+
+		/// Effective number of threads
+		size_t threads() const
+		{
+#ifdef __LINBOX_USE_OPENMP
+			return (numThreads == 0) ? (size_t)omp_get_max_threads() : numThreads;
+#else
+			return 1;
+#endif
+		}
+
+		bool isParallel() const { return threads() > 1; }
+
+		/// Number of independent tasks of taskBytes each to run at the same time
+		size_t concurrentTasks(size_t tasks, size_t taskBytes) const
+		{
+			size_t n = std::min(threads(), tasks);
+			if (memory > 0 && taskBytes > 0)
+				n = std::min(n, memory / taskBytes);
+			return std::max(n, size_t(1));
+		}
+
+		/// Whether an m x n (x k) problem is worth going parallel
+		bool worthIt(size_t m, size_t n, size_t k = size_t(-1)) const
+		{
+			return isParallel() && (std::min(std::min(m,n),k) >= grain);
+		}
+	};
+
+} // LinBox
+
+#endif // __LINBOX_util_parallel_policy_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
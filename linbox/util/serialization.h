@@ -26,6 +26,8 @@
 #include <linbox/matrix/dense-matrix.h>
 #include <linbox/matrix/sparse-matrix.h>
 #include <linbox/vector/blas-vector.h>
+#include <linbox/algorithms/lazy-product.h>
+#include <linbox/randiter/random-prime.h>
 #include <vector>
 
 /**
@@ -151,6 +153,68 @@ namespace LinBox {
      */
     template <class Field>
     uint64_t unserialize(BlasVector<Field>& V, const std::vector<uint8_t>& bytes, uint64_t offset = 0u);
+
+    /**
+     * Serializes a std::vector.
+     *
+     * Format is (by bytes count):
+     *  0-7  l      Length of the vector
+     *  8-..        Entries of the vector
+     */
+    template <class T>
+    uint64_t serialize(std::vector<uint8_t>& bytes, const std::vector<T>& V);
+
+    /**
+     * Unserializes a std::vector.
+     * The vector will be resized if necessary.
+     */
+    template <class T>
+    uint64_t unserialize(std::vector<T>& V, const std::vector<uint8_t>& bytes, uint64_t offset = 0u);
+
+    /**
+     * Serializes a LazyProduct, as the std::vector of its pending factors.
+     */
+    uint64_t serialize(std::vector<uint8_t>& bytes, const LazyProduct& P);
+
+    /**
+     * Unserializes a LazyProduct.
+     */
+    uint64_t unserialize(LazyProduct& P, const std::vector<uint8_t>& bytes, uint64_t offset = 0u);
+
+    /**
+     * Serializes the position of a PrimeIterator.
+     *
+     * Format is (by bytes count):
+     *  0-7  bits   Bit size of the primes
+     *  8-..        Current prime, as an Integer
+     *
+     * Only the deterministic iterators replay the same primes after
+     * unserialization; the random ones restart from their current prime.
+     */
+    template <class Trait>
+    uint64_t serialize(std::vector<uint8_t>& bytes, const PrimeIterator<Trait>& P);
+
+    /**
+     * Unserializes the position of a PrimeIterator.
+     */
+    template <class Trait>
+    uint64_t unserialize(PrimeIterator<Trait>& P, const std::vector<uint8_t>& bytes, uint64_t offset = 0u);
+
+    /**
+     * Serializes any object providing the member functions
+     * uint64_t serialize(std::vector<uint8_t>&) const and
+     * uint64_t unserialize(const std::vector<uint8_t>&, uint64_t),
+     * like the CRA builders or BlackboxBlockContainer.
+     */
+    template <class T>
+    auto serialize(std::vector<uint8_t>& bytes, const T& value) -> decltype(value.serialize(bytes));
+
+    /**
+     * Unserializes an object providing the unserialize member function.
+     */
+    template <class T>
+    auto unserialize(T& value, const std::vector<uint8_t>& bytes, uint64_t offset = 0u)
+        -> decltype(value.unserialize(bytes, offset));
 }
 
 #include "serialization.inl"
@@ -352,4 +352,95 @@ namespace LinBox {
 
         return bytesRead;
     }
+
+    // ----- std::vector
+
+    template <class T>
+    inline uint64_t serialize(std::vector<uint8_t>& bytes, const std::vector<T>& V)
+    {
+        uint64_t l = V.size();
+        auto bytesWritten = serialize(bytes, l);
+
+        for (uint64_t i = 0; i < l; ++i) {
+            bytesWritten += serialize(bytes, V[i]);
+        }
+
+        return bytesWritten;
+    }
+
+    template <class T>
+    inline uint64_t unserialize(std::vector<T>& V, const std::vector<uint8_t>& bytes, uint64_t offset)
+    {
+        uint64_t l;
+        uint64_t bytesRead = 0u;
+        bytesRead += unserialize(l, bytes, offset + bytesRead);
+
+        V.resize(l);
+        for (uint64_t i = 0; i < l; ++i) {
+            bytesRead += unserialize(V[i], bytes, offset + bytesRead);
+        }
+
+        return bytesRead;
+    }
+
+    // ----- LazyProduct
+
+    inline uint64_t serialize(std::vector<uint8_t>& bytes, const LazyProduct& P)
+    {
+        return serialize(bytes, static_cast<const std::vector<Integer>&>(P));
+    }
+
+    inline uint64_t unserialize(LazyProduct& P, const std::vector<uint8_t>& bytes, uint64_t offset)
+    {
+        std::vector<Integer> factors;
+        auto bytesRead = unserialize(factors, bytes, offset);
+
+        P = LazyProduct();
+        if (!factors.empty()) {
+            P.initialize(factors[0]);
+            for (uint64_t i = 1; i < factors.size(); ++i) {
+                P.mulin(factors[i]);
+            }
+        }
+
+        return bytesRead;
+    }
+
+    // ----- PrimeIterator
+
+    template <class Trait>
+    inline uint64_t serialize(std::vector<uint8_t>& bytes, const PrimeIterator<Trait>& P)
+    {
+        uint64_t bits = P.getBits();
+        auto bytesWritten = serialize(bytes, bits);
+        bytesWritten += serialize(bytes, *P);
+        return bytesWritten;
+    }
+
+    template <class Trait>
+    inline uint64_t unserialize(PrimeIterator<Trait>& P, const std::vector<uint8_t>& bytes, uint64_t offset)
+    {
+        uint64_t bits;
+        Integer prime;
+        uint64_t bytesRead = 0u;
+        bytesRead += unserialize(bits, bytes, offset + bytesRead);
+        bytesRead += unserialize(prime, bytes, offset + bytesRead);
+        P.setPrime(prime, bits);
+        return bytesRead;
+    }
+
+    // ----- Objects with serialize/unserialize members
+
+    template <class T>
+    inline auto serialize(std::vector<uint8_t>& bytes, const T& value) -> decltype(value.serialize(bytes))
+    {
+        return value.serialize(bytes);
+    }
+
+    template <class T>
+    inline auto unserialize(T& value, const std::vector<uint8_t>& bytes, uint64_t offset)
+        -> decltype(value.unserialize(bytes, offset))
+    {
+        return value.unserialize(bytes, offset);
+    }
 }
@@ -0,0 +1,239 @@
+/* linbox/util/sparse-row-arena.h
+ * Copyright (C) LinBox
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ *.
+ */
+
+/** @file linbox/util/sparse-row-arena.h
+ * @ingroup util
+ * @brief Arena with size-class free lists for sparse rows during elimination.
+ *
+ * Rows grow and shrink at every pivot of a sparse elimination.
+ * An arena serves those blocks from large chunks and recycles freed
+ * blocks through power-of-two free lists, so that the general purpose
+ * allocator is only hit once per chunk, and the whole memory is given
+ * back at once when the arena dies.
+ */
+
+#ifndef __LINBOX_util_sparse_row_arena_H
+#define __LINBOX_util_sparse_row_arena_H
+
+#include <cstddef>
+#include <new>
+#include <vector>
+#include <memory>
+#include <type_traits>
+
+namespace LinBox
+{
+
+	/** \brief Chunked arena with size-class free lists.
+	 *
+	 * Not thread safe: one arena per elimination (per thread).
+	 * Blocks larger than a quarter of a chunk go to ::operator new.
+	 */
+	class SparseRowArena {
+	public:
+		static const size_t MinClass = 4;   //!< smallest block is 16 bytes
+		static const size_t NbClasses = 28;
+
+		SparseRowArena (size_t chunkSize = (size_t(1)<<20)) :
+			_chunkSize(chunkSize), _current(nullptr), _left(0),
+			_reserved(0), _inUse(0)
+		{
+			for(size_t i=0; i<NbClasses; ++i) _freeLists[i] = nullptr;
+		}
+
+		SparseRowArena (const SparseRowArena&) = delete;
+		SparseRowArena& operator= (const SparseRowArena&) = delete;
+
+		~SparseRowArena () { release(); }
+
+		void* allocate (size_t bytes)
+		{
+			const size_t c = sizeClass(bytes);
+			const size_t blockSize = size_t(1) << c;
+			if (blockSize > (_chunkSize>>2))
+				return ::operator new(bytes);
+			_inUse += blockSize;
+			const size_t i = c - MinClass;
+			if (_freeLists[i] != nullptr) {
+				FreeBlock* b = _freeLists[i];
+				_freeLists[i] = b->next;
+				return b;
+			}
+			if (_left < blockSize) newChunk();
+			void * p = _current;
+			_current += blockSize;
+			_left -= blockSize;
+			return p;
+		}
+
+		void deallocate (void* p, size_t bytes)
+		{
+			if (p == nullptr) return;
+			const size_t c = sizeClass(bytes);
+			const size_t blockSize = size_t(1) << c;
+			if (blockSize > (_chunkSize>>2)) {
+				::operator delete(p);
+				return;
+			}
+			_inUse -= blockSize;
+			FreeBlock* b = static_cast<FreeBlock*>(p);
+			b->next = _freeLists[c - MinClass];
+			_freeLists[c - MinClass] = b;
+		}
+
+		/// Gives back all chunks; every block must have been released.
+		void release ()
+		{
+			for(auto & chunk: _chunks) ::operator delete(chunk);
+			_chunks.clear();
+			for(size_t i=0; i<NbClasses; ++i) _freeLists[i] = nullptr;
+			_current = nullptr;
+			_left = _reserved = _inUse = 0;
+		}
+
+		/// Bytes obtained from the system
+		size_t reserved () const { return _reserved; }
+		/// Bytes of the blocks currently handed out
+		size_t inUse () const { return _inUse; }
+
+		/// Arena picked up by default-constructed ArenaAllocator's of this thread
+		static SparseRowArena*& current ()
+		{
+			static thread_local SparseRowArena* _currentArena = nullptr;
+			return _currentArena;
+		}
+
+		/// Sets the current arena for the lifetime of the scope.
+		struct Scope {
+			SparseRowArena* _previous;
+			Scope (SparseRowArena* arena) : _previous(current()) { if (arena) current() = arena; }
+			~Scope () { current() = _previous; }
+		};
+
+	private:
+		struct FreeBlock { FreeBlock* next; };
+
+		static size_t sizeClass (size_t bytes)
+		{
+			size_t c = MinClass;
+			while ( (size_t(1) << c) < bytes) ++c;
+			return c;
+		}
+
+		void newChunk ()
+		{
+			// The remainder of the current chunk is lost to fragmentation
+			_current = static_cast<char*>(::operator new(_chunkSize));
+			_chunks.push_back(_current);
+			_left = _chunkSize;
+			_reserved += _chunkSize;
+		}
+
+		size_t              _chunkSize;
+		char*               _current;
+		size_t              _left;
+		size_t              _reserved;
+		size_t              _inUse;
+		std::vector<char*>  _chunks;
+		FreeBlock*          _freeLists[NbClasses];
+	};
+
+	/** \brief Standard allocator drawing from a SparseRowArena.
+	 *
+	 * A default-constructed allocator binds to SparseRowArena::current(),
+	 * or to the heap when there is none.
+	 * Containers keep their allocator on copy assignment, so that copying
+	 * a temporary row into a matrix row lands in the matrix arena, and
+	 * copy construction shares the arena of the source container.
+	 */
+	template<class T>
+	class ArenaAllocator {
+	public:
+		typedef T value_type;
+		typedef std::false_type propagate_on_container_copy_assignment;
+		typedef std::true_type  propagate_on_container_move_assignment;
+		typedef std::true_type  propagate_on_container_swap;
+
+		template<class U> struct rebind { typedef ArenaAllocator<U> other; };
+
+		ArenaAllocator () noexcept : _arena(SparseRowArena::current()) {}
+		ArenaAllocator (SparseRowArena* arena) noexcept : _arena(arena) {}
+		template<class U>
+		ArenaAllocator (const ArenaAllocator<U>& other) noexcept : _arena(other.arena()) {}
+
+		T* allocate (size_t n)
+		{
+			if (_arena) return static_cast<T*>(_arena->allocate(n*sizeof(T)));
+			return static_cast<T*>(::operator new(n*sizeof(T)));
+		}
+
+		void deallocate (T* p, size_t n)
+		{
+			if (_arena) _arena->deallocate(p, n*sizeof(T));
+			else ::operator delete(p);
+		}
+
+		/** Copies of a container live in the arena of the original.
+		 * So a copy must not outlive the owner of that arena: copies of an
+		 * arena-backed matrix rebind their rows to their own arena.
+		 */
+		ArenaAllocator select_on_container_copy_construction () const
+		{
+			return *this;
+		}
+
+		SparseRowArena* arena () const { return _arena; }
+
+	private:
+		SparseRowArena* _arena;
+	};
+
+	template<class T, class U>
+	bool operator== (const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)
+	{
+		return a.arena() == b.arena();
+	}
+
+	template<class T, class U>
+	bool operator!= (const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)
+	{
+		return a.arena() != b.arena();
+	}
+
+	/** Arena to be made current during the elimination of A.
+	 * nullptr by default: only arena-backed matrices overload it.
+	 */
+	template<class _Matrix>
+	SparseRowArena* eliminationArena (const _Matrix&) { return nullptr; }
+
+} // LinBox
+
+#endif // __LINBOX_util_sparse_row_arena_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
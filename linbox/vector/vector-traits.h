@@ -57,6 +57,7 @@
 #include "linbox/field/archetype.h"
 #include "linbox/field/rebind.h"
 #include "linbox/matrix/sparse-formats.h"
+#include "linbox/util/sparse-row-arena.h"
 
 namespace LinBox
 {
@@ -195,6 +196,16 @@ namespace LinBox
 		static void sort (VectorType& v) { std::stable_sort(v.begin(), v.end(), SparseSequenceVectorPairLessThan<Element>()); }
 	};
 
+	// Specialization for STL vectors of pairs of size_t and elements, in an arena
+	template <class Element>
+	struct VectorTraits< std::vector< std::pair<size_t, Element>, ArenaAllocator<std::pair<size_t, Element> > > > {
+		typedef typename VectorCategories::SparseSequenceVectorTag VectorCategory;
+		typedef std::vector< std::pair<size_t, Element>, ArenaAllocator<std::pair<size_t, Element> > > VectorType;
+		typedef SparseMatrixFormat::SparseSeqArena          SparseFormat;
+
+		static void sort (VectorType& v) { std::stable_sort(v.begin(), v.end(), SparseSequenceVectorPairLessThan<Element>()); }
+	};
+
 	// Specialization for STL lists of pairs of size_t and elements
 	template <class Element>
 	struct VectorTraits< std::list< std::pair<size_t, Element> > > {
@@ -442,6 +453,7 @@ namespace LinBox
 		typedef std::vector<Element> Dense;
 		typedef std::vector<std::pair<size_t, Element> > SparseSeq;
 		typedef std::list<std::pair<size_t, Element> >   SparseSeq2;
+		typedef std::vector<std::pair<size_t, Element>, ArenaAllocator<std::pair<size_t, Element> > > SparseSeqArena;
 		typedef std::map<size_t, Element>                SparseMap;
 		typedef std::pair<std::vector<size_t>, Dense >   SparsePar;
 		typedef SparsePar Sparse;
@@ -534,6 +546,11 @@ namespace LinBox
 		typedef typename Vector<U>::SparseSeq other;
 	};
 
+	template<class T, class U>
+	struct Rebind< std::vector<std::pair<size_t, T>, ArenaAllocator<std::pair<size_t, T> > >, U > {
+		typedef typename Vector<U>::SparseSeqArena other;
+	};
+
 	template<class T, class U>
 	struct Rebind< std::map<size_t, T>, U > {
 		typedef typename Vector<U>::SparseMap other;
@@ -38,6 +38,8 @@
 
 #include <iostream>
 #include <fstream>
+#include <cstdlib>
+#include <ctime>
 // #include <vector>
 
 #include "linbox/linbox-config.h"
@@ -381,6 +383,25 @@ extern inline double incompleteGamma (double a, double x, double tol);
 
 double chiSquaredCDF (double chi_sqr, double df);
 
+/* Reports what failed as an error, returns ok:
+ *   pass = reportCheck(cond, "what went wrong") && pass;
+ */
+inline bool reportCheck (bool ok, const char* what)
+{
+	if (! ok)
+		LinBox::commentator().report (LinBox::Commentator::LEVEL_IMPORTANT, INTERNAL_ERROR)
+			<< "ERROR: " << what << std::endl;
+	return ok;
+}
+
+/* Seeds rand() and drand48() with seed, taken from the clock when negative */
+inline void seedTests (int& seed)
+{
+	if (seed < 0) seed = (int)time(NULL);
+	srand((unsigned)seed);
+	srand48(seed);
+}
+
 #ifdef LinBoxTestOnly
 #include "test-common.inl"
 #endif
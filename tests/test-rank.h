@@ -33,6 +33,8 @@ bool testRankMethods(const typename BlackBox::Field & F, size_t n, size_t m, uns
 //bool testRankMethodsGF2(const GF2& F2, size_t n, unsigned int iterations, double sparsity = 0.05)
  * @test
 bool testZeroAndIdentRank (const Field &F, size_t n, unsigned int iterations = 1)
+ * @test
+bool testArenaEliminationRank(const Field &F, size_t n, size_t m, unsigned int iterations, double sparsity = 0.05)
  */
 
 
@@ -156,6 +158,49 @@ bool testRankMethods(const typename BlackBox::Field & F, size_t n, size_t m, uns
 	return ret;
 }
 
+/* Test 4: Sparse elimination rank with arena-backed rows
+ *
+ * Same random sparse matrix, as SparseSeq and as SparseSeqArena:
+ * checks that GaussDomain gives the same rank on both.
+ */
+template <class Field>
+bool testArenaEliminationRank(const Field &F, size_t n, size_t m, unsigned int iterations, double sparsity = 0.05)
+{
+	commentator().start ("Testing sparse elimination rank with arena rows", "testArenaEliminationRank", (unsigned int)iterations);
+
+	bool ret = true;
+	typename Field::RandIter ri (F);
+	GaussDomain<Field> GD(F);
+
+	for (unsigned int i = 0; i < iterations; ++i) {
+		commentator().startIteration (i);
+
+		RandomSparseStream<Field, typename Vector<Field>::SparseSeq> stream (F, ri, sparsity, n, m);
+		SparseMatrix<Field, SparseMatrixFormat::SparseSeq> A (F, stream);
+		SparseMatrix<Field, SparseMatrixFormat::SparseSeqArena> B (A);
+
+		size_t rank_seq, rank_arena;
+		GD.rankInPlace (rank_seq, A);
+		GD.rankInPlace (rank_arena, B);
+
+		commentator().report ()
+			<< "SparseSeq rank " << rank_seq << ", arena rank " << rank_arena
+			<< " (" << B.arena()->reserved() << " bytes reserved)" << endl;
+
+		if (rank_seq != rank_arena) {
+			commentator().report () << "ERROR: Ranks are not equal" << endl;
+			ret = false;
+		}
+
+		commentator().stop ("done");
+		commentator().progress ();
+	}
+
+	commentator().stop (MSG_STATUS (ret), (const char *) 0, "testArenaEliminationRank");
+
+	return ret;
+}
+
 // this test just doesn't work/compile
 #if 0
 bool testRankMethodsGF2(const GF2& F2, size_t n, unsigned int iterations, double sparsity = 0.05)